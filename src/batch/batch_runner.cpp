@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+#include "batch/batch_runner.hpp"
+#include "batch/json.hpp"
+#include "batch/thread_pool.hpp"
+#include "core/input_movie.hpp"
+#include "core/interpreter.hpp"
+#include "core/rom_pack.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int FRAMES_PER_SECOND = 60;
+
+std::string getFaultName(const FaultKind kind) {
+    switch (kind) {
+        case FaultKind::NONE: 
+            return "NONE";
+        case FaultKind::ILLEGAL_OPCODE: 
+            return "ILLEGAL_OPCODE";
+        case FaultKind::STACK_UNDERFLOW: 
+            return "STACK_UNDERFLOW";
+        case FaultKind::STACK_OVERFLOW: 
+            return "STACK_OVERFLOW";
+        case FaultKind::MEMORY_OUT_OF_BOUNDS: 
+            return "MEMORY_OUT_OF_BOUNDS";
+        case FaultKind::PC_OUT_OF_BOUNDS: 
+            return "PC_OUT_OF_BOUNDS";
+    }
+    return "UNKNOWN";
+}
+
+const JsonValue& getField(const JsonValue& entry, const std::string& key, 
+    const JsonValue::Type type) {
+    const JsonValue* value = entry.find(key);
+    if (value == nullptr || value->type != type) {
+        throw std::runtime_error("ROM list entry has a missing or invalid \"" + 
+            key + "\" field");
+    }
+    return *value;
+}
+
+// Reads the speed field, which must be a positive number of instructions per 
+// second that fits in an int
+int getSpeed(const JsonValue& entry) {
+    const double speed = getField(entry, "speed", 
+        JsonValue::Type::NUMBER).number;
+    if (!std::isfinite(speed) || speed < 1.0 || 
+        speed > std::numeric_limits<int>::max()) {
+        throw std::runtime_error(
+            "ROM list entry has an out of range \"speed\" field");
+    }
+    return static_cast<int>(speed);
+}
+
+bool readFile(const std::filesystem::path& path, 
+    std::vector<uint8_t>& contents) {
+    std::ifstream file{path, std::ios_base::binary};
+    if (!file) {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>{file}, 
+        std::istreambuf_iterator<char>{});
+    return !file.bad();
+}
+
+void writeFault(std::ostream& stream, const Fault& fault) {
+    if (fault.kind == FaultKind::NONE) {
+        stream << "    \"fault\": null,\n";
+        return;
+    }
+    stream << "    \"fault\": {\n"
+        << "      \"kind\": " << quoteJson(getFaultName(fault.kind)) << ",\n"
+        << "      \"pc\": " << fault.pc << ",\n"
+        << "      \"opcode\": " << fault.opcode << ",\n"
+        << "      \"message\": " << quoteJson(describeFault(fault)) << "\n"
+        << "    },\n";
+}
+
+}
+
+/**
+ * Reads a ROM list in the format of web/roms.json. ROM filenames are resolved 
+ * against the given directory. Throws std::runtime_error if the list cannot 
+ * be read or an entry has a missing or invalid field.
+ */
+std::vector<RomProfile> OCTACHIP::loadRomProfiles(
+    const std::filesystem::path& listPath, 
+    const std::filesystem::path& romDirectory) {
+    std::ifstream file{listPath};
+    if (!file) {
+        throw std::runtime_error("Failed to open ROM list: " + 
+            listPath.string());
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    const JsonValue document = parseJson(contents.str());
+    if (document.type != JsonValue::Type::ARRAY) {
+        throw std::runtime_error("ROM list must be a JSON array");
+    }
+
+    std::vector<RomProfile> profiles;
+    for (const JsonValue& entry : document.array) {
+        if (entry.type != JsonValue::Type::OBJECT) {
+            throw std::runtime_error("ROM list entries must be JSON objects");
+        }
+
+        RomProfile profile;
+        profile.path = romDirectory / getField(entry, "filename", 
+            JsonValue::Type::STRING).string;
+        const JsonValue* title = entry.find("title");
+        profile.title = title != nullptr && 
+            title->type == JsonValue::Type::STRING ? 
+            title->string : profile.path.filename().string();
+        profile.speed = getSpeed(entry);
+        profile.loadStoreQuirk = getField(entry, "loadStoreQuirk", 
+            JsonValue::Type::BOOLEAN).boolean;
+        profile.shiftQuirk = getField(entry, "shiftQuirk", 
+            JsonValue::Type::BOOLEAN).boolean;
+        profile.wrapQuirk = getField(entry, "wrapQuirk", 
+            JsonValue::Type::BOOLEAN).boolean;
+        profiles.push_back(std::move(profile));
+    }
+    return profiles;
+}
+
+/**
+ * Lists the ROMs in a mapped ROM pack, pointing each profile at its image 
+ * inside the pack. Throws std::runtime_error if the pack is invalid.
+ */
+std::vector<RomProfile> OCTACHIP::loadPackProfiles(const MappedFile& pack) {
+    RomPack index{};
+    const std::optional<std::string> error = 
+        decodeRomPack(pack.getData(), pack.getSize(), index);
+    if (error) {
+        throw std::runtime_error(*error);
+    }
+
+    std::vector<RomProfile> profiles;
+    for (const PackedRom& rom : index.roms) {
+        RomProfile profile;
+        profile.title = rom.title;
+        profile.path = rom.filename;
+        profile.data = pack.getData() + rom.offset;
+        profile.size = rom.size;
+        profile.hash = rom.hash;
+        profile.speed = rom.speed;
+        profile.loadStoreQuirk = rom.loadStoreQuirk;
+        profile.shiftQuirk = rom.shiftQuirk;
+        profile.wrapQuirk = rom.wrapQuirk;
+        profiles.push_back(std::move(profile));
+    }
+    return profiles;
+}
+
+/**
+ * Writes ROMs and their settings to a single ROM pack, stored under their 
+ * filenames. Throws std::runtime_error if a ROM cannot be read or 
+ * the pack cannot be written.
+ */
+void OCTACHIP::writeRomPack(const std::vector<RomProfile>& profiles, 
+    const std::filesystem::path& packPath) {
+    std::vector<PackedRom> roms;
+    std::vector<std::vector<uint8_t>> images(profiles.size());
+    for (size_t index = 0; index < profiles.size(); index++) {
+        const RomProfile& profile = profiles[index];
+        if (profile.data != nullptr) {
+            images[index].assign(profile.data, profile.data + profile.size);
+        } else if (!readFile(profile.path, images[index])) {
+            throw std::runtime_error("Failed to open ROM: " + 
+                profile.path.string());
+        }
+
+        PackedRom rom{};
+        rom.title = profile.title;
+        rom.filename = profile.path.filename().string();
+        rom.speed = profile.speed;
+        rom.loadStoreQuirk = profile.loadStoreQuirk;
+        rom.shiftQuirk = profile.shiftQuirk;
+        rom.wrapQuirk = profile.wrapQuirk;
+        roms.push_back(std::move(rom));
+    }
+
+    const std::vector<uint8_t> bytes = encodeRomPack(roms, images);
+    std::ofstream file{packPath, std::ios_base::binary};
+    file.write(reinterpret_cast<const char*>(bytes.data()), 
+        static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("Failed to write ROM pack: " + 
+            packPath.string());
+    }
+}
+
+/**
+ * Runs a ROM headless for the configured number of 60 Hz frames, stopping 
+ * early if it faults or uses up its instruction budget.
+ */
+RunResult OCTACHIP::runRom(const RomProfile& profile, 
+    const BatchLimits& limits) {
+    const Clock::time_point startTime = Clock::now();
+
+    RunResult result{};
+    result.title = profile.title;
+    result.path = profile.path.string();
+
+    Interpreter interpreter{};
+    interpreter.setLoadStoreQuirk(profile.loadStoreQuirk);
+    interpreter.setShiftQuirk(profile.shiftQuirk);
+    interpreter.setWrapQuirk(profile.wrapQuirk);
+    interpreter.seedRandom(limits.seed);
+
+    const std::optional<std::string> error = profile.data != nullptr ? 
+        interpreter.loadRom(profile.data, profile.size) : 
+        interpreter.loadRom(profile.path);
+    if (error) {
+        result.error = *error;
+    } else {
+        const int instructionsPerFrame = 
+            std::max(1, profile.speed / FRAMES_PER_SECOND);
+
+        for (int frame = 0; frame < limits.frameCount; frame++) {
+            int instructionCount = instructionsPerFrame;
+            if (limits.instructionBudget > 0) {
+                const uint64_t executed = 
+                    interpreter.getExecutedInstructionCount();
+                if (executed >= limits.instructionBudget) {
+                    result.budgetExceeded = true;
+                    break;
+                }
+                instructionCount = static_cast<int>(std::min<uint64_t>(
+                    instructionCount, limits.instructionBudget - executed));
+            }
+
+            const Fault& fault = interpreter.run(instructionCount);
+            if (fault.kind != FaultKind::NONE) {
+                result.fault = fault;
+                break;
+            }
+            interpreter.updateTimers();
+            result.framesRun++;
+        }
+    }
+
+    result.executedInstructionCount = 
+        interpreter.getExecutedInstructionCount();
+    result.skippedInstructionCount = interpreter.getSkippedInstructionCount();
+    result.frameHash = hashFrame(interpreter.getFrame());
+    result.waitingForKey = interpreter.isWaitingForKey();
+    result.wallTimeSeconds = 
+        std::chrono::duration<double>(Clock::now() - startTime).count();
+    return result;
+}
+
+/**
+ * Runs every ROM on a pool of worker threads. Results are returned in the 
+ * order of the profiles, regardless of which ROMs finish first.
+ */
+std::vector<RunResult> OCTACHIP::runBatch(
+    const std::vector<RomProfile>& profiles, const BatchLimits& limits, 
+    const int threadCount) {
+    std::vector<RunResult> results(profiles.size());
+
+    ThreadPool pool{threadCount};
+    for (size_t index = 0; index < profiles.size(); index++) {
+        pool.submit([&profiles, &limits, &results, index] {
+            results[index] = runRom(profiles[index], limits);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+/**
+ * Replays an input movie headless against the ROM it was recorded with, 
+ * which is looked up in the ROM list by the hash of its contents. The quirks 
+ * and speed stored in the movie are used instead of those in the list.
+ */
+MovieResult OCTACHIP::replayMovie(const std::filesystem::path& moviePath, 
+    const std::vector<RomProfile>& profiles) {
+    MovieResult result{};
+    result.path = moviePath.string();
+
+    std::vector<uint8_t> contents;
+    if (!readFile(moviePath, contents)) {
+        result.error = "Failed to open input movie: " + result.path;
+        return result;
+    }
+    InputMovie movie{};
+    const std::optional<std::string> movieError = 
+        decodeMovie(contents.data(), contents.size(), movie);
+    if (movieError) {
+        result.error = *movieError + ": " + result.path;
+        return result;
+    }
+
+    // ROMs in a pack are matched by the hash in its index, without reading 
+    // their images
+    std::vector<uint8_t> rom;
+    const uint8_t* romData = nullptr;
+    size_t romSize = 0;
+    const RomProfile* match = nullptr;
+    for (const RomProfile& profile : profiles) {
+        if (profile.data != nullptr) {
+            if (profile.hash == movie.romHash) {
+                romData = profile.data;
+                romSize = profile.size;
+                match = &profile;
+                break;
+            }
+        } else if (readFile(profile.path, rom) && 
+            hashBytes(rom.data(), rom.size()) == movie.romHash) {
+            romData = rom.data();
+            romSize = rom.size();
+            match = &profile;
+            break;
+        }
+    }
+    if (match == nullptr) {
+        result.error = "No ROM in the list matches input movie: " + 
+            result.path;
+        return result;
+    }
+    result.title = match->title;
+
+    const Clock::time_point startTime = Clock::now();
+    Interpreter interpreter{};
+    MoviePlayer player{interpreter, movie};
+    const std::optional<std::string> error = 
+        player.start(romData, romSize);
+    if (error) {
+        result.error = *error;
+    } else {
+        while (!player.isFinished()) {
+            player.runFrame();
+        }
+        result.matchesRecording = player.matchesRecording();
+    }
+
+    result.framesRun = player.getFrame();
+    result.executedInstructionCount = 
+        interpreter.getExecutedInstructionCount();
+    result.fault = interpreter.getFault();
+    result.wallTimeSeconds = 
+        std::chrono::duration<double>(Clock::now() - startTime).count();
+    return result;
+}
+
+// Replays every movie on a pool of worker threads, keeping their order
+std::vector<MovieResult> OCTACHIP::replayMovies(
+    const std::vector<std::filesystem::path>& moviePaths, 
+    const std::vector<RomProfile>& profiles, const int threadCount) {
+    std::vector<MovieResult> results(moviePaths.size());
+
+    ThreadPool pool{threadCount};
+    for (size_t index = 0; index < moviePaths.size(); index++) {
+        pool.submit([&moviePaths, &profiles, &results, index] {
+            results[index] = replayMovie(moviePaths[index], profiles);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+// 64-bit FNV-1a hash of the frame rows, leftmost pixels first
+uint64_t OCTACHIP::hashFrame(const Frame& frame) {
+    constexpr uint64_t OFFSET_BASIS = 0xCBF29CE484222325;
+    constexpr uint64_t PRIME = 0x100000001B3;
+
+    uint64_t hash = OFFSET_BASIS;
+    for (const FrameRow row : frame) {
+        for (int shift = FRAME_WIDTH - 8; shift >= 0; shift -= 8) {
+            hash ^= (row >> shift) & 0xFF;
+            hash *= PRIME;
+        }
+    }
+    return hash;
+}
+
+void OCTACHIP::writeResults(std::ostream& stream, 
+    const std::vector<RunResult>& results) {
+    std::stringstream hash;
+    hash << std::hex << std::setfill('0');
+
+    stream << "[\n";
+    for (size_t index = 0; index < results.size(); index++) {
+        const RunResult& result = results[index];
+        hash.str("");
+        hash << std::setw(16) << result.frameHash;
+
+        stream << "  {\n"
+            << "    \"title\": " << quoteJson(result.title) << ",\n"
+            << "    \"path\": " << quoteJson(result.path) << ",\n"
+            << "    \"framesRun\": " << result.framesRun << ",\n"
+            << "    \"executedInstructions\": " 
+            << result.executedInstructionCount << ",\n"
+            << "    \"skippedInstructions\": " 
+            << result.skippedInstructionCount << ",\n"
+            << "    \"frameHash\": \"" << hash.str() << "\",\n";
+
+        writeFault(stream, result.fault);
+        stream << "    \"budgetExceeded\": " 
+            << (result.budgetExceeded ? "true" : "false") << ",\n"
+            << "    \"waitingForKey\": " 
+            << (result.waitingForKey ? "true" : "false") << ",\n"
+            << "    \"error\": " 
+            << (result.error.empty() ? "null" : quoteJson(result.error)) 
+            << ",\n"
+            << "    \"wallTimeSeconds\": " << result.wallTimeSeconds << "\n"
+            << "  }" << (index + 1 < results.size() ? "," : "") << "\n";
+    }
+    stream << "]\n";
+}
+
+void OCTACHIP::writeMovieResults(std::ostream& stream, 
+    const std::vector<MovieResult>& results) {
+    stream << "[\n";
+    for (size_t index = 0; index < results.size(); index++) {
+        const MovieResult& result = results[index];
+
+        stream << "  {\n"
+            << "    \"title\": " << quoteJson(result.title) << ",\n"
+            << "    \"path\": " << quoteJson(result.path) << ",\n"
+            << "    \"framesRun\": " << result.framesRun << ",\n"
+            << "    \"executedInstructions\": " 
+            << result.executedInstructionCount << ",\n";
+        writeFault(stream, result.fault);
+        stream << "    \"matchesRecording\": " 
+            << (result.matchesRecording ? "true" : "false") << ",\n"
+            << "    \"error\": " 
+            << (result.error.empty() ? "null" : quoteJson(result.error)) 
+            << ",\n"
+            << "    \"wallTimeSeconds\": " << result.wallTimeSeconds << "\n"
+            << "  }" << (index + 1 < results.size() ? "," : "") << "\n";
+    }
+    stream << "]\n";
+}
\ No newline at end of file
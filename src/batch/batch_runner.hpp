@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "batch/mapped_file.hpp"
+#include "core/fault.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+// A ROM and the speed and quirk settings it runs with, as listed in roms.json
+struct RomProfile {
+    std::string title;
+    std::filesystem::path path;
+    // Image of the ROM inside a mapped ROM pack, which is used instead of 
+    // reading the file at path when set. The pack has to outlive the profile.
+    const uint8_t* data{};
+    size_t size{};
+    uint64_t hash{};
+    int speed{};
+    bool loadStoreQuirk{};
+    bool shiftQuirk{};
+    bool wrapQuirk{};
+};
+
+struct BatchLimits {
+    int frameCount{};
+    // Instructions each ROM may execute before it is stopped, or 0 for no 
+    // limit. Keeps a runaway ROM from holding a worker for too long.
+    uint64_t instructionBudget{};
+    // Seed for the random numbers drawn by every ROM, so that repeated 
+    // batches produce the same results
+    uint64_t seed{};
+};
+
+struct RunResult {
+    std::string title;
+    std::string path;
+    int framesRun{};
+    uint64_t executedInstructionCount{};
+    uint64_t skippedInstructionCount{};
+    uint64_t frameHash{};
+    Fault fault{};
+    bool budgetExceeded{};
+    bool waitingForKey{};
+    std::string error;
+    double wallTimeSeconds{};
+};
+
+struct MovieResult {
+    std::string path;
+    // Title of the ROM in the list whose contents match the movie
+    std::string title;
+    uint64_t framesRun{};
+    uint64_t executedInstructionCount{};
+    Fault fault{};
+    // Whether the replay ended in the state the movie was recorded in
+    bool matchesRecording{};
+    std::string error;
+    double wallTimeSeconds{};
+};
+
+std::vector<RomProfile> loadRomProfiles(const std::filesystem::path& listPath, 
+    const std::filesystem::path& romDirectory);
+std::vector<RomProfile> loadPackProfiles(const MappedFile& pack);
+void writeRomPack(const std::vector<RomProfile>& profiles, 
+    const std::filesystem::path& packPath);
+RunResult runRom(const RomProfile& profile, const BatchLimits& limits);
+std::vector<RunResult> runBatch(const std::vector<RomProfile>& profiles, 
+    const BatchLimits& limits, const int threadCount);
+MovieResult replayMovie(const std::filesystem::path& moviePath, 
+    const std::vector<RomProfile>& profiles);
+std::vector<MovieResult> replayMovies(
+    const std::vector<std::filesystem::path>& moviePaths, 
+    const std::vector<RomProfile>& profiles, const int threadCount);
+uint64_t hashFrame(const Frame& frame);
+void writeResults(std::ostream& stream, 
+    const std::vector<RunResult>& results);
+void writeMovieResults(std::ostream& stream, 
+    const std::vector<MovieResult>& results);
+
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "batch/json.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& source) : 
+        text{source}, 
+        position{0} {}
+
+    JsonValue parseDocument() {
+        JsonValue value = parseValue();
+        skipWhitespace();
+        if (position != text.size()) {
+            fail("Unexpected trailing characters");
+        }
+        return value;
+    }
+private:
+    const std::string& text;
+    size_t position;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Invalid JSON at offset " + 
+            std::to_string(position) + ": " + message);
+    }
+
+    void skipWhitespace() {
+        while (position < text.size() && 
+            std::isspace(static_cast<unsigned char>(text[position]))) {
+            position++;
+        }
+    }
+
+    bool consume(const char expected) {
+        skipWhitespace();
+        if (position < text.size() && text[position] == expected) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char expected) {
+        if (!consume(expected)) {
+            fail(std::string("Expected '") + expected + "'");
+        }
+    }
+
+    bool consumeLiteral(const std::string& literal) {
+        if (text.compare(position, literal.size(), literal) == 0) {
+            position += literal.size();
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parseValue() {
+        skipWhitespace();
+        if (position >= text.size()) {
+            fail("Unexpected end of input");
+        }
+
+        JsonValue value;
+        const char next = text[position];
+        if (next == '{') {
+            value.type = JsonValue::Type::OBJECT;
+            parseObject(value);
+        } else if (next == '[') {
+            value.type = JsonValue::Type::ARRAY;
+            parseArray(value);
+        } else if (next == '"') {
+            value.type = JsonValue::Type::STRING;
+            value.string = parseString();
+        } else if (consumeLiteral("true")) {
+            value.type = JsonValue::Type::BOOLEAN;
+            value.boolean = true;
+        } else if (consumeLiteral("false")) {
+            value.type = JsonValue::Type::BOOLEAN;
+        } else if (consumeLiteral("null")) {
+            value.type = JsonValue::Type::NUL;
+        } else {
+            value.type = JsonValue::Type::NUMBER;
+            value.number = parseNumber();
+        }
+        return value;
+    }
+
+    void parseObject(JsonValue& value) {
+        expect('{');
+        if (consume('}')) {
+            return;
+        }
+        do {
+            skipWhitespace();
+            if (position >= text.size() || text[position] != '"') {
+                fail("Expected a string key");
+            }
+            std::string key = parseString();
+            expect(':');
+            value.object.emplace_back(std::move(key), parseValue());
+        } while (consume(','));
+        expect('}');
+    }
+
+    void parseArray(JsonValue& value) {
+        expect('[');
+        if (consume(']')) {
+            return;
+        }
+        do {
+            value.array.push_back(parseValue());
+        } while (consume(','));
+        expect(']');
+    }
+
+    std::string parseString() {
+        std::string result;
+        position++;
+
+        while (position < text.size() && text[position] != '"') {
+            const char character = text[position++];
+            if (character != '\\') {
+                result += character;
+                continue;
+            }
+            if (position >= text.size()) {
+                break;
+            }
+            const char escape = text[position++];
+            switch (escape) {
+                case 'b': 
+                    result += '\b';
+                    break;
+                case 'f': 
+                    result += '\f';
+                    break;
+                case 'n': 
+                    result += '\n';
+                    break;
+                case 'r': 
+                    result += '\r';
+                    break;
+                case 't': 
+                    result += '\t';
+                    break;
+                case 'u': 
+                    appendCodePoint(result, parseHex4());
+                    break;
+                default: 
+                    result += escape;
+                    break;
+            }
+        }
+
+        if (position >= text.size()) {
+            fail("Unterminated string");
+        }
+        position++;
+        return result;
+    }
+
+    unsigned int parseHex4() {
+        if (position + 4 > text.size()) {
+            fail("Truncated unicode escape");
+        }
+        const std::string digits = text.substr(position, 4);
+        char* end = nullptr;
+        const unsigned long codePoint = std::strtoul(digits.c_str(), &end, 16);
+        if (end != digits.c_str() + 4) {
+            fail("Invalid unicode escape");
+        }
+        position += 4;
+        return static_cast<unsigned int>(codePoint);
+    }
+
+    // Encodes a code point from a \u escape as UTF-8. Surrogate pairs are not 
+    // combined, which is enough for the ROM metadata this parser reads.
+    static void appendCodePoint(std::string& result, 
+        const unsigned int codePoint) {
+        if (codePoint < 0x80) {
+            result += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            result += static_cast<char>(0xC0 | (codePoint >> 6));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            result += static_cast<char>(0xE0 | (codePoint >> 12));
+            result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    double parseNumber() {
+        const char* start = text.c_str() + position;
+        char* end = nullptr;
+        const double number = std::strtod(start, &end);
+        if (end == start) {
+            fail("Unexpected character");
+        }
+        position += end - start;
+        return number;
+    }
+};
+
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (const auto& [name, value] : object) {
+        if (name == key) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Parses a complete JSON document. Throws std::runtime_error describing where 
+ * parsing failed if the text is not valid JSON.
+ */
+JsonValue OCTACHIP::parseJson(const std::string& text) {
+    return JsonParser{text}.parseDocument();
+}
+
+// Returns the text as a quoted JSON string literal.
+std::string OCTACHIP::quoteJson(const std::string& text) {
+    std::string result = "\"";
+    for (const char character : text) {
+        switch (character) {
+            case '"': 
+                result += "\\\"";
+                break;
+            case '\\': 
+                result += "\\\\";
+                break;
+            case '\b': 
+                result += "\\b";
+                break;
+            case '\f': 
+                result += "\\f";
+                break;
+            case '\n': 
+                result += "\\n";
+                break;
+            case '\r': 
+                result += "\\r";
+                break;
+            case '\t': 
+                result += "\\t";
+                break;
+            default: 
+                if (static_cast<unsigned char>(character) < 0x20) {
+                    char escape[7];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", 
+                        static_cast<unsigned int>(character));
+                    result += escape;
+                } else {
+                    result += character;
+                }
+                break;
+        }
+    }
+    result += '"';
+    return result;
+}
\ No newline at end of file
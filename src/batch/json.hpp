@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OCTACHIP {
+
+/**
+ * Minimal JSON document model, covering what the batch runner needs to read 
+ * ROM lists in the format of web/roms.json.
+ */
+struct JsonValue {
+    enum class Type {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    Type type{Type::NUL};
+    bool boolean{};
+    double number{};
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* find(const std::string& key) const;
+};
+
+JsonValue parseJson(const std::string& text);
+std::string quoteJson(const std::string& text);
+
+}
\ No newline at end of file
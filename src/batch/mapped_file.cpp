@@ -0,0 +1,128 @@
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "batch/mapped_file.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#define OCTACHIP_MAPPED_FILE_WIN32
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OCTACHIP_MAPPED_FILE_POSIX
+#endif
+
+using namespace OCTACHIP;
+
+namespace {
+
+// Maps the whole file, returning nullptr if it is empty or cannot be mapped
+const uint8_t* mapFile(const std::filesystem::path& path, size_t& size) {
+#if defined(OCTACHIP_MAPPED_FILE_WIN32)
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, 
+        FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize{};
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        const HANDLE mapping = CreateFileMappingW(file, nullptr, 
+            PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            // The view keeps the mapping alive after its handle is closed
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    size = view != nullptr ? static_cast<size_t>(fileSize.QuadPart) : 0;
+    return static_cast<const uint8_t*>(view);
+#elif defined(OCTACHIP_MAPPED_FILE_POSIX)
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return nullptr;
+    }
+    struct stat status{};
+    void* view = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, 
+            MAP_PRIVATE, file, 0);
+    }
+    // The mapping stays valid after the file is closed
+    close(file);
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(status.st_size);
+    return static_cast<const uint8_t*>(view);
+#else
+    (void)path;
+    (void)size;
+    return nullptr;
+#endif
+}
+
+void unmapFile(const uint8_t* data, const size_t size) {
+#if defined(OCTACHIP_MAPPED_FILE_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#elif defined(OCTACHIP_MAPPED_FILE_POSIX)
+    munmap(const_cast<uint8_t*>(data), size);
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
+}
+
+/**
+ * Maps the file at the given path. Falls back to reading it into memory if 
+ * it cannot be mapped, and throws std::runtime_error if it cannot be read 
+ * either.
+ */
+MappedFile::MappedFile(const std::filesystem::path& path) : 
+    data{nullptr}, 
+    size{0}, 
+    contents{}, 
+    isMapped{false} {
+    data = mapFile(path, size);
+    if (data != nullptr) {
+        isMapped = true;
+        return;
+    }
+
+    std::ifstream file{path, std::ios_base::binary};
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    contents.assign(std::istreambuf_iterator<char>{file}, 
+        std::istreambuf_iterator<char>{});
+    if (file.bad()) {
+        throw std::runtime_error("Failed to read file: " + path.string());
+    }
+    data = contents.data();
+    size = contents.size();
+}
+
+MappedFile::~MappedFile() {
+    if (isMapped) {
+        unmapFile(data, size);
+    }
+}
+
+const uint8_t* MappedFile::getData() const {
+    return data;
+}
+
+size_t MappedFile::getSize() const {
+    return size;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace OCTACHIP {
+
+/**
+ * A whole file, mapped read-only into memory so that its pages are only read 
+ * from disk when touched and are shared between processes. On platforms 
+ * without memory mapping, the file is read into memory instead.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* getData() const;
+    size_t getSize() const;
+private:
+    const uint8_t* data;
+    size_t size;
+    // Holds the file where it could not be mapped
+    std::vector<uint8_t> contents;
+    bool isMapped;
+};
+
+}
\ No newline at end of file
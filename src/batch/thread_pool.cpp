@@ -0,0 +1,118 @@
+#include <utility>
+
+#include "batch/thread_pool.hpp"
+
+using namespace OCTACHIP;
+
+ThreadPool::ThreadPool(const int threadCount) : 
+    queues{}, 
+    workers{}, 
+    stateMutex{}, 
+    taskQueued{}, 
+    tasksFinished{}, 
+    queuedTaskCount{0}, 
+    unfinishedTaskCount{0}, 
+    nextQueue{0}, 
+    stopping{false} {
+    const int workerCount = threadCount > 0 ? threadCount : 1;
+    for (int index = 0; index < workerCount; index++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int index = 0; index < workerCount; index++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, index);
+    }
+}
+
+// Finishes every queued task before joining the workers.
+ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard<std::mutex> lock{stateMutex};
+        stopping = true;
+    }
+    taskQueued.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Queues a task on the next worker in turn. Idle workers steal it if that 
+ * worker is busy.
+ */
+void ThreadPool::submit(Task task) {
+    std::unique_lock<std::mutex> lock{stateMutex};
+    WorkQueue& queue = *queues[nextQueue];
+    nextQueue = (nextQueue + 1) % static_cast<int>(queues.size());
+    lock.unlock();
+
+    {
+        const std::lock_guard<std::mutex> queueLock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+
+    lock.lock();
+    queuedTaskCount++;
+    unfinishedTaskCount++;
+    lock.unlock();
+    taskQueued.notify_one();
+}
+
+// Blocks until every submitted task has finished.
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock{stateMutex};
+    tasksFinished.wait(lock, [this] { return unfinishedTaskCount == 0; });
+}
+
+void ThreadPool::workerLoop(const int index) {
+    while (true) {
+        Task task;
+        if (takeTask(index, task)) {
+            task();
+
+            const std::lock_guard<std::mutex> lock{stateMutex};
+            if (--unfinishedTaskCount == 0) {
+                tasksFinished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{stateMutex};
+        taskQueued.wait(lock, [this] { 
+            return stopping || queuedTaskCount > 0; 
+        });
+        if (stopping && queuedTaskCount == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * Takes the most recently queued task from the worker's own queue, or steals 
+ * the oldest task from another worker's queue. Returns false if every queue 
+ * is empty.
+ */
+bool ThreadPool::takeTask(const int index, Task& task) {
+    const int queueCount = static_cast<int>(queues.size());
+
+    for (int offset = 0; offset < queueCount; offset++) {
+        WorkQueue& queue = *queues[(index + offset) % queueCount];
+        std::unique_lock<std::mutex> queueLock{queue.mutex};
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queueLock.unlock();
+
+        const std::lock_guard<std::mutex> lock{stateMutex};
+        queuedTaskCount--;
+        return true;
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OCTACHIP {
+
+/**
+ * Fixed-size pool of worker threads with one task queue per worker. Workers 
+ * take tasks from the back of their own queue and steal from the front of the 
+ * other queues once theirs is empty, so a worker stuck on a long task does not 
+ * hold up the tasks queued behind it.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(const int threadCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+    void wait();
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(const int index);
+    bool takeTask(const int index, Task& task);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex stateMutex;
+    std::condition_variable taskQueued;
+    std::condition_variable tasksFinished;
+    int queuedTaskCount;
+    int unfinishedTaskCount;
+    int nextQueue;
+    bool stopping;
+};
+
+}
\ No newline at end of file
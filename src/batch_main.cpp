@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cxxopts.hpp>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch/batch_runner.hpp"
+
+int parsePositive(const cxxopts::ParseResult& result, 
+    const std::string& option, const std::string& description);
+
+int main(int argc, char* argv[]) {
+    const int defaultThreads = 
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    cxxopts::Options options{"octachip-batch", 
+        "Runs CHIP-8 ROMs headless and reports the results as JSON"};
+    options.add_options()
+        ("h,help", "Print usage")
+        ("l,list", "ROM list in the format of roms.json", 
+            cxxopts::value<std::string>())
+        ("d,rom-dir", "Directory the ROM filenames are relative to", 
+            cxxopts::value<std::string>()->default_value("."))
+        ("p,pack", "ROM pack to run instead of a ROM list", 
+            cxxopts::value<std::string>())
+        ("write-pack", "Write the listed ROMs to a ROM pack and exit", 
+            cxxopts::value<std::string>())
+        ("f,frames", "Number of 60 Hz frames to run each ROM for", 
+            cxxopts::value<int>()->default_value("600"))
+        ("b,budget", "Maximum instructions per ROM (0 for no limit)", 
+            cxxopts::value<uint64_t>()->default_value("0"))
+        ("s,seed", "Seed for the random numbers drawn by the ROMs", 
+            cxxopts::value<uint64_t>()->default_value("0"))
+        ("j,threads", "Number of worker threads", 
+            cxxopts::value<int>()->default_value(
+                std::to_string(defaultThreads)))
+        ("m,movie", "Replay an input movie against the listed ROM it was "
+            "recorded with, instead of running every ROM (repeatable)", 
+            cxxopts::value<std::vector<std::string>>())
+        ("o,output", "Output file path (standard output if omitted)", 
+            cxxopts::value<std::string>());
+
+    try {
+        cxxopts::ParseResult result = options.parse(argc, argv);
+
+        if (result.count("help")) {
+            std::cout << options.help();
+            return EXIT_SUCCESS;
+        }
+
+        if (result.count("list") == 0 && result.count("pack") == 0) {
+            throw std::runtime_error("No ROM list or pack provided\n"
+                "Usage: ./octachip-batch -l <PATH> | -p <PATH>");
+        }
+
+        OCTACHIP::BatchLimits limits{};
+        limits.frameCount = parsePositive(result, "frames", 
+            "frame count");
+        limits.instructionBudget = result["budget"].as<uint64_t>();
+        limits.seed = result["seed"].as<uint64_t>();
+        const int threadCount = parsePositive(result, "threads", 
+            "thread count");
+
+        // The pack stays mapped until every ROM in it has run
+        std::optional<OCTACHIP::MappedFile> pack;
+        std::vector<OCTACHIP::RomProfile> profiles;
+        if (result.count("pack")) {
+            pack.emplace(result["pack"].as<std::string>());
+            profiles = OCTACHIP::loadPackProfiles(*pack);
+        } else {
+            profiles = OCTACHIP::loadRomProfiles(
+                result["list"].as<std::string>(), 
+                result["rom-dir"].as<std::string>());
+        }
+
+        if (result.count("write-pack")) {
+            OCTACHIP::writeRomPack(profiles, 
+                result["write-pack"].as<std::string>());
+            return EXIT_SUCCESS;
+        }
+
+        std::ofstream outputFile;
+        if (result.count("output")) {
+            const std::string outputPath = result["output"].as<std::string>();
+            outputFile.open(outputPath);
+            if (!outputFile) {
+                throw std::runtime_error("Failed to open output file: " + 
+                    outputPath);
+            }
+        }
+        std::ostream& output = result.count("output") ? 
+            static_cast<std::ostream&>(outputFile) : std::cout;
+
+        if (result.count("movie")) {
+            const std::vector<std::string>& movies = 
+                result["movie"].as<std::vector<std::string>>();
+            const std::vector<std::filesystem::path> moviePaths(
+                std::begin(movies), std::end(movies));
+            OCTACHIP::writeMovieResults(output, 
+                OCTACHIP::replayMovies(moviePaths, profiles, threadCount));
+        } else {
+            OCTACHIP::writeResults(output, 
+                OCTACHIP::runBatch(profiles, limits, threadCount));
+        }
+    }
+    catch (const cxxopts::exceptions::exception& e) {
+        std::cerr << "Error parsing options: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int parsePositive(const cxxopts::ParseResult& result, 
+    const std::string& option, const std::string& description) {
+    if (result[option].as<int>() <= 0) {
+        throw std::invalid_argument("Invalid argument: " + description + 
+            " must be greater than 0");
+    }
+    return result[option].as<int>();
+}
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include <algorithm>
+
+#include "core/block_cache.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+DecodedInstruction decodeAt(const Memory& memory, const int address) {
+    if (address >= MEMORY_SIZE - 1) {
+        return {Operation::PC_OUT_OF_BOUNDS, Opcode{0x0000}};
+    }
+    const Opcode opcode = memory[address] << 8 | memory[address + 1];
+    return {decode(opcode), opcode};
+}
+
+/**
+ * Returns whether an instruction may observe the value of VF. Fx65 is treated 
+ * as an observer because it can fault part way through the block.
+ */
+bool readsFlag(const DecodedInstruction& instruction) {
+    const bool readsX = instruction.opcode.x() == 0xF;
+    const bool readsY = instruction.opcode.y() == 0xF;
+    switch (instruction.operation) {
+        case Operation::SE_VX_BYTE:
+        case Operation::SNE_VX_BYTE:
+        case Operation::ADD_VX_BYTE:
+        case Operation::SKP_VX:
+        case Operation::SKNP_VX:
+        case Operation::LD_DT_VX:
+        case Operation::LD_ST_VX:
+        case Operation::ADD_I_VX:
+        case Operation::LD_F_VX:
+        case Operation::LD_B_VX:
+        case Operation::LD_I_VX:
+            return readsX;
+        case Operation::LD_VX_VY:
+            return readsY;
+        case Operation::SE_VX_VY:
+        case Operation::OR_VX_VY:
+        case Operation::AND_VX_VY:
+        case Operation::XOR_VX_VY:
+        case Operation::ADD_VX_VY:
+        case Operation::SUB_VX_VY:
+        case Operation::SHR_VX_VY:
+        case Operation::SUBN_VX_VY:
+        case Operation::SHL_VX_VY:
+        case Operation::SNE_VX_VY:
+        case Operation::DRW_VX_VY_NIBBLE:
+            return readsX || readsY;
+        case Operation::LD_VX_I:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns whether an instruction always overwrites VF. DRW is left out, as 
+// it faults without touching VF when its sprite runs past the end of memory.
+bool writesFlag(const DecodedInstruction& instruction) {
+    switch (instruction.operation) {
+        case Operation::LD_VX_BYTE:
+        case Operation::LD_VX_VY:
+        case Operation::OR_VX_VY:
+        case Operation::AND_VX_VY:
+        case Operation::XOR_VX_VY:
+        case Operation::RND_VX_BYTE:
+        case Operation::LD_VX_DT:
+            return instruction.opcode.x() == 0xF;
+        case Operation::ADD_VX_VY:
+        case Operation::SUB_VX_VY:
+        case Operation::SHR_VX_VY:
+        case Operation::SUBN_VX_VY:
+        case Operation::SHL_VX_VY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns whether the VF result of the instruction at the given index is 
+ * overwritten before anything can observe it. VF is assumed to be observed 
+ * once control leaves the block.
+ */
+bool isFlagDead(const DecodedInstruction* instructions, const int index, 
+    const int count) {
+    for (int i = index + 1; i < count; i++) {
+        if (readsFlag(instructions[i])) {
+            return false;
+        }
+        if (writesFlag(instructions[i])) {
+            return true;
+        }
+        if (isBlockTerminator(instructions[i].operation)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+Operation withoutFlag(const Operation operation) {
+    switch (operation) {
+        case Operation::ADD_VX_VY: return Operation::ADD_VX_VY_NO_FLAG;
+        case Operation::SUB_VX_VY: return Operation::SUB_VX_VY_NO_FLAG;
+        case Operation::SHR_VX_VY: return Operation::SHR_VX_VY_NO_FLAG;
+        case Operation::SUBN_VX_VY: return Operation::SUBN_VX_VY_NO_FLAG;
+        case Operation::SHL_VX_VY: return Operation::SHL_VX_VY_NO_FLAG;
+        default: return Operation::UNDECODED;
+    }
+}
+
+Operation withJump(const Operation operation) {
+    switch (operation) {
+        case Operation::SE_VX_BYTE: return Operation::SE_VX_BYTE_JP;
+        case Operation::SNE_VX_BYTE: return Operation::SNE_VX_BYTE_JP;
+        case Operation::SE_VX_VY: return Operation::SE_VX_VY_JP;
+        case Operation::SNE_VX_VY: return Operation::SNE_VX_VY_JP;
+        case Operation::SKP_VX: return Operation::SKP_VX_JP;
+        case Operation::SKNP_VX: return Operation::SKNP_VX_JP;
+        default: return Operation::UNDECODED;
+    }
+}
+
+/**
+ * Returns whether the micro-ops form a loop back to the block's own address 
+ * that does nothing but wait for the delay timer to change, either 
+ * "JP self" or "LD Vx, DT; SE/SNE Vx, kk; JP self".
+ */
+bool isIdleLoop(const MicroOp* microOps, const int length, 
+    const uint16_t address) {
+    if (length == 1) {
+        return microOps[0].operation == Operation::JP_ADDR && 
+            microOps[0].opcode.address() == address;
+    }
+    return length == 2 && 
+        microOps[0].operation == Operation::LD_VX_DT && 
+        (microOps[1].operation == Operation::SE_VX_BYTE_JP || 
+            microOps[1].operation == Operation::SNE_VX_BYTE_JP) && 
+        microOps[1].opcode.x() == microOps[0].opcode.x() && 
+        microOps[1].fused.address() == address;
+}
+
+}
+
+BlockCache::BlockCache() : blocks{}, pool{} {
+    pool.reserve(POOL_SIZE);
+}
+
+/**
+ * Returns the block starting at the given address, translating it from memory 
+ * first if needed. The block's micro-ops stay valid until the next fetch.
+ */
+const Block& BlockCache::fetch(const Memory& memory, const uint16_t address) {
+    Block& block = blocks[address];
+    if (block.length == 0) {
+        translate(memory, address, block);
+    }
+    return block;
+}
+
+const MicroOp* BlockCache::microOps(const Block& block) const {
+    return pool.data() + block.first;
+}
+
+/**
+ * Discards every block that covers a byte in the written range 
+ * [address, address + length).
+ */
+void BlockCache::invalidate(const int address, const int length) {
+    const int first = std::max(address - 2 * (MAX_BLOCK_LENGTH + 1) + 1, 0);
+    const int last = std::min(address + length, MEMORY_SIZE);
+    for (int i = first; i < last; i++) {
+        if (i + 2 * blocks[i].instructionCount > address) {
+            blocks[i] = Block{};
+        }
+    }
+}
+
+void BlockCache::clear() {
+    blocks.fill(Block{});
+    pool.clear();
+}
+
+/**
+ * Lowers the basic block starting at the given address into micro-ops. A block 
+ * runs up to and including its first terminating instruction, and is cut short 
+ * after MAX_BLOCK_LENGTH instructions. While lowering, the translator:
+ * 
+ * - fuses a skip followed by JP nnn into a single conditional jump,
+ * - fuses consecutive LD Vx, kk instructions into pairs, and
+ * - drops the VF result of 8xy4, 8xy5, 8xy6, 8xy7 and 8xyE when VF is 
+ *   overwritten later in the block before anything reads it.
+ * 
+ * Blocks that only spin on the delay timer are marked as idle loops.
+ */
+void BlockCache::translate(const Memory& memory, const uint16_t address, 
+    Block& block) {
+    std::array<DecodedInstruction, MAX_BLOCK_LENGTH + 1> instructions{};
+    int count = 0;
+    int current = address;
+
+    while (count < MAX_BLOCK_LENGTH) {
+        instructions[count] = decodeAt(memory, current);
+        current += 2;
+        if (isBlockTerminator(instructions[count++].operation)) {
+            break;
+        }
+    }
+
+    const Operation terminator = instructions[count - 1].operation;
+    const bool fuseJump = withJump(terminator) != Operation::UNDECODED && 
+        decodeAt(memory, current).operation == Operation::JP_ADDR;
+    if (fuseJump) {
+        instructions[count++] = decodeAt(memory, current);
+    }
+
+    if (pool.size() + count > POOL_SIZE) {
+        clear();
+    }
+
+    block.first = static_cast<uint16_t>(pool.size());
+
+    int i = 0;
+    while (i < count) {
+        const DecodedInstruction& instruction = instructions[i];
+        MicroOp microOp{instruction.operation, instruction.opcode};
+
+        if (fuseJump && i == count - 2) {
+            microOp.operation = withJump(instruction.operation);
+            microOp.fused = instructions[++i].opcode;
+        }
+        else if (instruction.operation == Operation::LD_VX_BYTE && 
+            i + 1 < count && 
+            instructions[i + 1].operation == Operation::LD_VX_BYTE) {
+            microOp.operation = Operation::LD_VX_BYTE_PAIR;
+            microOp.fused = instructions[++i].opcode;
+        }
+        else if (withoutFlag(instruction.operation) != Operation::UNDECODED && 
+            isFlagDead(instructions.data(), i, count)) {
+            microOp.operation = withoutFlag(instruction.operation);
+        }
+
+        pool.push_back(microOp);
+        i++;
+    }
+
+    block.length = static_cast<uint8_t>(pool.size() - block.first);
+    block.instructionCount = static_cast<uint8_t>(count);
+    block.idleLoop = isIdleLoop(microOps(block), block.length, address);
+}
\ No newline at end of file
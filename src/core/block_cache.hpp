@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "core/instruction_cache.hpp"
+#include "core/opcode.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+// A single step of a translated block. Most micro-ops execute one CHIP-8 
+// instruction, while superinstructions also carry the instruction that was 
+// fused into them.
+struct MicroOp {
+    Operation operation{Operation::UNDECODED};
+    Opcode opcode{0x0000};
+    Opcode fused{0x0000};
+};
+
+struct Block {
+    // Index of the block's first micro-op
+    uint16_t first{};
+    // Number of micro-ops in the block, or 0 if no block has been translated
+    uint8_t length{};
+    // Number of CHIP-8 instructions covered by the block. A fused skip may 
+    // execute one instruction fewer than this.
+    uint8_t instructionCount{};
+    // Whether the block loops back to itself and changes nothing but the 
+    // register it polls the delay timer into
+    bool idleLoop{};
+};
+
+class BlockCache {
+public:
+    static constexpr int MAX_BLOCK_LENGTH = 32;
+    // Micro-ops are allocated from a fixed pool that is emptied whenever a 
+    // translation would not fit in it
+    static constexpr int POOL_SIZE = 4096;
+
+    BlockCache();
+
+    const Block& fetch(const Memory& memory, const uint16_t address);
+    const MicroOp* microOps(const Block& block) const;
+    void invalidate(const int address, const int length);
+    void clear();
+private:
+    void translate(const Memory& memory, const uint16_t address, 
+        Block& block);
+
+    std::array<Block, InstructionCache::ENTRY_COUNT> blocks;
+    std::vector<MicroOp> pool;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <new>
+
+#include "core/c_api.h"
+#include "core/environment.hpp"
+#include "core/fault.hpp"
+#include "core/interpreter.hpp"
+#include "core/types.hpp"
+
+using namespace OCTACHIP;
+
+static_assert(OCTACHIP_FRAME_WIDTH == FRAME_WIDTH);
+static_assert(OCTACHIP_FRAME_HEIGHT == FRAME_HEIGHT);
+static_assert(OCTACHIP_KEY_COUNT == KEY_COUNT);
+static_assert(OCTACHIP_STATE_SIZE == Interpreter::STATE_SIZE);
+static_assert(OCTACHIP_FAULT_PC_OUT_OF_BOUNDS == 
+    static_cast<int>(FaultKind::PC_OUT_OF_BOUNDS));
+
+struct octachip_instance {
+    Interpreter interpreter;
+    int instructionsPerFrame;
+};
+
+struct octachip_env {
+    Environment environment;
+};
+
+namespace {
+
+octachip_step_result toStepResult(const StepResult& result) {
+    return {result.frameChanged ? 1 : 0, result.done ? 1 : 0, 
+        static_cast<octachip_fault>(result.fault)};
+}
+
+}
+
+octachip_instance* octachip_create(const int instructions_per_frame) {
+    if (instructions_per_frame <= 0) {
+        return nullptr;
+    }
+    return new (std::nothrow) octachip_instance{Interpreter{}, 
+        instructions_per_frame};
+}
+
+void octachip_destroy(octachip_instance* instance) {
+    delete instance;
+}
+
+void octachip_reset(octachip_instance* instance) {
+    instance->interpreter.reset();
+}
+
+int octachip_load_rom(octachip_instance* instance, const uint8_t* rom, 
+    const size_t size) {
+    return instance->interpreter.loadRom(rom, size) ? -1 : 0;
+}
+
+void octachip_set_quirks(octachip_instance* instance, const int load_store, 
+    const int shift, const int wrap) {
+    instance->interpreter.setLoadStoreQuirk(load_store != 0);
+    instance->interpreter.setShiftQuirk(shift != 0);
+    instance->interpreter.setWrapQuirk(wrap != 0);
+}
+
+void octachip_set_key(octachip_instance* instance, const int key, 
+    const int is_pressed) {
+    if (key < 0 || key >= KEY_COUNT) {
+        return;
+    }
+    instance->interpreter.setKey(key, is_pressed != 0);
+}
+
+octachip_fault octachip_step(octachip_instance* instance, 
+    const int frame_count) {
+    Interpreter& interpreter = instance->interpreter;
+
+    for (int frame = 0; frame < frame_count; frame++) {
+        const Fault& fault = interpreter.run(instance->instructionsPerFrame);
+        if (fault.kind != FaultKind::NONE) {
+            return static_cast<octachip_fault>(fault.kind);
+        }
+        interpreter.updateTimers();
+    }
+    return OCTACHIP_FAULT_NONE;
+}
+
+void octachip_read_frame(const octachip_instance* instance, uint8_t* pixels) {
+    const Frame& frame = instance->interpreter.getFrame();
+
+    for (int row = 0; row < FRAME_HEIGHT; row++) {
+        for (int col = 0; col < FRAME_WIDTH; col++) {
+            *pixels++ = getPixel(frame, col, row);
+        }
+    }
+}
+
+void octachip_read_frame_rows(const octachip_instance* instance, 
+    uint64_t* rows) {
+    const Frame& frame = instance->interpreter.getFrame();
+    std::copy(std::begin(frame), std::end(frame), rows);
+}
+
+void octachip_read_registers(const octachip_instance* instance, 
+    octachip_registers* registers) {
+    const Interpreter& interpreter = instance->interpreter;
+
+    for (int index = 0; index < Registers::V_REG_COUNT; index++) {
+        registers->v[index] = interpreter.getRegisterValue(index);
+    }
+    registers->pc = interpreter.getProgramCounterValue();
+    registers->i = interpreter.getIndexRegisterValue();
+    registers->sp = interpreter.getStackPointerValue();
+    registers->delay_timer = interpreter.getDelayTimerValue();
+    registers->sound_timer = interpreter.getSoundTimerValue();
+}
+
+size_t octachip_save_state(const octachip_instance* instance, 
+    uint8_t* buffer, const size_t size) {
+    return instance->interpreter.saveState(buffer, size);
+}
+
+int octachip_load_state(octachip_instance* instance, const uint8_t* buffer, 
+    const size_t size) {
+    return instance->interpreter.loadState(buffer, size) ? 0 : -1;
+}
+
+uint64_t octachip_state_hash(const octachip_instance* instance) {
+    return instance->interpreter.getStateHash();
+}
+
+octachip_env* octachip_env_create(const octachip_env_config* config, 
+    const uint8_t* rom, const size_t size) {
+    if (config->instructions_per_frame <= 0 || config->frame_stack <= 0 || 
+        config->max_frames < 0 || 
+        (config->ram_addresses == nullptr && config->ram_address_count > 0)) {
+        return nullptr;
+    }
+
+    EnvironmentConfig environmentConfig{};
+    environmentConfig.instructionsPerFrame = config->instructions_per_frame;
+    environmentConfig.frameStack = config->frame_stack;
+    environmentConfig.maxFrames = config->max_frames;
+    environmentConfig.loadStoreQuirk = config->load_store_quirk != 0;
+    environmentConfig.shiftQuirk = config->shift_quirk != 0;
+    environmentConfig.wrapQuirk = config->wrap_quirk != 0;
+    environmentConfig.ramAddresses.assign(config->ram_addresses, 
+        config->ram_addresses + config->ram_address_count);
+
+    octachip_env* env = new (std::nothrow) octachip_env{
+        Environment{environmentConfig}};
+    if (env != nullptr && env->environment.loadRom(rom, size)) {
+        delete env;
+        return nullptr;
+    }
+    return env;
+}
+
+void octachip_env_destroy(octachip_env* env) {
+    delete env;
+}
+
+octachip_step_result octachip_env_reset(octachip_env* env, 
+    const uint64_t seed, uint64_t* frames, uint8_t* ram) {
+    return toStepResult(env->environment.reset(seed, frames, ram));
+}
+
+octachip_step_result octachip_env_step(octachip_env* env, 
+    const uint16_t action_mask, const int frame_count, uint64_t* frames, 
+    uint8_t* ram) {
+    return toStepResult(env->environment.step(action_mask, frame_count, 
+        frames, ram));
+}
\ No newline at end of file
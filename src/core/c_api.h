@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * C interface to the OCTACHIP core, for embedding the interpreter without SDL 
+ * or a display. Every function taking an instance expects a pointer returned 
+ * by octachip_create() that has not been destroyed yet.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OCTACHIP_FRAME_WIDTH 64
+#define OCTACHIP_FRAME_HEIGHT 32
+#define OCTACHIP_KEY_COUNT 16
+// Size in bytes of the snapshots written by octachip_save_state()
+#define OCTACHIP_STATE_SIZE 4448
+
+typedef struct octachip_instance octachip_instance;
+typedef struct octachip_env octachip_env;
+
+typedef enum octachip_fault {
+    OCTACHIP_FAULT_NONE = 0, 
+    OCTACHIP_FAULT_ILLEGAL_OPCODE,
+    OCTACHIP_FAULT_STACK_UNDERFLOW,
+    OCTACHIP_FAULT_STACK_OVERFLOW,
+    OCTACHIP_FAULT_MEMORY_OUT_OF_BOUNDS,
+    OCTACHIP_FAULT_PC_OUT_OF_BOUNDS
+} octachip_fault;
+
+typedef struct octachip_registers {
+    uint8_t v[16];
+    uint16_t pc;
+    uint16_t i;
+    uint8_t sp;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+} octachip_registers;
+
+// Creates an interpreter that runs the given number of instructions per 
+// 60 Hz frame. Returns NULL if the count is not positive or allocation fails.
+octachip_instance* octachip_create(int instructions_per_frame);
+
+void octachip_destroy(octachip_instance* instance);
+
+// Resets the interpreter to its initial state, keeping the font set.
+void octachip_reset(octachip_instance* instance);
+
+// Copies a ROM image into memory at 0x200. Returns 0 on success, or -1 if 
+// the ROM is too large.
+int octachip_load_rom(octachip_instance* instance, const uint8_t* rom, 
+    size_t size);
+
+void octachip_set_quirks(octachip_instance* instance, int load_store, 
+    int shift, int wrap);
+
+// Sets the state of key 0x0 to 0xF. Keys outside of that range are ignored.
+void octachip_set_key(octachip_instance* instance, int key, int is_pressed);
+
+// Runs the given number of frames, each made of the configured number of 
+// instructions followed by a timer update. Stops early and returns the fault 
+// if an instruction faults.
+octachip_fault octachip_step(octachip_instance* instance, int frame_count);
+
+// Writes one byte per pixel, 0 or 1, in row-major order into a buffer of 
+// OCTACHIP_FRAME_WIDTH * OCTACHIP_FRAME_HEIGHT bytes.
+void octachip_read_frame(const octachip_instance* instance, uint8_t* pixels);
+
+// Writes one word per row into a buffer of OCTACHIP_FRAME_HEIGHT words, with 
+// the leftmost pixel of each row in the most significant bit.
+void octachip_read_frame_rows(const octachip_instance* instance, 
+    uint64_t* rows);
+
+void octachip_read_registers(const octachip_instance* instance, 
+    octachip_registers* registers);
+
+// Writes a snapshot of the whole machine into the buffer. Returns the number 
+// of bytes written, or 0 if size is less than OCTACHIP_STATE_SIZE.
+size_t octachip_save_state(const octachip_instance* instance, 
+    uint8_t* buffer, size_t size);
+
+// Restores a snapshot written by octachip_save_state(). Returns 0 on success, 
+// or -1 if the snapshot is invalid, in which case the instance is unchanged.
+int octachip_load_state(octachip_instance* instance, const uint8_t* buffer, 
+    size_t size);
+
+// Returns a 64-bit hash of the memory, registers, stack, timers and frame, 
+// for deduplicating visited states. Costs the same whatever has changed.
+uint64_t octachip_state_hash(const octachip_instance* instance);
+
+/*
+ * Reinforcement learning environments. Each step holds down the keys in an 
+ * action mask for a number of frames, then writes the observation into 
+ * buffers owned by the caller, so stepping never allocates.
+ */
+
+typedef struct octachip_env_config {
+    int instructions_per_frame;
+    // Number of observed frames written by each step, newest first
+    int frame_stack;
+    // Number of frames after which an episode ends, or 0 for no limit
+    int max_frames;
+    int load_store_quirk;
+    int shift_quirk;
+    int wrap_quirk;
+    // Memory addresses whose values are written by each step
+    const uint16_t* ram_addresses;
+    size_t ram_address_count;
+} octachip_env_config;
+
+typedef struct octachip_step_result {
+    // 1 if the last frame differs from the one observed before the step
+    int frame_changed;
+    // 1 once the program has faulted or the frame limit has been reached
+    int done;
+    octachip_fault fault;
+} octachip_step_result;
+
+// Creates an environment running a copy of the given ROM. Returns NULL if the 
+// configuration or ROM is invalid, or allocation fails. The environment must 
+// be reset before the first step.
+octachip_env* octachip_env_create(const octachip_env_config* config, 
+    const uint8_t* rom, size_t size);
+
+void octachip_env_destroy(octachip_env* env);
+
+// Starts a new episode with the random number generator seeded from the given 
+// value. Writes the initial observation like octachip_env_step().
+octachip_step_result octachip_env_reset(octachip_env* env, uint64_t seed, 
+    uint64_t* frames, uint8_t* ram);
+
+// Holds down the keys set in action_mask, with bit n for key n, for the given 
+// number of frames. Writes frame_stack frames of OCTACHIP_FRAME_HEIGHT rows 
+// into frames, newest first, and one byte per RAM address into ram. Either 
+// buffer may be NULL. Steps after the end of an episode do nothing.
+octachip_step_result octachip_env_step(octachip_env* env, 
+    uint16_t action_mask, int frame_count, uint64_t* frames, uint8_t* ram);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <algorithm>
+
+#include "core/disassembler.hpp"
+#include "core/instruction_cache.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+// The lowest digits of a value, written in upper case hexadecimal
+struct Hex {
+    int value;
+    int digits;
+};
+
+// Writes a mnemonic into a caller's buffer, which has to hold at least 
+// MAX_MNEMONIC_LENGTH characters
+class MnemonicWriter {
+public:
+    explicit MnemonicWriter(char* target) : 
+        text{target}, 
+        length{0} {}
+
+    MnemonicWriter& operator<<(const char* value) {
+        while (*value != '\0') {
+            text[length++] = *value++;
+        }
+        return *this;
+    }
+
+    MnemonicWriter& operator<<(const Hex hex) {
+        constexpr char DIGITS[] = "0123456789ABCDEF";
+        for (int digit = hex.digits - 1; digit >= 0; digit--) {
+            text[length++] = DIGITS[(hex.value >> digit * 4) & 0xF];
+        }
+        return *this;
+    }
+
+    int getLength() const {
+        return length;
+    }
+private:
+    char* text;
+    int length;
+};
+
+}
+
+/**
+ * Writes the mnemonic of an opcode into the given buffer, which has to hold 
+ * at least MAX_MNEMONIC_LENGTH characters, and returns its length. The text 
+ * is not null-terminated. Opcodes that are not instructions are written as 
+ * "-".
+ */
+int OCTACHIP::formatInstruction(const Opcode& opcode, char* text) {
+    const Hex x{opcode.x(), 1};
+    const Hex y{opcode.y(), 1};
+    const Hex byte{opcode.byte(), 2};
+    const Hex address{opcode.address(), 4};
+
+    MnemonicWriter writer{text};
+    switch (decode(opcode)) {
+        case Operation::CLS: 
+            writer << "CLS";
+            break;
+        case Operation::RET: 
+            writer << "RET";
+            break;
+        case Operation::JP_ADDR: 
+            writer << "JP 0x" << address;
+            break;
+        case Operation::CALL_ADDR: 
+            writer << "CALL 0x" << address;
+            break;
+        case Operation::SE_VX_BYTE: 
+            writer << "SE V" << x << ", 0x" << byte;
+            break;
+        case Operation::SNE_VX_BYTE: 
+            writer << "SNE V" << x << ", 0x" << byte;
+            break;
+        case Operation::SE_VX_VY: 
+            writer << "SE V" << x << ", V" << y;
+            break;
+        case Operation::LD_VX_BYTE: 
+            writer << "LD V" << x << ", 0x" << byte;
+            break;
+        case Operation::ADD_VX_BYTE: 
+            writer << "ADD V" << x << ", 0x" << byte;
+            break;
+        case Operation::LD_VX_VY: 
+            writer << "LD V" << x << ", V" << y;
+            break;
+        case Operation::OR_VX_VY: 
+            writer << "OR V" << x << ", V" << y;
+            break;
+        case Operation::AND_VX_VY: 
+            writer << "AND V" << x << ", V" << y;
+            break;
+        case Operation::XOR_VX_VY: 
+            writer << "XOR V" << x << ", V" << y;
+            break;
+        case Operation::ADD_VX_VY: 
+            writer << "ADD V" << x << ", V" << y;
+            break;
+        case Operation::SUB_VX_VY: 
+            writer << "SUB V" << x << ", V" << y;
+            break;
+        case Operation::SHR_VX_VY: 
+            writer << "SHR V" << x << ", V" << y;
+            break;
+        case Operation::SUBN_VX_VY: 
+            writer << "SUBN V" << x << ", V" << y;
+            break;
+        case Operation::SHL_VX_VY: 
+            writer << "SHL V" << x << ", V" << y;
+            break;
+        case Operation::SNE_VX_VY: 
+            writer << "SNE V" << x << ", V" << y;
+            break;
+        case Operation::LD_I_ADDR: 
+            writer << "LD I, 0x" << address;
+            break;
+        case Operation::JP_V0_ADDR: 
+            writer << "JP V0, 0x" << address;
+            break;
+        case Operation::RND_VX_BYTE: 
+            writer << "RND V" << x << ", 0x" << byte;
+            break;
+        case Operation::DRW_VX_VY_NIBBLE: 
+            writer << "DRW V" << x << ", V" << y << ", 0x"
+                << Hex{opcode.nibble(), 1};
+            break;
+        case Operation::SKP_VX: 
+            writer << "SKP V" << x;
+            break;
+        case Operation::SKNP_VX: 
+            writer << "SKNP V" << x;
+            break;
+        case Operation::LD_VX_DT: 
+            writer << "LD V" << x << ", DT";
+            break;
+        case Operation::LD_VX_K: 
+            writer << "LD V" << x << ", K";
+            break;
+        case Operation::LD_DT_VX: 
+            writer << "LD DT, V" << x;
+            break;
+        case Operation::LD_ST_VX: 
+            writer << "LD ST, V" << x;
+            break;
+        case Operation::ADD_I_VX: 
+            writer << "ADD I, V" << x;
+            break;
+        case Operation::LD_F_VX: 
+            writer << "LD F, V" << x;
+            break;
+        case Operation::LD_B_VX: 
+            writer << "LD B, V" << x;
+            break;
+        case Operation::LD_I_VX: 
+            writer << "LD [I], V" << x;
+            break;
+        case Operation::LD_VX_I: 
+            writer << "LD V" << x << ", [I]";
+            break;
+        default: 
+            writer << "-";
+    }
+    return writer.getLength();
+}
+
+DisassemblyCache::DisassemblyCache() : lines{} {}
+
+/**
+ * Returns the mnemonic of the instruction at the given address, formatting 
+ * it from memory first if it is not cached. The view stays valid until the 
+ * line is invalidated. The last byte of memory has no instruction, as its 
+ * second byte would be outside memory.
+ */
+std::string_view DisassemblyCache::fetch(const Memory& memory, 
+    const int address) {
+    if (lines.empty()) {
+        lines.resize(MEMORY_SIZE);
+    }
+
+    Line& line = lines[address];
+    if (line.length == 0) {
+        const Opcode opcode = address < MEMORY_SIZE - 1 ?
+            memory[address] << 8 | memory[address + 1] : 0xFFFF;
+        line.length = static_cast<uint8_t>(
+            formatInstruction(opcode, line.text.data()));
+    }
+    return {line.text.data(), line.length};
+}
+
+/**
+ * Discards every line whose two instruction bytes overlap the written range 
+ * [address, address + length), including the one starting a byte before it.
+ */
+void DisassemblyCache::invalidate(const int address, const int length) {
+    if (lines.empty()) {
+        return;
+    }
+    const int first = std::max(address - 1, 0);
+    const int last = std::min(address + length, MEMORY_SIZE);
+    for (int i = first; i < last; i++) {
+        lines[i].length = 0;
+    }
+}
+
+void DisassemblyCache::clear() {
+    lines.clear();
+}
\ No newline at end of file
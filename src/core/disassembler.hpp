@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "core/opcode.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+// Length of the longest mnemonic, "DRW VF, VF, 0xF"
+static constexpr int MAX_MNEMONIC_LENGTH = 15;
+
+int formatInstruction(const Opcode& opcode, char* text);
+
+/**
+ * Mnemonics of the instructions at every address, formatted the first time 
+ * they are asked for and kept until the memory under them is written. The 
+ * lines are only allocated once the disassembly is first used, so 
+ * interpreters that never show it pay nothing for it.
+ */
+class DisassemblyCache {
+public:
+    DisassemblyCache();
+
+    std::string_view fetch(const Memory& memory, const int address);
+    void invalidate(const int address, const int length);
+    void clear();
+private:
+    struct Line {
+        std::array<char, MAX_MNEMONIC_LENGTH> text;
+        // 0 until the line is formatted, as every mnemonic has some text
+        uint8_t length;
+    };
+
+    std::vector<Line> lines;
+};
+
+}
\ No newline at end of file
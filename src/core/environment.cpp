@@ -0,0 +1,128 @@
+#include <algorithm>
+
+#include "core/environment.hpp"
+
+using namespace OCTACHIP;
+
+Environment::Environment(const EnvironmentConfig& environmentConfig) : 
+    config{environmentConfig}, 
+    interpreter{}, 
+    rom{}, 
+    frameHistory(std::max(environmentConfig.frameStack, 1)), 
+    newestFrame{0}, 
+    elapsedFrames{0}, 
+    lastResult{} {
+    config.frameStack = static_cast<int>(frameHistory.size());
+    config.instructionsPerFrame = std::max(config.instructionsPerFrame, 1);
+}
+
+/**
+ * Keeps a copy of the ROM that every episode starts from. Returns a 
+ * description of the error if the ROM could not be loaded.
+ */
+std::optional<std::string> Environment::loadRom(const uint8_t* romData, 
+    const size_t romSize) {
+    const std::optional<std::string> error = 
+        interpreter.loadRom(romData, romSize);
+    if (!error) {
+        rom.assign(romData, romData + romSize);
+    }
+    return error;
+}
+
+/**
+ * Starts a new episode with the random number generator seeded from the given 
+ * value. The initial frame fills the whole frame stack.
+ */
+StepResult Environment::reset(const uint64_t seed, FrameRow* frames, 
+    uint8_t* ram) {
+    interpreter.reset();
+    interpreter.setLoadStoreQuirk(config.loadStoreQuirk);
+    interpreter.setShiftQuirk(config.shiftQuirk);
+    interpreter.setWrapQuirk(config.wrapQuirk);
+    interpreter.seedRandom(seed);
+    interpreter.loadRom(rom.data(), rom.size());
+
+    std::fill(std::begin(frameHistory), std::end(frameHistory), 
+        interpreter.getFrame());
+    elapsedFrames = 0;
+    lastResult = {};
+
+    writeObservation(frames, ram);
+    return lastResult;
+}
+
+/**
+ * Holds down the keys set in the action mask, with bit n for key n, and runs 
+ * the given number of frames. Stops early if the episode ends. Once it has 
+ * ended, steps only repeat the last observation until the next reset.
+ */
+StepResult Environment::step(const uint16_t actionMask, const int frameCount, 
+    FrameRow* frames, uint8_t* ram) {
+    if (lastResult.done) {
+        lastResult.frameChanged = false;
+        writeObservation(frames, ram);
+        return lastResult;
+    }
+
+    applyActions(actionMask);
+
+    for (int frame = 0; frame < frameCount; frame++) {
+        const Fault& fault = interpreter.run(config.instructionsPerFrame);
+        if (fault.kind != FaultKind::NONE) {
+            lastResult.fault = fault.kind;
+            lastResult.done = true;
+            break;
+        }
+        interpreter.updateTimers();
+
+        elapsedFrames++;
+        if (config.maxFrames > 0 && elapsedFrames >= config.maxFrames) {
+            lastResult.done = true;
+            break;
+        }
+    }
+
+    const Frame& observedFrame = interpreter.getFrame();
+    lastResult.frameChanged = observedFrame != frameHistory[newestFrame];
+    pushFrame(observedFrame);
+
+    writeObservation(frames, ram);
+    return lastResult;
+}
+
+const Interpreter& Environment::getInterpreter() const {
+    return interpreter;
+}
+
+void Environment::applyActions(const uint16_t actionMask) {
+    for (int key = 0; key < KEY_COUNT; key++) {
+        interpreter.setKey(key, (actionMask >> key & 1) != 0);
+    }
+}
+
+void Environment::pushFrame(const Frame& observedFrame) {
+    newestFrame = (newestFrame + 1) % config.frameStack;
+    frameHistory[newestFrame] = observedFrame;
+}
+
+/**
+ * Copies the frame stack, newest frame first, and the values of the RAM 
+ * addresses into the caller's buffers. Either buffer may be null.
+ */
+void Environment::writeObservation(FrameRow* frames, uint8_t* ram) const {
+    if (frames != nullptr) {
+        for (int age = 0; age < config.frameStack; age++) {
+            const int index = 
+                (newestFrame - age + config.frameStack) % config.frameStack;
+            frames = std::copy(std::begin(frameHistory[index]), 
+                std::end(frameHistory[index]), frames);
+        }
+    }
+
+    if (ram != nullptr) {
+        for (const uint16_t address : config.ramAddresses) {
+            *ram++ = interpreter.getMemoryValue(address);
+        }
+    }
+}
\ No newline at end of file
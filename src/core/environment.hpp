@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/fault.hpp"
+#include "core/interpreter.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+struct EnvironmentConfig {
+    int instructionsPerFrame{};
+    // Number of observed frames returned by each step, newest first
+    int frameStack{1};
+    // Number of frames after which an episode ends, or 0 for no limit
+    int maxFrames{};
+    bool loadStoreQuirk{true};
+    bool shiftQuirk{true};
+    bool wrapQuirk{false};
+    // Memory addresses whose values are returned by each step
+    std::vector<uint16_t> ramAddresses;
+};
+
+struct StepResult {
+    // Whether the last frame differs from the one observed before the step
+    bool frameChanged{};
+    // Whether the episode has ended, either because the program faulted or 
+    // because the frame limit was reached
+    bool done{};
+    FaultKind fault{FaultKind::NONE};
+};
+
+/**
+ * Reinforcement learning environment on top of the Interpreter. Each step 
+ * holds the keys in an action mask down for a number of frames, then writes 
+ * the observation into buffers owned by the caller: the last frameStack 
+ * observed frames, and the values of the configured RAM addresses. Nothing is 
+ * allocated after the environment is created.
+ */
+class Environment {
+public:
+    explicit Environment(const EnvironmentConfig& environmentConfig);
+
+    std::optional<std::string> loadRom(const uint8_t* romData, 
+        const size_t romSize);
+    StepResult reset(const uint64_t seed, FrameRow* frames, uint8_t* ram);
+    StepResult step(const uint16_t actionMask, const int frameCount, 
+        FrameRow* frames, uint8_t* ram);
+
+    const Interpreter& getInterpreter() const;
+private:
+    void applyActions(const uint16_t actionMask);
+    void pushFrame(const Frame& observedFrame);
+    void writeObservation(FrameRow* frames, uint8_t* ram) const;
+
+    EnvironmentConfig config;
+    Interpreter interpreter;
+    std::vector<uint8_t> rom;
+    // Ring of the most recently observed frames, with newestFrame indexing 
+    // the latest one
+    std::vector<Frame> frameHistory;
+    int newestFrame;
+    int elapsedFrames;
+    StepResult lastResult;
+};
+
+}
\ No newline at end of file
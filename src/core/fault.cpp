@@ -0,0 +1,39 @@
+#include <iomanip>
+#include <sstream>
+
+#include "core/fault.hpp"
+
+using namespace OCTACHIP;
+
+/**
+ * Returns a human-readable description of the fault, including the address 
+ * and opcode of the instruction that caused it.
+ */
+std::string OCTACHIP::describeFault(const Fault& fault) {
+    std::stringstream stream;
+    stream << std::uppercase << std::hex << std::setfill('0');
+    switch (fault.kind) {
+        case FaultKind::NONE:
+            return "No fault";
+        case FaultKind::ILLEGAL_OPCODE:
+            stream << "Illegal opcode";
+            break;
+        case FaultKind::STACK_UNDERFLOW:
+            stream << "Attempted to return from a subroutine, but the stack is "
+                "empty";
+            break;
+        case FaultKind::STACK_OVERFLOW:
+            stream << "Stack overflow";
+            break;
+        case FaultKind::MEMORY_OUT_OF_BOUNDS:
+            stream << "Out-of-bounds memory access";
+            break;
+        case FaultKind::PC_OUT_OF_BOUNDS:
+            stream << "Program counter out of bounds: 0x" << std::setw(4) 
+                << fault.pc;
+            return stream.str();
+    }
+    stream << " (opcode 0x" << std::setw(4) << fault.opcode << " at 0x" 
+        << std::setw(4) << fault.pc << ")";
+    return stream.str();
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace OCTACHIP {
+
+enum class FaultKind : uint8_t {
+    NONE,
+    ILLEGAL_OPCODE,
+    STACK_UNDERFLOW,
+    STACK_OVERFLOW,
+    MEMORY_OUT_OF_BOUNDS,
+    PC_OUT_OF_BOUNDS
+};
+
+// Records the instruction that stopped the interpreter. Faulting instructions 
+// have no effect, and the interpreter stays halted on them until it is reset 
+// or a new ROM is loaded.
+struct Fault {
+    FaultKind kind{FaultKind::NONE};
+    uint16_t pc{};
+    uint16_t opcode{};
+};
+
+std::string describeFault(const Fault& fault);
+
+}
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include <array>
+
+#include "core/input_movie.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+constexpr std::array<uint8_t, 4> MOVIE_MAGIC = {'O', 'C', '8', 'M'};
+constexpr uint8_t PRESSED_FLAG = 0x10;
+
+class MovieWriter {
+public:
+    explicit MovieWriter(std::vector<uint8_t>& target) : 
+        bytes{target} {}
+
+    template <typename Value>
+    void write(const Value value) {
+        for (size_t byte = 0; byte < sizeof(Value); byte++) {
+            bytes.push_back(static_cast<uint8_t>(value >> byte * 8));
+        }
+    }
+
+    // Event stamps are stored as the difference from the previous event, 7 
+    // bits at a time, so most of them take a single byte
+    void writeVarint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+private:
+    std::vector<uint8_t>& bytes;
+};
+
+class MovieReader {
+public:
+    MovieReader(const uint8_t* data, const size_t size) : 
+        position{data}, 
+        end{data + size} {}
+
+    template <typename Value>
+    bool read(Value& value) {
+        if (static_cast<size_t>(end - position) < sizeof(Value)) {
+            return false;
+        }
+        value = 0;
+        for (size_t byte = 0; byte < sizeof(Value); byte++) {
+            value |= static_cast<Value>(
+                static_cast<Value>(*position++) << byte * 8);
+        }
+        return true;
+    }
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position == end) {
+                return false;
+            }
+            const uint8_t byte = *position++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isAtEnd() const {
+        return position == end;
+    }
+private:
+    const uint8_t* position;
+    const uint8_t* end;
+};
+
+}
+
+// 64-bit FNV-1a hash, which identifies the ROM a movie was recorded with
+uint64_t OCTACHIP::hashBytes(const uint8_t* data, const size_t size) {
+    constexpr uint64_t OFFSET_BASIS = 0xCBF29CE484222325;
+    constexpr uint64_t PRIME = 0x100000001B3;
+
+    uint64_t hash = OFFSET_BASIS;
+    for (size_t index = 0; index < size; index++) {
+        hash ^= data[index];
+        hash *= PRIME;
+    }
+    return hash;
+}
+
+uint64_t OCTACHIP::hashState(const Interpreter& interpreter) {
+    std::array<uint8_t, Interpreter::STATE_SIZE> state;
+    interpreter.saveState(state.data(), state.size());
+    return hashBytes(state.data(), state.size());
+}
+
+/**
+ * Serializes a movie. Multi-byte header fields are stored little-endian, and 
+ * events as varint deltas from the event before them, followed by the key 
+ * number with the pressed flag in bit 4.
+ */
+std::vector<uint8_t> OCTACHIP::encodeMovie(const InputMovie& movie) {
+    std::vector<uint8_t> bytes;
+    MovieWriter writer{bytes};
+    for (const uint8_t byte : MOVIE_MAGIC) {
+        writer.write(byte);
+    }
+    writer.write(InputMovie::VERSION);
+    writer.write(movie.romHash);
+    writer.write(movie.seed);
+    writer.write(static_cast<uint32_t>(movie.instructionsPerFrame));
+    writer.write(static_cast<uint8_t>(movie.loadStoreQuirk << 2 | 
+        movie.shiftQuirk << 1 | movie.wrapQuirk));
+    writer.write(movie.frameCount);
+    writer.write(movie.finalStateHash);
+    writer.write(static_cast<uint32_t>(movie.events.size()));
+
+    uint64_t frame = 0;
+    uint64_t instructionCount = 0;
+    for (const InputEvent& event : movie.events) {
+        writer.writeVarint(event.frame - frame);
+        writer.writeVarint(event.instructionCount - instructionCount);
+        writer.write(static_cast<uint8_t>(
+            event.key | (event.isPressed ? PRESSED_FLAG : 0)));
+        frame = event.frame;
+        instructionCount = event.instructionCount;
+    }
+    return bytes;
+}
+
+/**
+ * Parses a movie written by encodeMovie(). Returns a description of the 
+ * error if the data is not a valid movie, leaving the given movie unchanged.
+ */
+std::optional<std::string> OCTACHIP::decodeMovie(const uint8_t* data, 
+    const size_t size, InputMovie& movie) {
+    MovieReader reader{data, size};
+    for (const uint8_t expected : MOVIE_MAGIC) {
+        uint8_t byte = 0;
+        if (!reader.read(byte) || byte != expected) {
+            return "Not an input movie";
+        }
+    }
+
+    uint16_t version = 0;
+    if (!reader.read(version) || version != InputMovie::VERSION) {
+        return "Unsupported input movie version";
+    }
+
+    InputMovie decoded{};
+    uint32_t instructionsPerFrame = 0;
+    uint8_t quirks = 0;
+    uint32_t eventCount = 0;
+    if (!reader.read(decoded.romHash) || !reader.read(decoded.seed) || 
+        !reader.read(instructionsPerFrame) || !reader.read(quirks) || 
+        !reader.read(decoded.frameCount) || 
+        !reader.read(decoded.finalStateHash) || !reader.read(eventCount)) {
+        return "Input movie is truncated";
+    }
+    if (instructionsPerFrame == 0 || instructionsPerFrame > INT32_MAX || 
+        quirks > 0x7) {
+        return "Input movie has an invalid header";
+    }
+    decoded.instructionsPerFrame = static_cast<int>(instructionsPerFrame);
+    decoded.loadStoreQuirk = quirks & 0x4;
+    decoded.shiftQuirk = quirks & 0x2;
+    decoded.wrapQuirk = quirks & 0x1;
+
+    uint64_t frame = 0;
+    uint64_t instructionCount = 0;
+    for (uint32_t index = 0; index < eventCount; index++) {
+        uint64_t frameDelta = 0;
+        uint64_t instructionDelta = 0;
+        uint8_t key = 0;
+        if (!reader.readVarint(frameDelta) || 
+            !reader.readVarint(instructionDelta) || !reader.read(key)) {
+            return "Input movie is truncated";
+        }
+        frame += frameDelta;
+        instructionCount += instructionDelta;
+        // Events after the last frame would never be replayed
+        if (frame >= decoded.frameCount || (key & ~PRESSED_FLAG) >= KEY_COUNT) {
+            return "Input movie has an invalid event";
+        }
+        decoded.events.push_back({frame, instructionCount, 
+            static_cast<uint8_t>(key & ~PRESSED_FLAG), 
+            (key & PRESSED_FLAG) != 0});
+    }
+    if (!reader.isAtEnd()) {
+        return "Input movie has trailing data";
+    }
+
+    movie = std::move(decoded);
+    return std::nullopt;
+}
+
+/**
+ * Resets the interpreter to the start of a movie, with the quirks and random 
+ * seed it was recorded with, and loads the ROM. Returns a description of the 
+ * error if the ROM is not the one the movie was recorded with.
+ */
+std::optional<std::string> OCTACHIP::startMovie(Interpreter& interpreter, 
+    const InputMovie& movie, const uint8_t* romData, const size_t romSize) {
+    if (hashBytes(romData, romSize) != movie.romHash) {
+        return "ROM does not match the input movie";
+    }
+
+    interpreter.reset();
+    interpreter.setLoadStoreQuirk(movie.loadStoreQuirk);
+    interpreter.setShiftQuirk(movie.shiftQuirk);
+    interpreter.setWrapQuirk(movie.wrapQuirk);
+    interpreter.seedRandom(movie.seed);
+    return interpreter.loadRom(romData, romSize);
+}
+
+MovieRecorder::MovieRecorder(Interpreter& target, const uint64_t seed, 
+    const int instructionsPerFrame) : 
+    interpreter{target}, 
+    movie{}, 
+    keypad{} {
+    movie.seed = seed;
+    movie.instructionsPerFrame = instructionsPerFrame > 0 ?
+        instructionsPerFrame : 1;
+}
+
+// Quirk settings take effect when recording starts
+void MovieRecorder::setLoadStoreQuirk(const bool isEnabled) {
+    movie.loadStoreQuirk = isEnabled;
+}
+
+void MovieRecorder::setShiftQuirk(const bool isEnabled) {
+    movie.shiftQuirk = isEnabled;
+}
+
+void MovieRecorder::setWrapQuirk(const bool isEnabled) {
+    movie.wrapQuirk = isEnabled;
+}
+
+/**
+ * Starts recording from the beginning of the ROM, with the quirks the movie 
+ * was set up with.
+ */
+std::optional<std::string> MovieRecorder::start(const uint8_t* romData, 
+    const size_t romSize) {
+    movie.romHash = hashBytes(romData, romSize);
+    movie.frameCount = 0;
+    movie.finalStateHash = 0;
+    movie.events.clear();
+    keypad.fill(false);
+    return startMovie(interpreter, movie, romData, romSize);
+}
+
+// Key repeats and keys outside the keypad are left out of the movie
+void MovieRecorder::setKey(const int key, const bool isPressed) {
+    if (key < 0 || key >= KEY_COUNT || keypad[key] == isPressed) {
+        return;
+    }
+    keypad[key] = isPressed;
+    movie.events.push_back({movie.frameCount, 
+        interpreter.getExecutedInstructionCount(), static_cast<uint8_t>(key), 
+        isPressed});
+    interpreter.setKey(key, isPressed);
+}
+
+// The timers are left alone on the frame a fault happens, as every host does
+const Fault& MovieRecorder::runFrame() {
+    const Fault& fault = interpreter.run(movie.instructionsPerFrame);
+    if (fault.kind == FaultKind::NONE) {
+        interpreter.updateTimers();
+    }
+    movie.frameCount++;
+    return fault;
+}
+
+// Stamps the movie with the state it ended in, for replays to check against
+const InputMovie& MovieRecorder::finish() {
+    movie.finalStateHash = hashState(interpreter);
+    return movie;
+}
+
+MoviePlayer::MoviePlayer(Interpreter& target, const InputMovie& source) : 
+    interpreter{target}, 
+    movie{source}, 
+    nextEvent{0}, 
+    frame{0}, 
+    desynchronized{false} {}
+
+std::optional<std::string> MoviePlayer::start(const uint8_t* romData, 
+    const size_t romSize) {
+    nextEvent = 0;
+    frame = 0;
+    desynchronized = false;
+    return startMovie(interpreter, movie, romData, romSize);
+}
+
+/**
+ * Applies the key changes recorded before the next frame and runs it. Does 
+ * nothing once every frame of the movie has been played.
+ */
+const Fault& MoviePlayer::runFrame() {
+    if (isFinished()) {
+        return interpreter.getFault();
+    }
+
+    while (nextEvent < movie.events.size() && 
+        movie.events[nextEvent].frame == frame) {
+        const InputEvent& event = movie.events[nextEvent++];
+        if (event.instructionCount != 
+            interpreter.getExecutedInstructionCount()) {
+            desynchronized = true;
+        }
+        interpreter.setKey(event.key, event.isPressed);
+    }
+
+    const Fault& fault = interpreter.run(movie.instructionsPerFrame);
+    if (fault.kind == FaultKind::NONE) {
+        interpreter.updateTimers();
+    }
+    frame++;
+    return fault;
+}
+
+bool MoviePlayer::isFinished() const {
+    return frame >= movie.frameCount;
+}
+
+bool MoviePlayer::isDesynchronized() const {
+    return desynchronized;
+}
+
+// Whether the whole movie has been played and ended in the recorded state
+bool MoviePlayer::matchesRecording() const {
+    return isFinished() && !desynchronized && 
+        hashState(interpreter) == movie.finalStateHash;
+}
+
+uint64_t MoviePlayer::getFrame() const {
+    return frame;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/fault.hpp"
+#include "core/interpreter.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+// A key press or release, stamped with the frame it happened before and the 
+// number of instructions executed by then
+struct InputEvent {
+    uint64_t frame{};
+    uint64_t instructionCount{};
+    uint8_t key{};
+    bool isPressed{};
+};
+
+/**
+ * Everything needed to repeat a run exactly: the ROM it was recorded with, 
+ * identified by its hash, the quirks and random seed it started from, and 
+ * every change of the keypad. Each frame runs instructionsPerFrame 
+ * instructions and then updates the timers, so the run depends on nothing 
+ * else.
+ */
+struct InputMovie {
+    static constexpr uint16_t VERSION = 1;
+
+    uint64_t romHash{};
+    uint64_t seed{};
+    int instructionsPerFrame{};
+    bool loadStoreQuirk{true};
+    bool shiftQuirk{true};
+    bool wrapQuirk{false};
+    uint64_t frameCount{};
+    // Hash of the save state after the last frame, which a replay has to 
+    // reproduce
+    uint64_t finalStateHash{};
+    std::vector<InputEvent> events;
+};
+
+uint64_t hashBytes(const uint8_t* data, const size_t size);
+uint64_t hashState(const Interpreter& interpreter);
+std::vector<uint8_t> encodeMovie(const InputMovie& movie);
+std::optional<std::string> decodeMovie(const uint8_t* data, const size_t size, 
+    InputMovie& movie);
+std::optional<std::string> startMovie(Interpreter& interpreter, 
+    const InputMovie& movie, const uint8_t* romData, const size_t romSize);
+
+/**
+ * Runs an interpreter one frame at a time, recording every key change in a 
+ * movie. Keys are only changed between frames, so that the frame and 
+ * instruction count of each event agree on where it happened.
+ */
+class MovieRecorder {
+public:
+    MovieRecorder(Interpreter& target, const uint64_t seed, 
+        const int instructionsPerFrame);
+
+    void setLoadStoreQuirk(const bool isEnabled);
+    void setShiftQuirk(const bool isEnabled);
+    void setWrapQuirk(const bool isEnabled);
+    std::optional<std::string> start(const uint8_t* romData, 
+        const size_t romSize);
+    void setKey(const int key, const bool isPressed);
+    const Fault& runFrame();
+    const InputMovie& finish();
+private:
+    Interpreter& interpreter;
+    InputMovie movie;
+    Keypad keypad;
+};
+
+/**
+ * Replays a movie headless, applying each key change at the instruction 
+ * boundary it was recorded at. The movie has to outlive the player.
+ */
+class MoviePlayer {
+public:
+    MoviePlayer(Interpreter& target, const InputMovie& source);
+
+    std::optional<std::string> start(const uint8_t* romData, 
+        const size_t romSize);
+    const Fault& runFrame();
+
+    bool isFinished() const;
+    bool isDesynchronized() const;
+    bool matchesRecording() const;
+    uint64_t getFrame() const;
+private:
+    Interpreter& interpreter;
+    const InputMovie& movie;
+    size_t nextEvent;
+    uint64_t frame;
+    // Set when an event comes up at a different instruction count than it 
+    // was recorded at
+    bool desynchronized;
+};
+
+}
\ No newline at end of file
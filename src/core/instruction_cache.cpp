@@ -0,0 +1,140 @@
+#include <algorithm>
+
+#include "core/instruction_cache.hpp"
+
+using namespace OCTACHIP;
+
+Operation OCTACHIP::decode(const Opcode& opcode) {
+    switch (opcode.prefix()) {
+        case 0x0:
+            switch (opcode.byte()) {
+                case 0xE0: return Operation::CLS;
+                case 0xEE: return Operation::RET;
+                default: return Operation::ILLEGAL_OPCODE;
+            }
+        case 0x1: return Operation::JP_ADDR;
+        case 0x2: return Operation::CALL_ADDR;
+        case 0x3: return Operation::SE_VX_BYTE;
+        case 0x4: return Operation::SNE_VX_BYTE;
+        case 0x5: return Operation::SE_VX_VY;
+        case 0x6: return Operation::LD_VX_BYTE;
+        case 0x7: return Operation::ADD_VX_BYTE;
+        case 0x8:
+            switch (opcode.nibble()) {
+                case 0x0: return Operation::LD_VX_VY;
+                case 0x1: return Operation::OR_VX_VY;
+                case 0x2: return Operation::AND_VX_VY;
+                case 0x3: return Operation::XOR_VX_VY;
+                case 0x4: return Operation::ADD_VX_VY;
+                case 0x5: return Operation::SUB_VX_VY;
+                case 0x6: return Operation::SHR_VX_VY;
+                case 0x7: return Operation::SUBN_VX_VY;
+                case 0xE: return Operation::SHL_VX_VY;
+                default: return Operation::ILLEGAL_OPCODE;
+            }
+        case 0x9: return Operation::SNE_VX_VY;
+        case 0xA: return Operation::LD_I_ADDR;
+        case 0xB: return Operation::JP_V0_ADDR;
+        case 0xC: return Operation::RND_VX_BYTE;
+        case 0xD: return Operation::DRW_VX_VY_NIBBLE;
+        case 0xE:
+            switch (opcode.byte()) {
+                case 0x9E: return Operation::SKP_VX;
+                case 0xA1: return Operation::SKNP_VX;
+                default: return Operation::ILLEGAL_OPCODE;
+            }
+        case 0xF:
+            switch (opcode.byte()) {
+                case 0x07: return Operation::LD_VX_DT;
+                case 0x0A: return Operation::LD_VX_K;
+                case 0x15: return Operation::LD_DT_VX;
+                case 0x18: return Operation::LD_ST_VX;
+                case 0x1E: return Operation::ADD_I_VX;
+                case 0x29: return Operation::LD_F_VX;
+                case 0x33: return Operation::LD_B_VX;
+                case 0x55: return Operation::LD_I_VX;
+                case 0x65: return Operation::LD_VX_I;
+                default: return Operation::ILLEGAL_OPCODE;
+            }
+        default: return Operation::ILLEGAL_OPCODE;
+    }
+}
+
+bool OCTACHIP::isBlockTerminator(const Operation operation) {
+    switch (operation) {
+        case Operation::RET:
+        case Operation::JP_ADDR:
+        case Operation::CALL_ADDR:
+        case Operation::SE_VX_BYTE:
+        case Operation::SNE_VX_BYTE:
+        case Operation::SE_VX_VY:
+        case Operation::SNE_VX_VY:
+        case Operation::JP_V0_ADDR:
+        case Operation::DRW_VX_VY_NIBBLE:
+        case Operation::SKP_VX:
+        case Operation::SKNP_VX:
+        case Operation::LD_VX_K:
+        // Stores can overwrite the block that is being executed
+        case Operation::LD_B_VX:
+        case Operation::LD_I_VX:
+        case Operation::ILLEGAL_OPCODE:
+        case Operation::PC_OUT_OF_BOUNDS:
+        case Operation::SE_VX_BYTE_JP:
+        case Operation::SNE_VX_BYTE_JP:
+        case Operation::SE_VX_VY_JP:
+        case Operation::SNE_VX_VY_JP:
+        case Operation::SKP_VX_JP:
+        case Operation::SKNP_VX_JP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+InstructionCache::InstructionCache() : entries{} {
+    clear();
+}
+
+/**
+ * Returns the predecoded instruction at the given address, decoding it from 
+ * memory first if the entry is empty.
+ */
+const DecodedInstruction& InstructionCache::fetch(const Memory& memory, 
+    const uint16_t address) {
+    DecodedInstruction& entry = entries[address];
+    if (entry.operation == Operation::UNDECODED) {
+        const Opcode opcode = memory[address] << 8 | memory[address + 1];
+        entry.operation = decode(opcode);
+        entry.opcode = opcode;
+    }
+    return entry;
+}
+
+/**
+ * Discards every entry whose two instruction bytes overlap the written range 
+ * [address, address + length). An instruction starting one byte before the 
+ * range is included, since its second byte falls inside it.
+ */
+void InstructionCache::invalidate(const int address, const int length) {
+    const int first = std::max(address - 1, 0);
+    const int last = std::min(address + length, MEMORY_SIZE - 1);
+    for (int i = first; i < last; i++) {
+        entries[i].operation = Operation::UNDECODED;
+    }
+}
+
+/**
+ * Returns the entry at the given address without decoding it. The entry is 
+ * UNDECODED if it has not been fetched since it was last invalidated.
+ */
+const DecodedInstruction& InstructionCache::operator[](
+    const uint16_t address) const {
+    return entries[address];
+}
+
+void InstructionCache::clear() {
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        entries[i].operation = i < MEMORY_SIZE - 1 ? Operation::UNDECODED : 
+            Operation::PC_OUT_OF_BOUNDS;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "core/opcode.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+enum class Operation : uint8_t {
+    UNDECODED,
+    CLS,
+    RET,
+    JP_ADDR,
+    CALL_ADDR,
+    SE_VX_BYTE,
+    SNE_VX_BYTE,
+    SE_VX_VY,
+    LD_VX_BYTE,
+    ADD_VX_BYTE,
+    LD_VX_VY,
+    OR_VX_VY,
+    AND_VX_VY,
+    XOR_VX_VY,
+    ADD_VX_VY,
+    SUB_VX_VY,
+    SHR_VX_VY,
+    SUBN_VX_VY,
+    SHL_VX_VY,
+    SNE_VX_VY,
+    LD_I_ADDR,
+    JP_V0_ADDR,
+    RND_VX_BYTE,
+    DRW_VX_VY_NIBBLE,
+    SKP_VX,
+    SKNP_VX,
+    LD_VX_DT,
+    LD_VX_K,
+    LD_DT_VX,
+    LD_ST_VX,
+    ADD_I_VX,
+    LD_F_VX,
+    LD_B_VX,
+    LD_I_VX,
+    LD_VX_I,
+    ILLEGAL_OPCODE,
+    PC_OUT_OF_BOUNDS,
+    // Micro-ops that are only produced by the block translator
+    LD_VX_BYTE_PAIR,
+    ADD_VX_VY_NO_FLAG,
+    SUB_VX_VY_NO_FLAG,
+    SHR_VX_VY_NO_FLAG,
+    SUBN_VX_VY_NO_FLAG,
+    SHL_VX_VY_NO_FLAG,
+    SE_VX_BYTE_JP,
+    SNE_VX_BYTE_JP,
+    SE_VX_VY_JP,
+    SNE_VX_VY_JP,
+    SKP_VX_JP,
+    SKNP_VX_JP
+};
+
+struct DecodedInstruction {
+    Operation operation{Operation::UNDECODED};
+    Opcode opcode{0x0000};
+};
+
+// Resolves an opcode to the instruction that handles it.
+Operation decode(const Opcode& opcode);
+
+// Returns whether an operation ends a basic block, either because it can 
+// transfer control somewhere other than the next instruction, or because it 
+// needs the host to observe its effects before execution continues.
+bool isBlockTerminator(const Operation operation);
+
+class InstructionCache {
+public:
+    // Bnnn can jump as far as 0xFFF + 0xFF, so the cache extends past the end 
+    // of memory. Every address whose instruction would be fetched from outside 
+    // memory holds a PC_OUT_OF_BOUNDS entry, which lets the program counter be 
+    // used as an index without a separate bounds check.
+    static constexpr int ENTRY_COUNT = MEMORY_SIZE + 0x100;
+
+    InstructionCache();
+
+    const DecodedInstruction& fetch(const Memory& memory, 
+        const uint16_t address);
+    void invalidate(const int address, const int length);
+    void clear();
+
+    const DecodedInstruction& operator[](const uint16_t address) const;
+private:
+    std::array<DecodedInstruction, ENTRY_COUNT> entries;
+};
+
+}
\ No newline at end of file
@@ -1,6 +1,3 @@
-#include <stdexcept>
-#include <string>
-
 #include "core/instructions.hpp"
 #include "core/interpreter.hpp"
 
@@ -9,8 +6,15 @@ using namespace OCTACHIP;
 /**
  * 00E0 - Clear the display.
  */
-void instructions::CLS(Frame& frame) {
-    frame.fill(false);
+void instructions::CLS(Frame& frame, FrameChanges& changes) {
+    FrameRowMask dirtyRows = 0;
+    for (int row = 0; row < FRAME_HEIGHT; row++) {
+        dirtyRows |= FrameRowMask{frame[row] != 0} << row;
+    }
+    frame.fill(0);
+
+    changes.dirtyRows |= dirtyRows;
+    changes.generation += dirtyRows != 0;
 }
 
 /**
@@ -19,12 +23,12 @@ void instructions::CLS(Frame& frame) {
  * The interpreter sets the program counter to the address at the top of the 
  * stack, then subtracts 1 from the stack pointer.
  */
-void instructions::RET(Registers& registers, const Stack& stack) {
+FaultKind instructions::RET(Registers& registers, const Stack& stack) {
     if (registers.sp <= 0) {
-        throw std::underflow_error("RET: attempted to return from a subroutine,"
-            " but the stack is empty");
+        return FaultKind::STACK_UNDERFLOW;
     }
     registers.pc = stack[--registers.sp];
+    return FaultKind::NONE;
 }
 
 /**
@@ -42,13 +46,14 @@ void instructions::JP_ADDR(const Opcode& opcode, Registers& registers) {
  * The interpreter increments the stack pointer, then puts the current PC on 
  * the top of the stack. The PC is then set to nnn.
  */
-void instructions::CALL_ADDR(const Opcode& opcode, Registers& registers, 
+FaultKind instructions::CALL_ADDR(const Opcode& opcode, Registers& registers, 
     Stack& stack) {
     if (registers.sp >= STACK_SIZE) {
-        throw std::overflow_error("CALL_ADDR: stack overflow error");
+        return FaultKind::STACK_OVERFLOW;
     }
     stack[registers.sp++] = registers.pc;
     registers.pc = opcode.address();
+    return FaultKind::NONE;
 }
 
 /**
@@ -183,14 +188,16 @@ void instructions::SUB_VX_VY(const Opcode& opcode, Registers& registers) {
  * 
  * TODO: Implement configurable quirks for this instruction
  */
-void instructions::SHR_VX_VY(const Opcode& opcode, Registers& registers, 
-    const bool shiftQuirk) {
-    if (!shiftQuirk) {
+template <bool shiftQuirk>
+void instructions::SHR_VX_VY(const Opcode& opcode, Registers& registers) {
+    if constexpr (!shiftQuirk) {
         registers.v[opcode.x()] = registers.v[opcode.y()];
     }
     registers.v[0xF] = registers.v[opcode.x()] & 0x01;
     registers.v[opcode.x()] >>= 1;
 }
+template void instructions::SHR_VX_VY<false>(const Opcode&, Registers&);
+template void instructions::SHR_VX_VY<true>(const Opcode&, Registers&);
 
 /**
  * 8xy7 - Set Vx = Vy - Vx, set VF = NOT borrow.
@@ -212,14 +219,16 @@ void instructions::SUBN_VX_VY(const Opcode& opcode, Registers& registers) {
  * 
  * TODO: Implement configurable quirks for this instruction
  */
-void instructions::SHL_VX_VY(const Opcode& opcode, Registers& registers, 
-    const bool shiftQuirk) {
-    if (!shiftQuirk) {
+template <bool shiftQuirk>
+void instructions::SHL_VX_VY(const Opcode& opcode, Registers& registers) {
+    if constexpr (!shiftQuirk) {
         registers.v[opcode.x()] = registers.v[opcode.y()];
     }
     registers.v[0xF] = registers.v[opcode.x()] >> 7;
     registers.v[opcode.x()] <<= 1;
 }
+template void instructions::SHL_VX_VY<false>(const Opcode&, Registers&);
+template void instructions::SHL_VX_VY<true>(const Opcode&, Registers&);
 
 /**
  * 9xy0 - Skip next instruction if Vx != Vy.
@@ -253,17 +262,6 @@ void instructions::JP_V0_ADDR(const Opcode& opcode, Registers& registers) {
     registers.pc = opcode.address() + registers.v[0x0];
 }
 
-/**
- * Cxkk - Set Vx = random byte AND kk.
- * 
- * The interpreter generates a random number from 0 to 255, which is then ANDed 
- * with the value kk. The results are stored in Vx.
- */
-void instructions::RND_VX_BYTE(const Opcode& opcode, Registers& registers, 
-    Random& random) {
-    registers.v[opcode.x()] = random.generateNumber() & opcode.byte();
-}
-
 /**
  * Dxyn - Display n-byte sprite starting at memory location I at (Vx, Vy), set 
  *        VF = collision.
@@ -275,50 +273,66 @@ void instructions::RND_VX_BYTE(const Opcode& opcode, Registers& registers,
  * is positioned so part of it is outside the coordinates of the display, it 
  * wraps around to the opposite side of the screen.
  */
-void instructions::DRW_VX_VY_NIBBLE(const Opcode& opcode, const Memory& memory, 
-    Registers& registers, Frame& frame, const bool wrapQuirk) {
+template <bool wrapQuirk>
+FaultKind instructions::DRW_VX_VY_NIBBLE(const Opcode& opcode, 
+    const Memory& memory, Registers& registers, Frame& frame, 
+    FrameChanges& changes) {
     const int xPos = registers.v[opcode.x()] % FRAME_WIDTH;
     const int yPos = registers.v[opcode.y()] % FRAME_HEIGHT;
     const int height = opcode.nibble();
 
-    registers.v[0xF] = 0;
+    if (registers.i + height > MEMORY_SIZE) {
+        return FaultKind::MEMORY_OUT_OF_BOUNDS;
+    }
+
+    // Each sprite row is aligned to the left edge of a frame row, then moved 
+    // into place in one step: rotated so the pixels past the right edge wrap 
+    // around, or shifted so they fall off
+    constexpr int SPRITE_OFFSET = FRAME_WIDTH - 8;
+    FrameRow collisions = 0;
+    FrameRowMask dirtyRows = 0;
 
     for (int row = 0; row < height; row++) {
-        if (registers.i + row >= MEMORY_SIZE) {
-            throw std::out_of_range("DRW_VX_VY_NIBBLE: out-of-bounds memory "
-                "access");
+        int frameRow = yPos + row;
+        if constexpr (wrapQuirk) {
+            frameRow %= FRAME_HEIGHT;
+        } else if (frameRow >= FRAME_HEIGHT) {
+            break;
         }
 
-        const uint8_t spriteRow = memory[registers.i + row];
-
-        for (int col = 0; col < 8; col++) {
-            const int pixel = ((xPos + col) % FRAME_WIDTH) + ((yPos + row) % 
-                FRAME_HEIGHT) * FRAME_WIDTH;
-            if (!wrapQuirk) {
-                if (xPos + col >= FRAME_WIDTH || yPos + row >= FRAME_HEIGHT) {
-                    continue;
-                }
-            }
-            if (spriteRow & (0b10000000 >> col)) {
-                if (frame[pixel]) {
-                    registers.v[0xF] = 1;
-                }
-
-                frame[pixel] ^= true;
-            }
+        const FrameRow spriteRow = 
+            static_cast<FrameRow>(memory[registers.i + row]) << SPRITE_OFFSET;
+        FrameRow pixels = spriteRow >> xPos;
+        if constexpr (wrapQuirk) {
+            pixels |= spriteRow << ((FRAME_WIDTH - xPos) % FRAME_WIDTH);
         }
+
+        collisions |= frame[frameRow] & pixels;
+        frame[frameRow] ^= pixels;
+        dirtyRows |= FrameRowMask{pixels != 0} << frameRow;
     }
+
+    registers.v[0xF] = collisions != 0;
+    changes.dirtyRows |= dirtyRows;
+    changes.generation += dirtyRows != 0;
+    return FaultKind::NONE;
 }
+template FaultKind instructions::DRW_VX_VY_NIBBLE<false>(const Opcode&, 
+    const Memory&, Registers&, Frame&, FrameChanges&);
+template FaultKind instructions::DRW_VX_VY_NIBBLE<true>(const Opcode&, 
+    const Memory&, Registers&, Frame&, FrameChanges&);
 
 /**
  * Ex9E - Skip next instruction if key with the value of Vx is pressed.
  * 
  * Checks the keyboard, and if the key corresponding to the value of Vx is 
- * currently in the down position, PC is increased by 2.
+ * currently in the down position, PC is increased by 2. Values above 0xF name 
+ * no key, so they are never pressed.
  */
 void instructions::SKP_VX(const Opcode& opcode, Registers& registers, const 
     Keypad& keypad) {
-    const bool isPressed = keypad[registers.v[opcode.x()]];
+    const uint8_t key = registers.v[opcode.x()];
+    const bool isPressed = key < KEY_COUNT && keypad[key];
     if (isPressed) {
         registers.pc += 2;
     }
@@ -328,11 +342,13 @@ void instructions::SKP_VX(const Opcode& opcode, Registers& registers, const
  * ExA1 - Skip next instruction if key with the value of Vx is not pressed.
  * 
  * Checks the keyboard, and if the key corresponding to the value of Vx is 
- * currently in the up position, PC is increased by 2.
+ * currently in the up position, PC is increased by 2. Values above 0xF name 
+ * no key, so they are never pressed.
  */
 void instructions::SKNP_VX(const Opcode& opcode, Registers& registers, const 
     Keypad& keypad) {
-    const bool isPressed = keypad[registers.v[opcode.x()]];
+    const uint8_t key = registers.v[opcode.x()];
+    const bool isPressed = key < KEY_COUNT && keypad[key];
     if (!isPressed) {
         registers.pc += 2;
     }
@@ -351,23 +367,26 @@ void instructions::LD_VX_DT(const Opcode& opcode, Registers& registers) {
  * Fx0A - Wait for a key press, store the value of the key in Vx.
  * 
  * All execution stops until a key is pressed, then the value of that key is 
- * stored in Vx.
+ * stored in Vx. While no key has been released, the program counter is moved 
+ * back onto this instruction and true is returned, so the interpreter can 
+ * stay halted until the keypad changes.
  * 
  * TODO: Implement configurable quirks for this instruction
  */
-void instructions::LD_VX_K(const Opcode& opcode, Registers& registers, const 
+bool instructions::LD_VX_K(const Opcode& opcode, Registers& registers, const 
     Keypad& keypad, Keypad& prevKeypadState) {
     for (int keyValue = 0; keyValue < KEY_COUNT; keyValue++) {
         if (prevKeypadState[keyValue] && !keypad[keyValue]) {
             registers.v[opcode.x()] = static_cast<uint8_t>(keyValue);
             prevKeypadState[keyValue] = false;
-            return;
+            return false;
         }
         else if (!prevKeypadState[keyValue] && keypad[keyValue]) {
             prevKeypadState[keyValue] = true;
         }
     }
     registers.pc -= 2;
+    return true;
 }
 
 /**
@@ -418,16 +437,17 @@ void instructions::LD_F_VX(const Opcode& opcode, Registers& registers) {
  * in memory at location in I, the tens digit at location I+1, and the ones 
  * digit at location I+2.
  */
-void instructions::LD_B_VX(const Opcode& opcode, Memory& memory, 
+FaultKind instructions::LD_B_VX(const Opcode& opcode, Memory& memory, 
     const Registers& registers) {
+    if (registers.i + 2 >= MEMORY_SIZE) {
+        return FaultKind::MEMORY_OUT_OF_BOUNDS;
+    }
     uint8_t value = registers.v[opcode.x()];
     for (int i = 2; i >= 0; i--) {
-        if (registers.i + i >= MEMORY_SIZE) {
-            throw std::out_of_range("LD_B_VX: out-of-bounds memory access");
-        }
         memory[registers.i + i] = value % 10;
         value /= 10;
     }
+    return FaultKind::NONE;
 }
 
 /**
@@ -438,18 +458,24 @@ void instructions::LD_B_VX(const Opcode& opcode, Memory& memory,
  * 
  * TODO: Implement configurable quirks for this instruction
  */
-void instructions::LD_I_VX(const Opcode& opcode, Memory& memory, 
-    Registers& registers, const bool loadStoreQuirk) {
+template <bool loadStoreQuirk>
+FaultKind instructions::LD_I_VX(const Opcode& opcode, Memory& memory, 
+    Registers& registers) {
+    if (registers.i + opcode.x() >= MEMORY_SIZE) {
+        return FaultKind::MEMORY_OUT_OF_BOUNDS;
+    }
     for (int i = 0; i <= opcode.x(); i++) {
-        if (registers.i + i >= MEMORY_SIZE) {
-            throw std::out_of_range("LD_I_VX: out-of-bounds memory access");
-        }
         memory[registers.i + i] = registers.v[i];
     }
-    if (!loadStoreQuirk) {
+    if constexpr (!loadStoreQuirk) {
         registers.i = (registers.i + opcode.x() + 1) & 0xFFFF;
     }
+    return FaultKind::NONE;
 }
+template FaultKind instructions::LD_I_VX<false>(const Opcode&, Memory&, 
+    Registers&);
+template FaultKind instructions::LD_I_VX<true>(const Opcode&, Memory&, 
+    Registers&);
 
 /**
  * Fx65 - Read registers V0 through Vx from memory starting at location I.
@@ -457,23 +483,99 @@ void instructions::LD_I_VX(const Opcode& opcode, Memory& memory,
  * The interpreter reads values from memory starting at location I into 
  * registers V0 through Vx.
  */
-void instructions::LD_VX_I(const Opcode& opcode, const Memory& memory, 
-    Registers& registers, const bool loadStoreQuirk) {
+template <bool loadStoreQuirk>
+FaultKind instructions::LD_VX_I(const Opcode& opcode, const Memory& memory, 
+    Registers& registers) {
+    if (registers.i + opcode.x() >= MEMORY_SIZE) {
+        return FaultKind::MEMORY_OUT_OF_BOUNDS;
+    }
     for (int i = 0; i <= opcode.x(); i++) {
-        if (registers.i + i >= MEMORY_SIZE) {
-            throw std::out_of_range("LD_I_VX: out-of-bounds memory access");
-        }
         registers.v[i] = memory[registers.i + i];
     }
-    if (!loadStoreQuirk) {
+    if constexpr (!loadStoreQuirk) {
         registers.i = (registers.i + opcode.x() + 1) & 0xFFFF;
     }
+    return FaultKind::NONE;
 }
+template FaultKind instructions::LD_VX_I<false>(const Opcode&, 
+    const Memory&, Registers&);
+template FaultKind instructions::LD_VX_I<true>(const Opcode&, 
+    const Memory&, Registers&);
 
 /**
- * Illegal opcode - Throws exception when no matching instruction is found.
+ * Illegal opcode - Reports a fault when no matching instruction is found.
  */
-void instructions::ILLEGAL_OPCODE(const Opcode& opcode) {
-    throw std::runtime_error("Illegal opcode: " + 
-        std::to_string(opcode.full()));
-}
\ No newline at end of file
+FaultKind instructions::ILLEGAL_OPCODE(const Opcode&) {
+    return FaultKind::ILLEGAL_OPCODE;
+}
+
+/**
+ * 8xy4 - Set Vx = Vx + Vy, leave VF unchanged.
+ * 
+ * Same as ADD_VX_VY, for when the carry flag is overwritten before it is read.
+ */
+void instructions::ADD_VX_VY_NO_FLAG(const Opcode& opcode, 
+    Registers& registers) {
+    registers.v[opcode.x()] += registers.v[opcode.y()];
+}
+
+/**
+ * 8xy5 - Set Vx = Vx - Vy, leave VF unchanged.
+ * 
+ * Same as SUB_VX_VY, for when the borrow flag is overwritten before it is 
+ * read.
+ */
+void instructions::SUB_VX_VY_NO_FLAG(const Opcode& opcode, 
+    Registers& registers) {
+    registers.v[opcode.x()] -= registers.v[opcode.y()];
+}
+
+/**
+ * 8xy6 - Set Vx = Vx SHR 1, leave VF unchanged.
+ * 
+ * Same as SHR_VX_VY, for when the shifted-out bit is overwritten before it is 
+ * read.
+ */
+template <bool shiftQuirk>
+void instructions::SHR_VX_VY_NO_FLAG(const Opcode& opcode, 
+    Registers& registers) {
+    if constexpr (!shiftQuirk) {
+        registers.v[opcode.x()] = registers.v[opcode.y()];
+    }
+    registers.v[opcode.x()] >>= 1;
+}
+template void instructions::SHR_VX_VY_NO_FLAG<false>(const Opcode&, 
+    Registers&);
+template void instructions::SHR_VX_VY_NO_FLAG<true>(const Opcode&, 
+    Registers&);
+
+/**
+ * 8xy7 - Set Vx = Vy - Vx, leave VF unchanged.
+ * 
+ * Same as SUBN_VX_VY, for when the borrow flag is overwritten before it is 
+ * read.
+ */
+void instructions::SUBN_VX_VY_NO_FLAG(const Opcode& opcode, 
+    Registers& registers) {
+    registers.v[opcode.x()] = registers.v[opcode.y()] - registers.v[opcode.x()];
+}
+
+/**
+ * 8xyE - Set Vx = Vx SHL 1, leave VF unchanged.
+ * 
+ * Same as SHL_VX_VY, for when the shifted-out bit is overwritten before it is 
+ * read.
+ */
+template <bool shiftQuirk>
+void instructions::SHL_VX_VY_NO_FLAG(const Opcode& opcode, 
+    Registers& registers) {
+    if constexpr (!shiftQuirk) {
+        registers.v[opcode.x()] = registers.v[opcode.y()];
+    }
+    registers.v[opcode.x()] <<= 1;
+}
+
+template void instructions::SHL_VX_VY_NO_FLAG<false>(const Opcode&, 
+    Registers&);
+template void instructions::SHL_VX_VY_NO_FLAG<true>(const Opcode&, 
+    Registers&);
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 
+#include "core/fault.hpp"
 #include "core/opcode.hpp"
 #include "core/random.hpp"
 #include "core/types.hpp"
@@ -9,16 +10,16 @@
 namespace OCTACHIP::instructions {
 
 // 00E0 - Clear the display.
-void CLS(Frame& frame);
+void CLS(Frame& frame, FrameChanges& changes);
 
 // 00EE - Return from a subroutine.
-void RET(Registers& registers, const Stack& stack);
+FaultKind RET(Registers& registers, const Stack& stack);
 
 // 1nnn - Jump to location nnn.
 void JP_ADDR(const Opcode& opcode, Registers& registers);
 
 // 2nnn - Call subroutine at nnn.
-void CALL_ADDR(const Opcode& opcode, Registers& registers, Stack& stack);
+FaultKind CALL_ADDR(const Opcode& opcode, Registers& registers, Stack& stack);
 
 // 3xkk - Skip next instruction if Vx = kk.
 void SE_VX_BYTE(const Opcode& opcode, Registers& registers);
@@ -54,15 +55,15 @@ void ADD_VX_VY(const Opcode& opcode, Registers& registers);
 void SUB_VX_VY(const Opcode& opcode, Registers& registers);
 
 // 8xy6 - Set Vx = Vx SHR 1.
-void SHR_VX_VY(const Opcode& opcode, Registers& registers, 
-    const bool shiftQuirk=true);
+template <bool shiftQuirk=true>
+void SHR_VX_VY(const Opcode& opcode, Registers& registers);
 
 // 8xy7 - Set Vx = Vy - Vx, set VF = NOT borrow.
 void SUBN_VX_VY(const Opcode& opcode, Registers& registers);
 
 // 8xyE - Set Vx = Vx SHL 1.
-void SHL_VX_VY(const Opcode& opcode, Registers& registers, 
-    const bool shiftQuirk=true);
+template <bool shiftQuirk=true>
+void SHL_VX_VY(const Opcode& opcode, Registers& registers);
 
 // 9xy0 - Skip next instruction if Vx != Vy.
 void SNE_VX_VY(const Opcode& opcode, Registers& registers);
@@ -73,13 +74,20 @@ void LD_I_ADDR(const Opcode& opcode, Registers& registers);
 // Bnnn - Jump to location nnn + V0.
 void JP_V0_ADDR(const Opcode& opcode, Registers& registers);
 
-// Cxkk - Set Vx = random byte AND kk.
-void RND_VX_BYTE(const Opcode& opcode, Registers& registers, Random& random);
+// Cxkk - Set Vx = random byte AND kk. 
+// Defined here and templated on the generator, so that the call to it can be 
+// inlined and tests can substitute their own generator.
+template <typename Generator=Random>
+void RND_VX_BYTE(const Opcode& opcode, Registers& registers, 
+    Generator& random) {
+    registers.v[opcode.x()] = random.generateNumber() & opcode.byte();
+}
 
 // Dxyn - Display n-byte sprite starting at memory location I at (Vx, Vy), set 
 //        VF = collision.
-void DRW_VX_VY_NIBBLE(const Opcode& opcode, const Memory& memory, 
-    Registers& registers, Frame& frame, const bool wrapQuirk=false);
+template <bool wrapQuirk=false>
+FaultKind DRW_VX_VY_NIBBLE(const Opcode& opcode, const Memory& memory, 
+    Registers& registers, Frame& frame, FrameChanges& changes);
 
 // Ex9E - Skip next instruction if key with the value of Vx is pressed.
 void SKP_VX(const Opcode& opcode, Registers& registers, const Keypad& keypad);
@@ -91,7 +99,7 @@ void SKNP_VX(const Opcode& opcode, Registers& registers, const Keypad& keypad);
 void LD_VX_DT(const Opcode& opcode, Registers& registers);
 
 // Fx0A - Wait for a key press, store the value of the key in Vx.
-void LD_VX_K(const Opcode& opcode, Registers& registers, const Keypad& keypad, 
+bool LD_VX_K(const Opcode& opcode, Registers& registers, const Keypad& keypad, 
     Keypad& prevKeypadState);
 
 // Fx15 - Set delay timer = Vx.
@@ -107,17 +115,39 @@ void ADD_I_VX(const Opcode& opcode, Registers& registers);
 void LD_F_VX(const Opcode& opcode, Registers& registers);
 
 // Fx33 - Store BCD representation of Vx in memory locations I, I+1, and I+2.
-void LD_B_VX(const Opcode& opcode, Memory& memory, const Registers& registers);
+FaultKind LD_B_VX(const Opcode& opcode, Memory& memory, 
+    const Registers& registers);
 
 // Fx55 - Store registers V0 through Vx in memory starting at location I.
-void LD_I_VX(const Opcode& opcode, Memory& memory, Registers& registers, 
-    const bool loadStoreQuirk=true);
+template <bool loadStoreQuirk=true>
+FaultKind LD_I_VX(const Opcode& opcode, Memory& memory, Registers& registers);
 
 // Fx65 - Read registers V0 through Vx from memory starting at location I.
-void LD_VX_I(const Opcode& opcode, const Memory& memory, Registers& registers,
-    const bool loadStoreQuirk=true);
+template <bool loadStoreQuirk=true>
+FaultKind LD_VX_I(const Opcode& opcode, const Memory& memory, 
+    Registers& registers);
 
-// Illegal opcode - Throws exception when no matching instruction is found.
-void ILLEGAL_OPCODE(const Opcode& opcode);
+// Illegal opcode - Reports a fault when no matching instruction is found.
+FaultKind ILLEGAL_OPCODE(const Opcode& opcode);
+
+// The following variants are emitted by the block translator in place of the 
+// arithmetic instructions when their VF result is never observed.
+
+// 8xy4 - Set Vx = Vx + Vy, leave VF unchanged.
+void ADD_VX_VY_NO_FLAG(const Opcode& opcode, Registers& registers);
+
+// 8xy5 - Set Vx = Vx - Vy, leave VF unchanged.
+void SUB_VX_VY_NO_FLAG(const Opcode& opcode, Registers& registers);
+
+// 8xy6 - Set Vx = Vx SHR 1, leave VF unchanged.
+template <bool shiftQuirk=true>
+void SHR_VX_VY_NO_FLAG(const Opcode& opcode, Registers& registers);
+
+// 8xy7 - Set Vx = Vy - Vx, leave VF unchanged.
+void SUBN_VX_VY_NO_FLAG(const Opcode& opcode, Registers& registers);
+
+// 8xyE - Set Vx = Vx SHL 1, leave VF unchanged.
+template <bool shiftQuirk=true>
+void SHL_VX_VY_NO_FLAG(const Opcode& opcode, Registers& registers);
 
 }
\ No newline at end of file
@@ -1,51 +1,147 @@
 #include <algorithm>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
 #include <iterator>
-#include <random>
-#include <sstream>
-#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <vector>
 
+#include "core/block_cache.hpp"
+#include "core/disassembler.hpp"
+#include "core/fault.hpp"
+#include "core/instruction_cache.hpp"
 #include "core/instructions.hpp"
 #include "core/interpreter.hpp"
 #include "core/opcode.hpp"
+#include "core/quirks.hpp"
+
+// Direct-threaded dispatch relies on the labels-as-values extension, which is 
+// only available with GCC-compatible compilers. Emscripten and MSVC use the 
+// portable switch instead.
+#if defined(__GNUC__) && !defined(__EMSCRIPTEN__) && \
+    !defined(OCTACHIP_DISABLE_THREADED_DISPATCH)
+#define OCTACHIP_THREADED_DISPATCH
+#endif
 
 using namespace OCTACHIP;
 
-Interpreter::Interpreter() :
-    memory{},
-    registers{},
-    stack{},
-    frame{},
-    keypad{},
-    prevKeypadState{},
-    random{},
-    loadStoreQuirk{true},
-    shiftQuirk{true},
-    wrapQuirk{false} {
-    const std::array<uint8_t, FONT_SET_SIZE> fontSet = {
-        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
-        0x20, 0x60, 0x20, 0x20, 0x70, // 1
-        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
-        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
-        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
-        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
-        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
-        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
-        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
-        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
-        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
-        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
-        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
-        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
-        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
-        0xF0, 0x80, 0xF0, 0x80, 0x80  // F
-    };
-    std::copy(std::begin(fontSet), std::end(fontSet), std::begin(this->memory) + 
+namespace {
+
+constexpr std::array<uint8_t, 4> STATE_MAGIC = {'O', 'C', '8', 'S'};
+
+// Magic and version, memory, registers, stack, frame, keypads, quirks, random 
+// state, fault, key wait and instruction counts
+static_assert(Interpreter::STATE_SIZE == STATE_MAGIC.size() + 2 + 
+    MEMORY_SIZE + Registers::V_REG_COUNT + 7 + STACK_SIZE * 2 + 
+    FRAME_HEIGHT * sizeof(FrameRow) + 2 * 2 + 1 + 8 + 5 + 1 + 2 * 8);
+
+constexpr uint16_t ALL_PAGES = 0xFFFF;
+static_assert(Interpreter::PAGE_COUNT == 16);
+
+// The splitmix64 finalizer, which spreads every input bit over the output
+uint64_t mixHash(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EB;
+    value ^= value >> 31;
+    return value;
+}
+
+// Sequential little-endian access to a snapshot buffer. The buffer size is 
+// checked before either is constructed, so neither checks bounds.
+class StateWriter {
+public:
+    explicit StateWriter(uint8_t* buffer) : 
+        position{buffer} {}
+
+    template <typename Value>
+    void write(const Value value) {
+        for (size_t byte = 0; byte < sizeof(Value); byte++) {
+            *position++ = static_cast<uint8_t>(value >> byte * 8);
+        }
+    }
+
+    template <typename Value, size_t Size>
+    void write(const std::array<Value, Size>& values) {
+        for (const Value value : values) {
+            write(value);
+        }
+    }
+private:
+    uint8_t* position;
+};
+
+class StateReader {
+public:
+    explicit StateReader(const uint8_t* buffer) : 
+        position{buffer} {}
+
+    template <typename Value>
+    void read(Value& value) {
+        value = 0;
+        for (size_t byte = 0; byte < sizeof(Value); byte++) {
+            value |= static_cast<Value>(static_cast<Value>(*position++) << 
+                byte * 8);
+        }
+    }
+
+    template <typename Value, size_t Size>
+    void read(std::array<Value, Size>& values) {
+        for (Value& value : values) {
+            read(value);
+        }
+    }
+private:
+    const uint8_t* position;
+};
+
+uint16_t packKeypad(const Keypad& keypad) {
+    uint16_t keys = 0;
+    for (int key = 0; key < KEY_COUNT; key++) {
+        keys |= static_cast<uint16_t>(keypad[key]) << key;
+    }
+    return keys;
+}
+
+Keypad unpackKeypad(const uint16_t keys) {
+    Keypad keypad{};
+    for (int key = 0; key < KEY_COUNT; key++) {
+        keypad[key] = (keys >> key & 1) != 0;
+    }
+    return keypad;
+}
+
+}
+
+Interpreter::Interpreter() : 
+    memory{}, 
+    registers{}, 
+    stack{}, 
+    frame{}, 
+    frameChanges{ALL_FRAME_ROWS, 0}, 
+    keypad{}, 
+    prevKeypadState{}, 
+    random{}, 
+    instructionCache{}, 
+    blockCache{}, 
+    disassemblyCache{}, 
+    loadStoreQuirk{true}, 
+    shiftQuirk{true}, 
+    wrapQuirk{false}, 
+    dispatch{}, 
+    fault{}, 
+    waitingForKey{false}, 
+    executedInstructionCount{}, 
+    skippedInstructionCount{}, 
+    pages{}, 
+    storedPages{ALL_PAGES}, 
+    memoryHash{} {
+    std::copy(std::begin(FONT_SET), std::end(FONT_SET), std::begin(memory) + 
         FONT_START_ADDRESS);
+    memoryHash = hashMemory(0, MEMORY_SIZE);
     registers.pc = PROG_START_ADDRESS;
+    selectQuirks();
 }
 
 void Interpreter::reset() {
@@ -62,42 +158,91 @@ void Interpreter::reset() {
     registers.soundTimer = 0;
 
     stack.fill(0);
-    frame.fill(false);
+    frame.fill(0);
+    frameChanges.dirtyRows = ALL_FRAME_ROWS;
+    frameChanges.generation++;
     keypad.fill(false);
     prevKeypadState.fill(false);
+    clearCode();
+    fault = {};
+    waitingForKey = false;
+    executedInstructionCount = 0;
+    skippedInstructionCount = 0;
+    storedPages = ALL_PAGES;
+    memoryHash = hashMemory(0, MEMORY_SIZE);
 
     loadStoreQuirk = true;
     shiftQuirk = true;
     wrapQuirk = false;
+    selectQuirks();
 }
 
-void Interpreter::loadRom(const std::filesystem::path& romPath) {
-    if (!std::filesystem::exists(romPath)) {
-        throw std::runtime_error("File not found: " + romPath.string());
+/**
+ * Loads the ROM at the given path into memory. Returns a description of the 
+ * error if the ROM could not be loaded.
+ */
+std::optional<std::string> Interpreter::loadRom(
+    const std::filesystem::path& romPath) {
+    std::error_code errorCode;
+
+    if (!std::filesystem::exists(romPath, errorCode)) {
+        return "File not found: " + romPath.string();
     }
 
     std::ifstream romFile{romPath, std::ios_base::in | std::ios_base::binary};
 
     if (!romFile) {
-        throw std::runtime_error("Failed to open file: " + romPath.string());
+        return "Failed to open file: " + romPath.string();
     }
 
-    const uintmax_t romSize = std::filesystem::file_size(romPath);
+    const uintmax_t romSize = std::filesystem::file_size(romPath, errorCode);
     const uintmax_t maxRomSize = MEMORY_SIZE - PROG_START_ADDRESS;
 
+    if (errorCode) {
+        return "Failed to read file: " + romPath.string();
+    }
+
     if (romSize > maxRomSize) {
-        throw std::length_error("File exceeds maximum ROM size: " + 
-            romPath.string() +  " (current size: " + std::to_string(romSize) +
-            " bytes, maximum size: " + std::to_string(maxRomSize) + " bytes)");
+        return "File exceeds maximum ROM size: " + romPath.string() + 
+            " (current size: " + std::to_string(romSize) + " bytes, maximum " 
+            "size: " + std::to_string(maxRomSize) + " bytes)";
     }
 
+    std::vector<uint8_t> romData(romSize);
     romFile.seekg(0, std::ios_base::beg);
-    romFile.read(reinterpret_cast<char*>(memory.data() + PROG_START_ADDRESS), 
-        romSize);
+    romFile.read(reinterpret_cast<char*>(romData.data()), romSize);
     
     if (!romFile) {
-        throw std::runtime_error("Failed to read file: " + romPath.string());
+        return "Failed to read file: " + romPath.string();
     }
+
+    return loadRom(romData.data(), romData.size());
+}
+
+/**
+ * Loads a ROM image of the given size from memory. Returns a description of 
+ * the error if the ROM could not be loaded.
+ */
+std::optional<std::string> Interpreter::loadRom(const uint8_t* romData, 
+    const size_t romSize) {
+    const size_t maxRomSize = MEMORY_SIZE - PROG_START_ADDRESS;
+
+    if (romSize > maxRomSize) {
+        return "ROM exceeds maximum size (current size: " + 
+            std::to_string(romSize) + " bytes, maximum size: " + 
+            std::to_string(maxRomSize) + " bytes)";
+    }
+
+    clearCode();
+    fault = {};
+    waitingForKey = false;
+    storedPages = ALL_PAGES;
+
+    std::copy(romData, romData + romSize, 
+        std::begin(memory) + PROG_START_ADDRESS);
+    memoryHash = hashMemory(0, MEMORY_SIZE);
+
+    return std::nullopt;
 }
 
 void Interpreter::updateTimers() {
@@ -110,267 +255,965 @@ void Interpreter::updateTimers() {
 }
 
 void Interpreter::setKey(const int key, const bool isPressed) {
-    keypad[key] = isPressed;
+    if (keypad[key] != isPressed) {
+        keypad[key] = isPressed;
+        waitingForKey = false;
+    }
+}
+
+// Makes the values drawn by Cxkk reproducible from the given seed.
+void Interpreter::seedRandom(const uint64_t seed) {
+    random.seed(seed);
 }
 
 void Interpreter::setLoadStoreQuirk(const bool isEnabled) {
     loadStoreQuirk = isEnabled;
+    selectQuirks();
 }
 
 void Interpreter::setShiftQuirk(const bool isEnabled) {
     shiftQuirk = isEnabled;
+    selectQuirks();
 }
 
 void Interpreter::setWrapQuirk(const bool isEnabled) {
     wrapQuirk = isEnabled;
+    selectQuirks();
+}
+
+/**
+ * Executes a single instruction. Once an instruction faults, the interpreter 
+ * stays halted on it and the same fault is returned on every call. Nothing is 
+ * executed while the interpreter is waiting for a key.
+ */
+const Fault& Interpreter::tick() {
+    if (!isHalted()) {
+        (this->*dispatch.tick)();
+        if (!isHalted()) {
+            executedInstructionCount++;
+        }
+    }
+    return fault;
+}
+
+/**
+ * Executes up to the given number of instructions, stopping early if one of 
+ * them faults or starts waiting for a key.
+ */
+const Fault& Interpreter::run(const int instructionCount) {
+    if (!isHalted()) {
+        const int remaining = (this->*dispatch.run)(instructionCount);
+        executedInstructionCount += instructionCount - remaining;
+    }
+    return fault;
+}
+
+/**
+ * Writes a snapshot of the whole machine into the buffer: memory, registers, 
+ * stack, frame, keypad, quirk settings, random number generator and fault 
+ * state. Returns the number of bytes written, which is always STATE_SIZE, or 
+ * 0 if the buffer is too small.
+ */
+size_t Interpreter::saveState(uint8_t* buffer, const size_t bufferSize) const {
+    if (buffer == nullptr || bufferSize < STATE_SIZE) {
+        return 0;
+    }
+
+    StateWriter writer{buffer};
+    writer.write(STATE_MAGIC);
+    writer.write(STATE_VERSION);
+    writer.write(memory);
+    writer.write(registers.v);
+    writer.write(registers.pc);
+    writer.write(registers.i);
+    writer.write(registers.sp);
+    writer.write(registers.delayTimer);
+    writer.write(registers.soundTimer);
+    writer.write(stack);
+    writer.write(frame);
+    writer.write(packKeypad(keypad));
+    writer.write(packKeypad(prevKeypadState));
+    writer.write(static_cast<uint8_t>(loadStoreQuirk << 2 | 
+        shiftQuirk << 1 | wrapQuirk));
+    writer.write(random.getState());
+    writer.write(static_cast<uint8_t>(fault.kind));
+    writer.write(fault.pc);
+    writer.write(fault.opcode);
+    writer.write(static_cast<uint8_t>(waitingForKey));
+    writer.write(executedInstructionCount);
+    writer.write(skippedInstructionCount);
+    return STATE_SIZE;
+}
+
+/**
+ * Restores a snapshot written by saveState(). Returns false, leaving the 
+ * interpreter unchanged, if the snapshot is truncated, was written by another 
+ * version, or holds values the interpreter could never be in.
+ */
+bool Interpreter::loadState(const uint8_t* buffer, const size_t bufferSize) {
+    if (buffer == nullptr || bufferSize < STATE_SIZE) {
+        return false;
+    }
+
+    StateReader reader{buffer};
+    std::array<uint8_t, STATE_MAGIC.size()> magic{};
+    uint16_t version{};
+    reader.read(magic);
+    reader.read(version);
+    if (magic != STATE_MAGIC || version != STATE_VERSION) {
+        return false;
+    }
+
+    // Decoded in full before anything is applied, so an invalid snapshot has 
+    // no effect
+    Memory savedMemory{};
+    Registers savedRegisters{};
+    Stack savedStack{};
+    Frame savedFrame{};
+    uint16_t savedKeys{};
+    uint16_t savedPrevKeys{};
+    uint8_t savedQuirks{};
+    uint64_t savedRandomState{};
+    uint8_t savedFaultKind{};
+    Fault savedFault{};
+    uint8_t savedWaitingForKey{};
+    uint64_t savedExecutedCount{};
+    uint64_t savedSkippedCount{};
+    reader.read(savedMemory);
+    reader.read(savedRegisters.v);
+    reader.read(savedRegisters.pc);
+    reader.read(savedRegisters.i);
+    reader.read(savedRegisters.sp);
+    reader.read(savedRegisters.delayTimer);
+    reader.read(savedRegisters.soundTimer);
+    reader.read(savedStack);
+    reader.read(savedFrame);
+    reader.read(savedKeys);
+    reader.read(savedPrevKeys);
+    reader.read(savedQuirks);
+    reader.read(savedRandomState);
+    reader.read(savedFaultKind);
+    reader.read(savedFault.pc);
+    reader.read(savedFault.opcode);
+    reader.read(savedWaitingForKey);
+    reader.read(savedExecutedCount);
+    reader.read(savedSkippedCount);
+
+    // Execution indexes the decoded instruction and block caches by the 
+    // program counter, and by every return address it may pop
+    const auto isOutsideCaches = [](const uint16_t address) {
+        return address >= InstructionCache::ENTRY_COUNT;
+    };
+    if (isOutsideCaches(savedRegisters.pc) || 
+        std::any_of(std::begin(savedStack), std::end(savedStack), 
+            isOutsideCaches)) {
+        return false;
+    }
+    if (savedRegisters.sp > STACK_SIZE || savedQuirks > 0x7 || 
+        savedFaultKind > static_cast<uint8_t>(FaultKind::PC_OUT_OF_BOUNDS) || 
+        savedWaitingForKey > 1) {
+        return false;
+    }
+
+    memory = savedMemory;
+    storedPages = ALL_PAGES;
+    memoryHash = hashMemory(0, MEMORY_SIZE);
+    registers = savedRegisters;
+    stack = savedStack;
+    frame = savedFrame;
+    frameChanges.dirtyRows = ALL_FRAME_ROWS;
+    frameChanges.generation++;
+    keypad = unpackKeypad(savedKeys);
+    prevKeypadState = unpackKeypad(savedPrevKeys);
+    random.setState(savedRandomState);
+    clearCode();
+    savedFault.kind = static_cast<FaultKind>(savedFaultKind);
+    fault = savedFault;
+    waitingForKey = savedWaitingForKey != 0;
+    executedInstructionCount = savedExecutedCount;
+    skippedInstructionCount = savedSkippedCount;
+
+    loadStoreQuirk = (savedQuirks & 0x4) != 0;
+    shiftQuirk = (savedQuirks & 0x2) != 0;
+    wrapQuirk = (savedQuirks & 0x1) != 0;
+    selectQuirks();
+    return true;
+}
+
+/**
+ * Takes a copy of the machine that restore() can return to. Pages stored to 
+ * since the last fork are copied, unless their contents did not change, and 
+ * every other page is shared with the last fork.
+ */
+Interpreter::Fork Interpreter::fork() {
+    for (int page = 0; page < PAGE_COUNT; page++) {
+        if ((storedPages >> page & 1) == 0) {
+            continue;
+        }
+        const auto first = std::begin(memory) + page * PAGE_SIZE;
+        if (pages[page] == nullptr || 
+            !std::equal(first, first + PAGE_SIZE, std::begin(*pages[page]))) {
+            auto copy = std::make_shared<Page>();
+            std::copy(first, first + PAGE_SIZE, std::begin(*copy));
+            pages[page] = std::move(copy);
+        }
+    }
+    storedPages = 0;
+
+    Fork result;
+    result.pages = pages;
+    result.registers = registers;
+    result.stack = stack;
+    result.frame = frame;
+    result.keypad = keypad;
+    result.prevKeypadState = prevKeypadState;
+    result.memoryHash = memoryHash;
+    result.randomState = random.getState();
+    result.loadStoreQuirk = loadStoreQuirk;
+    result.shiftQuirk = shiftQuirk;
+    result.wrapQuirk = wrapQuirk;
+    result.fault = fault;
+    result.waitingForKey = waitingForKey;
+    result.executedInstructionCount = executedInstructionCount;
+    result.skippedInstructionCount = skippedInstructionCount;
+    return result;
+}
+
+/**
+ * Returns the machine to the state a fork was taken in, from this or any 
+ * other interpreter. Only the pages that differ from the fork are copied 
+ * back, and decoded code is only dropped for those, so restoring forks of 
+ * the same game keeps the code caches warm.
+ */
+void Interpreter::restore(const Fork& source) {
+    for (int page = 0; page < PAGE_COUNT; page++) {
+        if ((storedPages >> page & 1) == 0 && 
+            pages[page] == source.pages[page]) {
+            continue;
+        }
+        std::copy(std::begin(*source.pages[page]), 
+            std::end(*source.pages[page]), 
+            std::begin(memory) + page * PAGE_SIZE);
+        invalidateCode(page * PAGE_SIZE, PAGE_SIZE);
+        pages[page] = source.pages[page];
+    }
+    storedPages = 0;
+    memoryHash = source.memoryHash;
+
+    registers = source.registers;
+    stack = source.stack;
+    frame = source.frame;
+    frameChanges.dirtyRows = ALL_FRAME_ROWS;
+    frameChanges.generation++;
+    keypad = source.keypad;
+    prevKeypadState = source.prevKeypadState;
+    random.setState(source.randomState);
+    fault = source.fault;
+    waitingForKey = source.waitingForKey;
+    executedInstructionCount = source.executedInstructionCount;
+    skippedInstructionCount = source.skippedInstructionCount;
+
+    loadStoreQuirk = source.loadStoreQuirk;
+    shiftQuirk = source.shiftQuirk;
+    wrapQuirk = source.wrapQuirk;
+    selectQuirks();
+}
+
+/**
+ * Points tick() and run() at the instantiation matching the current quirk 
+ * settings.
+ */
+void Interpreter::selectQuirks() {
+    // Indexed by the quirk settings, with the load/store quirk as the most 
+    // significant bit
+    static constexpr Dispatch dispatchTable[] = {
+        {&Interpreter::tickWith<QuirkPolicy<false, false, false>>, 
+            &Interpreter::runWith<QuirkPolicy<false, false, false>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<false, false, true>>, 
+            &Interpreter::runWith<QuirkPolicy<false, false, true>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<false, true, false>>, 
+            &Interpreter::runWith<QuirkPolicy<false, true, false>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<false, true, true>>, 
+            &Interpreter::runWith<QuirkPolicy<false, true, true>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<true, false, false>>, 
+            &Interpreter::runWith<QuirkPolicy<true, false, false>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<true, false, true>>, 
+            &Interpreter::runWith<QuirkPolicy<true, false, true>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<true, true, false>>, 
+            &Interpreter::runWith<QuirkPolicy<true, true, false>>}, 
+        {&Interpreter::tickWith<QuirkPolicy<true, true, true>>, 
+            &Interpreter::runWith<QuirkPolicy<true, true, true>>}
+    };
+    dispatch = dispatchTable[loadStoreQuirk << 2 | shiftQuirk << 1 | 
+        wrapQuirk];
 }
 
-void Interpreter::tick() {
-    const Opcode opcode = memory[registers.pc] << 8 | memory[registers.pc + 1];
+template <typename Quirks>
+void Interpreter::tickWith() {
+    const DecodedInstruction& instruction = instructionCache.fetch(memory, 
+        registers.pc);
 
     registers.pc += 2;
 
-    switch (opcode.prefix()) {
-        case 0x0: 
-            switch (opcode.byte()) {
-                case 0xE0: return instructions::CLS(frame);
-                case 0xEE: return instructions::RET(registers, stack);
-                default: return instructions::ILLEGAL_OPCODE(opcode);
-            }
-        case 0x1: return instructions::JP_ADDR(opcode, registers);
-        case 0x2: return instructions::CALL_ADDR(opcode, registers, stack);
-        case 0x3: return instructions::SE_VX_BYTE(opcode, registers);
-        case 0x4: return instructions::SNE_VX_BYTE(opcode, registers);
-        case 0x5: return instructions::SE_VX_VY(opcode, registers);
-        case 0x6: return instructions::LD_VX_BYTE(opcode, registers);
-        case 0x7: return instructions::ADD_VX_BYTE(opcode, registers);
-        case 0x8:
-            switch (opcode.nibble()) {
-                case 0x0: return instructions::LD_VX_VY(opcode, registers);
-                case 0x1: return instructions::OR_VX_VY(opcode, registers);
-                case 0x2: return instructions::AND_VX_VY(opcode, registers);
-                case 0x3: return instructions::XOR_VX_VY(opcode, registers);
-                case 0x4: return instructions::ADD_VX_VY(opcode, registers);
-                case 0x5: return instructions::SUB_VX_VY(opcode, registers);
-                case 0x6: return instructions::SHR_VX_VY(opcode, registers, 
-                    shiftQuirk);
-                case 0x7: return instructions::SUBN_VX_VY(opcode, registers);
-                case 0xE: return instructions::SHL_VX_VY(opcode, registers,
-                    shiftQuirk);
-                default: return instructions::ILLEGAL_OPCODE(opcode);
-            }
-        case 0x9: return instructions::SNE_VX_VY(opcode, registers);
-        case 0xA: return instructions::LD_I_ADDR(opcode, registers);
-        case 0xB: return instructions::JP_V0_ADDR(opcode, registers);
-        case 0xC: return instructions::RND_VX_BYTE(opcode, registers, random);
-        case 0xD: return instructions::DRW_VX_VY_NIBBLE(opcode, memory, 
-            registers, frame, wrapQuirk);
-        case 0xE:
-            switch(opcode.byte()) {
-                case 0x9E: return instructions::SKP_VX(opcode, registers, 
-                    keypad);
-                case 0xA1: return instructions::SKNP_VX(opcode, registers, 
-                    keypad);
-                default: return instructions::ILLEGAL_OPCODE(opcode);
-            }
-        case 0xF:
-            switch(opcode.byte()) {
-                case 0x07: return instructions::LD_VX_DT(opcode, registers);
-                case 0x0A: return instructions::LD_VX_K(opcode, registers, 
-                    keypad, prevKeypadState);
-                case 0x15: return instructions::LD_DT_VX(opcode, registers);
-                case 0x18: return instructions::LD_ST_VX(opcode, registers);
-                case 0x1E: return instructions::ADD_I_VX(opcode, registers);
-                case 0x29: return instructions::LD_F_VX(opcode, registers);
-                case 0x33: return instructions::LD_B_VX(opcode, memory, 
-                    registers);
-                case 0x55: return instructions::LD_I_VX(opcode, memory, 
-                    registers, loadStoreQuirk);
-                case 0x65: return instructions::LD_VX_I(opcode, memory, 
-                    registers, loadStoreQuirk);
-                default: return instructions::ILLEGAL_OPCODE(opcode);
-            }
-        default: return instructions::ILLEGAL_OPCODE(opcode);
-    }
-}
-
-std::string hexFormat(const int value, const int length) {
-    std::stringstream stream;
-    stream << std::uppercase << std::setfill('0') << std::setw(length)
-        << std::hex << value;
-    return stream.str();
-}
-
-std::string Interpreter::disassembleOpcode(const int address) const {
-    const Opcode opcode = memory[address] << 8 | memory[address + 1];
-    std::stringstream instruction;
-    switch (opcode.prefix()) {
-        case 0x0: 
-            switch (opcode.byte()) {
-                case 0xE0:
-                    instruction << "CLS";
-                    break;
-                case 0xEE:
-                    instruction << "RET";
-                    break;
-                default:
-                    instruction << "-";
-            }
+    const FaultKind faultKind = execute<Quirks>(instruction.operation, 
+        instruction.opcode);
+    if (faultKind != FaultKind::NONE) {
+        raiseFault(faultKind, instruction.opcode);
+    }
+}
+
+/**
+ * Executes up to the given number of instructions one at a time, stopping 
+ * early if the interpreter halts. Returns the number of instructions left 
+ * unexecuted, which includes the one the interpreter halted on.
+ */
+template <typename Quirks>
+int Interpreter::tickUntilHalted(int remaining) {
+    for (; remaining > 0; remaining--) {
+        tickWith<Quirks>();
+        if (isHalted()) {
             break;
-        case 0x1:
-            instruction << "JP 0x" << hexFormat(opcode.address(), 4);
+        }
+    }
+    return remaining;
+}
+
+/**
+ * Runs an Fx33 or Fx55 store of the given length at I. Stores may overwrite 
+ * code, so any instructions translated from the bytes about to be written 
+ * are dropped. The pages written are marked as no longer shared with the 
+ * last fork, and the keys of the old bytes in the memory hash are swapped 
+ * for those of the new ones. Stores write at most 16 bytes, so they span two 
+ * pages at most.
+ */
+template <typename Store>
+FaultKind Interpreter::runStore(const int length, Store store) {
+    const uint16_t address = registers.i;
+    invalidateCode(address, length);
+    if (address < MEMORY_SIZE) {
+        const int last = std::min(address + length, MEMORY_SIZE) - 1;
+        storedPages |= static_cast<uint16_t>(1 << address / PAGE_SIZE | 
+            1 << last / PAGE_SIZE);
+    }
+
+    memoryHash ^= hashMemory(address, length);
+    const FaultKind faultKind = store();
+    memoryHash ^= hashMemory(address, length);
+    return faultKind;
+}
+
+/**
+ * Executes a single decoded instruction, returning the kind of fault it 
+ * raised, if any.
+ */
+template <typename Quirks>
+FaultKind Interpreter::execute(const Operation operation, 
+    const Opcode& opcode) {
+    switch (operation) {
+        case Operation::CLS: 
+            instructions::CLS(frame, frameChanges);
             break;
-        case 0x2:
-            instruction << "CALL 0x" << hexFormat(opcode.address(), 4);
+        case Operation::RET: 
+            return instructions::RET(registers, stack);
+        case Operation::JP_ADDR: 
+            instructions::JP_ADDR(opcode, registers);
             break;
-        case 0x3:
-            instruction << "SE V" << hexFormat(opcode.x(), 1) << ", 0x" 
-                << hexFormat(opcode.byte(), 2);
+        case Operation::CALL_ADDR: 
+            return instructions::CALL_ADDR(opcode, registers, stack);
+        case Operation::SE_VX_BYTE: 
+            instructions::SE_VX_BYTE(opcode, registers);
             break;
-        case 0x4:
-            instruction << "SNE V" << hexFormat(opcode.x(), 1) << ", 0x"
-                << hexFormat(opcode.byte(), 2);
+        case Operation::SNE_VX_BYTE: 
+            instructions::SNE_VX_BYTE(opcode, registers);
             break;
-        case 0x5:
-            instruction << "SE V" << hexFormat(opcode.x(), 1) << ", V" 
-                << hexFormat(opcode.y(), 1);
+        case Operation::SE_VX_VY: 
+            instructions::SE_VX_VY(opcode, registers);
             break;
-        case 0x6:
-            instruction << "LD V" << hexFormat(opcode.x(), 1) << ", 0x"
-                << hexFormat(opcode.byte(), 2);
+        case Operation::LD_VX_BYTE: 
+            instructions::LD_VX_BYTE(opcode, registers);
             break;
-        case 0x7:
-            instruction << "ADD V" << hexFormat(opcode.x(), 1) << ", 0x"
-                << hexFormat(opcode.byte(), 2);
+        case Operation::ADD_VX_BYTE: 
+            instructions::ADD_VX_BYTE(opcode, registers);
             break;
-        case 0x8:
-            switch (opcode.nibble()) {
-                case 0x0:
-                    instruction << "LD V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x1:
-                    instruction << "OR V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x2:
-                    instruction << "AND V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x3:
-                    instruction << "XOR V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x4:
-                    instruction << "ADD V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x5:
-                    instruction << "SUB V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x6:
-                    instruction << "SHR V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0x7:
-                    instruction << "SUBN V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                case 0xE:
-                    instruction << "SHL V" << hexFormat(opcode.x(), 1) << ", V" 
-                        << hexFormat(opcode.y(), 1);
-                    break;
-                default:
-                    instruction << "-";
-            }
+        case Operation::LD_VX_VY: 
+            instructions::LD_VX_VY(opcode, registers);
             break;
-        case 0x9:
-            instruction << "SNE V" << hexFormat(opcode.x(), 1) << ", V" 
-                << hexFormat(opcode.y(), 1);
+        case Operation::OR_VX_VY: 
+            instructions::OR_VX_VY(opcode, registers);
             break;
-        case 0xA:
-            instruction << "LD I, 0x" << hexFormat(opcode.address(), 4);
+        case Operation::AND_VX_VY: 
+            instructions::AND_VX_VY(opcode, registers);
             break;
-        case 0xB:
-            instruction << "JP V0, 0x" << hexFormat(opcode.address(), 4);
+        case Operation::XOR_VX_VY: 
+            instructions::XOR_VX_VY(opcode, registers);
             break;
-        case 0xC:
-            instruction << "RND V" << hexFormat(opcode.x(), 1) << ", 0x" 
-                << hexFormat(opcode.byte(), 2);
+        case Operation::ADD_VX_VY: 
+            instructions::ADD_VX_VY(opcode, registers);
             break;
-        case 0xD:
-            instruction << "DRW V" << hexFormat(opcode.x(), 1) << ", V"
-                << hexFormat(opcode.y(), 1) << ", 0x" 
-                << hexFormat(opcode.nibble(), 1);
+        case Operation::SUB_VX_VY: 
+            instructions::SUB_VX_VY(opcode, registers);
             break;
-        case 0xE:
-            switch(opcode.byte()) {
-                case 0x9E:
-                    instruction << "SKP V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0xA1:
-                    instruction << "SKNP V" << hexFormat(opcode.x(), 1);
-                    break;
-                default:
-                    instruction << "-";
-            }
+        case Operation::SHR_VX_VY: 
+            instructions::SHR_VX_VY<Quirks::shift>(opcode, registers);
             break;
-        case 0xF:
-            switch(opcode.byte()) {
-                case 0x07:
-                    instruction << "LD V" << hexFormat(opcode.x(), 1) << ", DT";
-                    break;
-                case 0x0A:
-                    instruction << "LD V" << hexFormat(opcode.x(), 1) << ", K";
-                    break;
-                case 0x15:
-                    instruction << "LD DT, V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0x18:
-                    instruction << "LD ST, V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0x1E:
-                    instruction << "ADD I, V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0x29:
-                    instruction << "LD F, V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0x33: 
-                    instruction << "LD B, V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0x55:
-                    instruction << "LD [I], V" << hexFormat(opcode.x(), 1);
-                    break;
-                case 0x65: 
-                    instruction << "LD V" << hexFormat(opcode.x(), 1) 
-                        << ", [I]";
-                    break;
-                default:
-                    instruction << "-";
-            }
+        case Operation::SUBN_VX_VY: 
+            instructions::SUBN_VX_VY(opcode, registers);
+            break;
+        case Operation::SHL_VX_VY: 
+            instructions::SHL_VX_VY<Quirks::shift>(opcode, registers);
+            break;
+        case Operation::SNE_VX_VY: 
+            instructions::SNE_VX_VY(opcode, registers);
+            break;
+        case Operation::LD_I_ADDR: 
+            instructions::LD_I_ADDR(opcode, registers);
+            break;
+        case Operation::JP_V0_ADDR: 
+            instructions::JP_V0_ADDR(opcode, registers);
+            break;
+        case Operation::RND_VX_BYTE: 
+            instructions::RND_VX_BYTE(opcode, registers, random);
+            break;
+        case Operation::DRW_VX_VY_NIBBLE: 
+            return instructions::DRW_VX_VY_NIBBLE<Quirks::wrap>(opcode, 
+                memory, registers, frame, frameChanges);
+        case Operation::SKP_VX: 
+            instructions::SKP_VX(opcode, registers, keypad);
+            break;
+        case Operation::SKNP_VX: 
+            instructions::SKNP_VX(opcode, registers, keypad);
+            break;
+        case Operation::LD_VX_DT: 
+            instructions::LD_VX_DT(opcode, registers);
+            break;
+        case Operation::LD_VX_K: 
+            waitForKey(opcode);
+            break;
+        case Operation::LD_DT_VX: 
+            instructions::LD_DT_VX(opcode, registers);
+            break;
+        case Operation::LD_ST_VX: 
+            instructions::LD_ST_VX(opcode, registers);
             break;
-        default:
-            instruction << "-";
+        case Operation::ADD_I_VX: 
+            instructions::ADD_I_VX(opcode, registers);
+            break;
+        case Operation::LD_F_VX: 
+            instructions::LD_F_VX(opcode, registers);
+            break;
+        case Operation::LD_B_VX: 
+            return runStore(3, [&] {
+                return instructions::LD_B_VX(opcode, memory, registers);
+            });
+        case Operation::LD_I_VX: 
+            return runStore(opcode.x() + 1, [&] {
+                return instructions::LD_I_VX<Quirks::loadStore>(opcode, 
+                    memory, registers);
+            });
+        case Operation::LD_VX_I: 
+            return instructions::LD_VX_I<Quirks::loadStore>(opcode, memory, 
+                registers);
+        case Operation::PC_OUT_OF_BOUNDS: 
+            return FaultKind::PC_OUT_OF_BOUNDS;
+        default: 
+            return instructions::ILLEGAL_OPCODE(opcode);
     }
-    return instruction.str();
+    return FaultKind::NONE;
 }
 
-std::string Interpreter::getDisassembledInstructions() const {
-    std::stringstream stream;
+#ifdef OCTACHIP_THREADED_DISPATCH
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+#endif
+
+/**
+ * Executes the given number of instructions one translated block at a time, 
+ * using direct-threaded dispatch over the block's micro-ops. Every handler is 
+ * expanded into this function and ends with its own jump to the next handler, 
+ * so the branch predictor can learn the successors of each micro-op 
+ * separately. The instruction budget is only checked between blocks, and a 
+ * block that would overrun it is stepped through with tick() instead. Returns 
+ * the number of instructions left unexecuted when the interpreter halts.
+ */
+template <typename Quirks>
+int Interpreter::runWith(const int instructionCount) {
+    // Indexed by Operation, so the order must match its declaration. Blocks 
+    // only contain decoded instructions, so UNDECODED is never dispatched.
+    static const void* const handlers[] = {
+        &&ILLEGAL_OPCODE, &&CLS, &&RET, &&JP_ADDR, &&CALL_ADDR, &&SE_VX_BYTE, 
+        &&SNE_VX_BYTE, &&SE_VX_VY, &&LD_VX_BYTE, &&ADD_VX_BYTE, &&LD_VX_VY, 
+        &&OR_VX_VY, &&AND_VX_VY, &&XOR_VX_VY, &&ADD_VX_VY, &&SUB_VX_VY, 
+        &&SHR_VX_VY, &&SUBN_VX_VY, &&SHL_VX_VY, &&SNE_VX_VY, &&LD_I_ADDR, 
+        &&JP_V0_ADDR, &&RND_VX_BYTE, &&DRW_VX_VY_NIBBLE, &&SKP_VX, &&SKNP_VX, 
+        &&LD_VX_DT, &&LD_VX_K, &&LD_DT_VX, &&LD_ST_VX, &&ADD_I_VX, &&LD_F_VX, 
+        &&LD_B_VX, &&LD_I_VX, &&LD_VX_I, &&ILLEGAL_OPCODE, &&PC_OUT_OF_BOUNDS, 
+        &&LD_VX_BYTE_PAIR, &&ADD_VX_VY_NO_FLAG, &&SUB_VX_VY_NO_FLAG, 
+        &&SHR_VX_VY_NO_FLAG, &&SUBN_VX_VY_NO_FLAG, &&SHL_VX_VY_NO_FLAG, 
+        &&SE_VX_BYTE_JP, &&SNE_VX_BYTE_JP, &&SE_VX_VY_JP, &&SNE_VX_VY_JP, 
+        &&SKP_VX_JP, &&SKNP_VX_JP
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == 
+        static_cast<int>(Operation::SKNP_VX_JP) + 1);
+
+    int remaining = instructionCount;
+    int blockRemaining = 0;
+    int blockEnd = 0;
+    const MicroOp* microOp = nullptr;
+    FaultKind faultKind = FaultKind::NONE;
+
+#define NEXT() \
+    do { \
+        if (--blockRemaining == 0) { \
+            goto BLOCK; \
+        } \
+        microOp++; \
+        registers.pc += 2; \
+        goto *handlers[static_cast<int>(microOp->operation)]; \
+    } while (false)
+
+#define END_BLOCK() goto BLOCK
+
+#define CHECK_FAULT(handler) \
+    do { \
+        faultKind = (handler); \
+        if (faultKind != FaultKind::NONE) { \
+            goto FAULT; \
+        } \
+    } while (false)
+
+BLOCK: 
+    if (remaining <= 0) {
+        return remaining;
+    }
+    {
+        const Block& block = blockCache.fetch(memory, registers.pc);
+        if (block.idleLoop) {
+            remaining -= skipIdleLoop(block, remaining);
+        }
+        if (block.instructionCount > remaining) {
+            return tickUntilHalted<Quirks>(remaining);
+        }
+        // A block that halts part way through refunds the instructions from 
+        // the one it halted on to its end
+        blockEnd = registers.pc + 2 * block.instructionCount;
+        // Every instruction the block covers is charged up front, and a fused 
+        // jump that ends up skipped is refunded by its handler
+        remaining -= block.instructionCount;
+        blockRemaining = block.length;
+        microOp = blockCache.microOps(block);
+    }
+    registers.pc += 2;
+    goto *handlers[static_cast<int>(microOp->operation)];
+
+CLS: 
+    instructions::CLS(frame, frameChanges);
+    NEXT();
+RET: 
+    CHECK_FAULT(instructions::RET(registers, stack));
+    END_BLOCK();
+JP_ADDR: 
+    instructions::JP_ADDR(microOp->opcode, registers);
+    END_BLOCK();
+CALL_ADDR: 
+    CHECK_FAULT(instructions::CALL_ADDR(microOp->opcode, registers, stack));
+    END_BLOCK();
+SE_VX_BYTE: 
+    instructions::SE_VX_BYTE(microOp->opcode, registers);
+    END_BLOCK();
+SNE_VX_BYTE: 
+    instructions::SNE_VX_BYTE(microOp->opcode, registers);
+    END_BLOCK();
+SE_VX_VY: 
+    instructions::SE_VX_VY(microOp->opcode, registers);
+    END_BLOCK();
+LD_VX_BYTE: 
+    instructions::LD_VX_BYTE(microOp->opcode, registers);
+    NEXT();
+ADD_VX_BYTE: 
+    instructions::ADD_VX_BYTE(microOp->opcode, registers);
+    NEXT();
+LD_VX_VY: 
+    instructions::LD_VX_VY(microOp->opcode, registers);
+    NEXT();
+OR_VX_VY: 
+    instructions::OR_VX_VY(microOp->opcode, registers);
+    NEXT();
+AND_VX_VY: 
+    instructions::AND_VX_VY(microOp->opcode, registers);
+    NEXT();
+XOR_VX_VY: 
+    instructions::XOR_VX_VY(microOp->opcode, registers);
+    NEXT();
+ADD_VX_VY: 
+    instructions::ADD_VX_VY(microOp->opcode, registers);
+    NEXT();
+SUB_VX_VY: 
+    instructions::SUB_VX_VY(microOp->opcode, registers);
+    NEXT();
+SHR_VX_VY: 
+    instructions::SHR_VX_VY<Quirks::shift>(microOp->opcode, registers);
+    NEXT();
+SUBN_VX_VY: 
+    instructions::SUBN_VX_VY(microOp->opcode, registers);
+    NEXT();
+SHL_VX_VY: 
+    instructions::SHL_VX_VY<Quirks::shift>(microOp->opcode, registers);
+    NEXT();
+SNE_VX_VY: 
+    instructions::SNE_VX_VY(microOp->opcode, registers);
+    END_BLOCK();
+LD_I_ADDR: 
+    instructions::LD_I_ADDR(microOp->opcode, registers);
+    NEXT();
+JP_V0_ADDR: 
+    instructions::JP_V0_ADDR(microOp->opcode, registers);
+    END_BLOCK();
+RND_VX_BYTE: 
+    instructions::RND_VX_BYTE(microOp->opcode, registers, random);
+    NEXT();
+DRW_VX_VY_NIBBLE: 
+    CHECK_FAULT(instructions::DRW_VX_VY_NIBBLE<Quirks::wrap>(microOp->opcode, 
+        memory, registers, frame, frameChanges));
+    END_BLOCK();
+SKP_VX: 
+    instructions::SKP_VX(microOp->opcode, registers, keypad);
+    END_BLOCK();
+SKNP_VX: 
+    instructions::SKNP_VX(microOp->opcode, registers, keypad);
+    END_BLOCK();
+LD_VX_DT: 
+    instructions::LD_VX_DT(microOp->opcode, registers);
+    NEXT();
+LD_VX_K: 
+    if (waitForKey(microOp->opcode)) {
+        return remaining + (blockEnd - registers.pc) / 2;
+    }
+    END_BLOCK();
+LD_DT_VX: 
+    instructions::LD_DT_VX(microOp->opcode, registers);
+    NEXT();
+LD_ST_VX: 
+    instructions::LD_ST_VX(microOp->opcode, registers);
+    NEXT();
+ADD_I_VX: 
+    instructions::ADD_I_VX(microOp->opcode, registers);
+    NEXT();
+LD_F_VX: 
+    instructions::LD_F_VX(microOp->opcode, registers);
+    NEXT();
+LD_B_VX: 
+    CHECK_FAULT(runStore(3, [&] {
+        return instructions::LD_B_VX(microOp->opcode, memory, registers);
+    }));
+    END_BLOCK();
+LD_I_VX: 
+    CHECK_FAULT(runStore(microOp->opcode.x() + 1, [&] {
+        return instructions::LD_I_VX<Quirks::loadStore>(microOp->opcode, 
+            memory, registers);
+    }));
+    END_BLOCK();
+LD_VX_I: 
+    CHECK_FAULT(instructions::LD_VX_I<Quirks::loadStore>(microOp->opcode, 
+        memory, registers));
+    NEXT();
+ILLEGAL_OPCODE: 
+    faultKind = instructions::ILLEGAL_OPCODE(microOp->opcode);
+    goto FAULT;
+PC_OUT_OF_BOUNDS: 
+    faultKind = FaultKind::PC_OUT_OF_BOUNDS;
+    goto FAULT;
+LD_VX_BYTE_PAIR: 
+    instructions::LD_VX_BYTE(microOp->opcode, registers);
+    instructions::LD_VX_BYTE(microOp->fused, registers);
+    registers.pc += 2;
+    NEXT();
+ADD_VX_VY_NO_FLAG: 
+    instructions::ADD_VX_VY_NO_FLAG(microOp->opcode, registers);
+    NEXT();
+SUB_VX_VY_NO_FLAG: 
+    instructions::SUB_VX_VY_NO_FLAG(microOp->opcode, registers);
+    NEXT();
+SHR_VX_VY_NO_FLAG: 
+    instructions::SHR_VX_VY_NO_FLAG<Quirks::shift>(microOp->opcode, 
+        registers);
+    NEXT();
+SUBN_VX_VY_NO_FLAG: 
+    instructions::SUBN_VX_VY_NO_FLAG(microOp->opcode, 
+        registers);
+    NEXT();
+SHL_VX_VY_NO_FLAG: 
+    instructions::SHL_VX_VY_NO_FLAG<Quirks::shift>(microOp->opcode, 
+        registers);
+    NEXT();
+SE_VX_BYTE_JP: {
+    const uint16_t next = registers.pc;
+    instructions::SE_VX_BYTE(microOp->opcode, registers);
+    remaining += 2 - jumpUnlessSkipped(next, microOp->fused);
+    END_BLOCK();
+}
+SNE_VX_BYTE_JP: {
+    const uint16_t next = registers.pc;
+    instructions::SNE_VX_BYTE(microOp->opcode, registers);
+    remaining += 2 - jumpUnlessSkipped(next, microOp->fused);
+    END_BLOCK();
+}
+SE_VX_VY_JP: {
+    const uint16_t next = registers.pc;
+    instructions::SE_VX_VY(microOp->opcode, registers);
+    remaining += 2 - jumpUnlessSkipped(next, microOp->fused);
+    END_BLOCK();
+}
+SNE_VX_VY_JP: {
+    const uint16_t next = registers.pc;
+    instructions::SNE_VX_VY(microOp->opcode, registers);
+    remaining += 2 - jumpUnlessSkipped(next, microOp->fused);
+    END_BLOCK();
+}
+SKP_VX_JP: {
+    const uint16_t next = registers.pc;
+    instructions::SKP_VX(microOp->opcode, registers, keypad);
+    remaining += 2 - jumpUnlessSkipped(next, microOp->fused);
+    END_BLOCK();
+}
+SKNP_VX_JP: {
+    const uint16_t next = registers.pc;
+    instructions::SKNP_VX(microOp->opcode, registers, keypad);
+    remaining += 2 - jumpUnlessSkipped(next, microOp->fused);
+    END_BLOCK();
+}
+
+FAULT: 
+    raiseFault(faultKind, microOp->opcode);
+    return remaining + (blockEnd - registers.pc) / 2;
+
+#undef NEXT
+#undef END_BLOCK
+#undef CHECK_FAULT
+}
+
+#pragma GCC diagnostic pop
+#else
+/**
+ * Executes the given number of instructions one translated block at a time, 
+ * using the portable switch-based dispatch over the block's micro-ops. The 
+ * instruction budget is only checked between blocks, and a block that would 
+ * overrun it is stepped through with tick() instead. Returns the number of 
+ * instructions left unexecuted when the interpreter halts.
+ */
+template <typename Quirks>
+int Interpreter::runWith(const int instructionCount) {
+    int remaining = instructionCount;
+    while (remaining > 0) {
+        const Block& block = blockCache.fetch(memory, registers.pc);
+        if (block.idleLoop) {
+            remaining -= skipIdleLoop(block, remaining);
+        }
+        if (block.instructionCount > remaining) {
+            return tickUntilHalted<Quirks>(remaining);
+        }
+        const MicroOp* microOps = blockCache.microOps(block);
+        for (int i = 0; i < block.length; i++) {
+            registers.pc += 2;
+            const int executed = execute<Quirks>(microOps[i]);
+            if (executed == 0) {
+                return remaining;
+            }
+            remaining -= executed;
+        }
+    }
+    return remaining;
+}
+#endif
+
+/**
+ * Executes a single micro-op and returns the number of CHIP-8 instructions it 
+ * executed, which is 0 if it halted the interpreter.
+ */
+template <typename Quirks>
+int Interpreter::execute(const MicroOp& microOp) {
+    const Opcode& opcode = microOp.opcode;
+    const uint16_t next = registers.pc;
+
+    switch (microOp.operation) {
+        case Operation::LD_VX_BYTE_PAIR: 
+            instructions::LD_VX_BYTE(opcode, registers);
+            instructions::LD_VX_BYTE(microOp.fused, registers);
+            registers.pc += 2;
+            return 2;
+        case Operation::ADD_VX_VY_NO_FLAG: 
+            instructions::ADD_VX_VY_NO_FLAG(opcode, registers);
+            return 1;
+        case Operation::SUB_VX_VY_NO_FLAG: 
+            instructions::SUB_VX_VY_NO_FLAG(opcode, registers);
+            return 1;
+        case Operation::SHR_VX_VY_NO_FLAG: 
+            instructions::SHR_VX_VY_NO_FLAG<Quirks::shift>(opcode, 
+                registers);
+            return 1;
+        case Operation::SUBN_VX_VY_NO_FLAG: 
+            instructions::SUBN_VX_VY_NO_FLAG(opcode, registers);
+            return 1;
+        case Operation::SHL_VX_VY_NO_FLAG: 
+            instructions::SHL_VX_VY_NO_FLAG<Quirks::shift>(opcode, 
+                registers);
+            return 1;
+        case Operation::SE_VX_BYTE_JP: 
+            instructions::SE_VX_BYTE(opcode, registers);
+            return jumpUnlessSkipped(next, microOp.fused);
+        case Operation::SNE_VX_BYTE_JP: 
+            instructions::SNE_VX_BYTE(opcode, registers);
+            return jumpUnlessSkipped(next, microOp.fused);
+        case Operation::SE_VX_VY_JP: 
+            instructions::SE_VX_VY(opcode, registers);
+            return jumpUnlessSkipped(next, microOp.fused);
+        case Operation::SNE_VX_VY_JP: 
+            instructions::SNE_VX_VY(opcode, registers);
+            return jumpUnlessSkipped(next, microOp.fused);
+        case Operation::SKP_VX_JP: 
+            instructions::SKP_VX(opcode, registers, keypad);
+            return jumpUnlessSkipped(next, microOp.fused);
+        case Operation::SKNP_VX_JP: 
+            instructions::SKNP_VX(opcode, registers, keypad);
+            return jumpUnlessSkipped(next, microOp.fused);
+        case Operation::LD_VX_K: 
+            return waitForKey(opcode) ? 0 : 1;
+        default: {
+            const FaultKind faultKind = execute<Quirks>(microOp.operation, 
+                opcode);
+            if (faultKind != FaultKind::NONE) {
+                raiseFault(faultKind, opcode);
+                return 0;
+            }
+            return 1;
+        }
+    }
+}
 
-    for (int i = PROG_START_ADDRESS; i < MEMORY_SIZE; i++) {
-        const std::string instruction = disassembleOpcode(i);
-        stream << "0x" << hexFormat(i, 4) << ": " << instruction << "\n";
+/**
+ * Completes a fused skip and jump by taking the jump, unless the skip moved 
+ * the program counter past it. Returns the number of instructions executed.
+ */
+int Interpreter::jumpUnlessSkipped(const uint16_t next, const Opcode& jump) {
+    if (registers.pc != next) {
+        return 1;
     }
+    instructions::JP_ADDR(jump, registers);
+    return 2;
+}
+
+/**
+ * Fast-forwards through an idle loop. The delay timer only changes between 
+ * calls to run(), so a loop that does not exit on its current value spins 
+ * until the instruction budget runs out. Every whole iteration that fits in 
+ * the budget is skipped, leaving the interpreter in the state executing them 
+ * would have, and the partial iteration left over is executed normally. 
+ * Returns the number of instructions skipped.
+ */
+int Interpreter::skipIdleLoop(const Block& block, const int instructionCount) {
+    const int skipped = instructionCount - instructionCount % 
+        block.instructionCount;
+    if (skipped == 0) {
+        return 0;
+    }
+
+    // LD Vx, DT; SE/SNE Vx, kk; JP self
+    if (block.length == 2) {
+        const MicroOp* microOps = blockCache.microOps(block);
+        const bool isEqual = registers.delayTimer == microOps[1].opcode.byte();
+        if (isEqual == (microOps[1].operation == Operation::SE_VX_BYTE_JP)) {
+            return 0;
+        }
+        registers.v[microOps[0].opcode.x()] = registers.delayTimer;
+    }
+
+    skippedInstructionCount += skipped;
+    return skipped;
+}
+
+/**
+ * Executes Fx0A, halting the interpreter if no key has been released yet. 
+ * Rescanning an unchanged keypad has no effect, so the instruction is only 
+ * executed again once setKey() changes a key. Returns whether the interpreter 
+ * is waiting.
+ */
+bool Interpreter::waitForKey(const Opcode& opcode) {
+    waitingForKey = instructions::LD_VX_K(opcode, registers, keypad, 
+        prevKeypadState);
+    return waitingForKey;
+}
+
+// Returns the XOR of the Zobrist keys of the bytes in the given range that 
+// lie inside memory. Each address and value has its own key.
+uint64_t Interpreter::hashMemory(const int address, const int length) const {
+    uint64_t hash = 0;
+    const int last = std::min(address + length, MEMORY_SIZE);
+    for (int current = address; current < last; current++) {
+        hash ^= mixHash(static_cast<uint64_t>(current) << 8 | memory[current]);
+    }
+    return hash;
+}
+
+void Interpreter::invalidateCode(const int address, const int length) {
+    instructionCache.invalidate(address, length);
+    blockCache.invalidate(address, length);
+    disassemblyCache.invalidate(address, length);
+}
+
+// Drops every decoded instruction, for when all of memory may have changed.
+void Interpreter::clearCode() {
+    instructionCache.clear();
+    blockCache.clear();
+    disassemblyCache.clear();
+}
+
+/**
+ * Halts the interpreter on the instruction that was just fetched. The program 
+ * counter is moved back onto it, so execution can be inspected from the point 
+ * of the fault.
+ */
+void Interpreter::raiseFault(const FaultKind kind, const Opcode& opcode) {
+    registers.pc -= 2;
+    fault = {kind, registers.pc, opcode.full()};
+}
+
+/**
+ * Lists the instructions at count consecutive addresses from start, one line 
+ * per address in the form "0x0200: CLS". Addresses outside memory are left 
+ * out. Mnemonics are cached until the memory under them is written, so 
+ * listing the same range again only copies the lines.
+ */
+std::string Interpreter::disassemble(const int start, const int count) const {
+    // "0x0000: " before the mnemonic and a newline after it
+    constexpr size_t LINE_OVERHEAD = 9;
+    constexpr char DIGITS[] = "0123456789ABCDEF";
+
+    const int first = std::clamp(start, 0, MEMORY_SIZE);
+    const int last = std::clamp(start + std::max(count, 0), first, 
+        MEMORY_SIZE);
+    std::string lines;
+    lines.reserve(static_cast<size_t>(last - first) * 
+        (LINE_OVERHEAD + MAX_MNEMONIC_LENGTH));
+
+    for (int address = first; address < last; address++) {
+        const char prefix[] = {'0', 'x', '0', DIGITS[address >> 8], 
+            DIGITS[(address >> 4) & 0xF], DIGITS[address & 0xF], ':', ' '};
+        lines.append(prefix, sizeof(prefix));
+        lines.append(disassemblyCache.fetch(memory, address));
+        lines.push_back('\n');
+    }
+    return lines;
+}
 
-    return stream.str();
+std::string Interpreter::getDisassembledInstructions() const {
+    return disassemble(PROG_START_ADDRESS, MEMORY_SIZE - PROG_START_ADDRESS);
 }
 
+// Returns 0 for an index outside of the register file.
 uint8_t Interpreter::getRegisterValue(const int index) const {
     if (index < 0 || index >= Registers::V_REG_COUNT) {
-        throw std::out_of_range("Invalid register index: " + 
-            std::to_string(index));
+        return 0;
     }
     return registers.v[index];
 }
@@ -395,14 +1238,100 @@ uint8_t Interpreter::getSoundTimerValue() const {
     return registers.soundTimer;
 }
 
+// Returns 0 for an index outside of the stack.
 uint16_t Interpreter::getStackValue(const int index) const {
     if (index < 0 || index >= STACK_SIZE) {
-        throw std::out_of_range("Invalid stack index: " + 
-            std::to_string(index));
+        return 0;
     }
     return stack[index];
 }
 
+// Returns 0 for an address outside of memory.
+uint8_t Interpreter::getMemoryValue(const int address) const {
+    if (address < 0 || address >= MEMORY_SIZE) {
+        return 0;
+    }
+    return memory[address];
+}
+
 const Frame& Interpreter::getFrame() const {
     return frame;
+}
+
+/**
+ * Returns a counter that increases every time the frame changes, so hosts can 
+ * tell whether it needs to be presented again.
+ */
+uint64_t Interpreter::getFrameGeneration() const {
+    return frameChanges.generation;
+}
+
+/**
+ * Returns the rows of the frame that changed since the last call, with one bit 
+ * per row, and marks them as clean.
+ */
+FrameRowMask Interpreter::takeDirtyRows() {
+    const FrameRowMask dirtyRows = frameChanges.dirtyRows;
+    frameChanges.dirtyRows = 0;
+    return dirtyRows;
+}
+
+const Fault& Interpreter::getFault() const {
+    return fault;
+}
+
+// Returns whether execution is suspended until a key is pressed and released.
+bool Interpreter::isWaitingForKey() const {
+    return waitingForKey;
+}
+
+bool Interpreter::isHalted() const {
+    return fault.kind != FaultKind::NONE || waitingForKey;
+}
+
+/**
+ * Returns the number of instructions executed since the interpreter was reset, 
+ * including the ones skipped by fast-forwarding idle loops. An instruction the 
+ * interpreter halted on is not counted until it completes.
+ */
+uint64_t Interpreter::getExecutedInstructionCount() const {
+    return executedInstructionCount;
+}
+
+// Returns the number of instructions skipped by fast-forwarding idle loops.
+uint64_t Interpreter::getSkippedInstructionCount() const {
+    return skippedInstructionCount;
+}
+
+/**
+ * Returns a 64-bit hash of the memory, V registers, I, PC, SP, stack, timers 
+ * and frame, for telling visited states apart. The memory hash is kept up to 
+ * date by every store, so only the fixed few hundred bytes of registers, 
+ * stack and frame are mixed in here.
+ */
+uint64_t Interpreter::getStateHash() const {
+    uint64_t hash = memoryHash;
+    for (const FrameRow row : frame) {
+        hash = mixHash(hash ^ row);
+    }
+    for (int index = 0; index < Registers::V_REG_COUNT; index += 8) {
+        uint64_t word = 0;
+        for (int byte = 0; byte < 8; byte++) {
+            word |= static_cast<uint64_t>(registers.v[index + byte]) << 
+                byte * 8;
+        }
+        hash = mixHash(hash ^ word);
+    }
+    hash = mixHash(hash ^ (registers.pc | 
+        static_cast<uint64_t>(registers.i) << 16 | 
+        static_cast<uint64_t>(registers.sp) << 32 | 
+        static_cast<uint64_t>(registers.delayTimer) << 40 | 
+        static_cast<uint64_t>(registers.soundTimer) << 48));
+    for (int index = 0; index < STACK_SIZE; index += 4) {
+        hash = mixHash(hash ^ (stack[index] | 
+            static_cast<uint64_t>(stack[index + 1]) << 16 | 
+            static_cast<uint64_t>(stack[index + 2]) << 32 | 
+            static_cast<uint64_t>(stack[index + 3]) << 48));
+    }
+    return hash;
 }
\ No newline at end of file
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
 
+#include "core/block_cache.hpp"
+#include "core/disassembler.hpp"
+#include "core/fault.hpp"
+#include "core/instruction_cache.hpp"
 #include "core/random.hpp"
 #include "core/types.hpp"
 
@@ -17,18 +24,86 @@ public:
     static constexpr int FONT_CHAR_SIZE = 5;
     static constexpr int FONT_CHAR_COUNT = 16;
     static constexpr int FONT_SET_SIZE = FONT_CHAR_COUNT * FONT_CHAR_SIZE;
+    static constexpr std::array<uint8_t, FONT_SET_SIZE> FONT_SET = {
+        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
+        0x20, 0x60, 0x20, 0x20, 0x70, // 1
+        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
+        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
+        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
+        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
+        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
+        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
+        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
+        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
+        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
+        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
+        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
+        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
+        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
+        0xF0, 0x80, 0xF0, 0x80, 0x80  // F
+    };
+
+    // Snapshots written by saveState() start with a version number, which is 
+    // bumped whenever their layout changes
+    static constexpr uint16_t STATE_VERSION = 1;
+    static constexpr size_t STATE_SIZE = 4448;
+
+    // Forks share memory in pages of this size
+    static constexpr int PAGE_SIZE = 256;
+    static constexpr int PAGE_COUNT = MEMORY_SIZE / PAGE_SIZE;
+    using Page = std::array<uint8_t, PAGE_SIZE>;
+
+    /**
+     * A copy of the machine taken by fork(), which restore() returns to. 
+     * Memory pages are shared with the interpreter and with earlier forks 
+     * until they are stored to, so a fork costs a few hundred bytes however 
+     * many are taken. Forks never change once taken, and can be restored 
+     * into any interpreter on any thread.
+     */
+    class Fork {
+    private:
+        friend class Interpreter;
+
+        Fork() = default;
+
+        std::array<std::shared_ptr<const Page>, PAGE_COUNT> pages;
+        Registers registers;
+        Stack stack;
+        Frame frame;
+        Keypad keypad;
+        Keypad prevKeypadState;
+        uint64_t memoryHash;
+        uint64_t randomState;
+        bool loadStoreQuirk;
+        bool shiftQuirk;
+        bool wrapQuirk;
+        Fault fault;
+        bool waitingForKey;
+        uint64_t executedInstructionCount;
+        uint64_t skippedInstructionCount;
+    };
 
     Interpreter();
 
     void reset();
-    void loadRom(const std::filesystem::path& romPath);
+    std::optional<std::string> loadRom(const std::filesystem::path& romPath);
+    std::optional<std::string> loadRom(const uint8_t* romData, 
+        const size_t romSize);
     void updateTimers();
     void setKey(const int key, const bool isPressed);
+    void seedRandom(const uint64_t seed);
     void setLoadStoreQuirk(const bool isEnabled);
     void setShiftQuirk(const bool isEnabled);
     void setWrapQuirk(const bool isEnabled);
-    void tick();
+    const Fault& tick();
+    const Fault& run(const int instructionCount);
+    FrameRowMask takeDirtyRows();
+    size_t saveState(uint8_t* buffer, const size_t bufferSize) const;
+    bool loadState(const uint8_t* buffer, const size_t bufferSize);
+    Fork fork();
+    void restore(const Fork& source);
 
+    std::string disassemble(const int start, const int count) const;
     std::string getDisassembledInstructions() const;
     uint8_t getRegisterValue(const int index) const;
     uint16_t getProgramCounterValue() const;
@@ -37,19 +112,69 @@ public:
     uint8_t getDelayTimerValue() const;
     uint8_t getSoundTimerValue() const;
     uint16_t getStackValue(const int index) const;
+    uint8_t getMemoryValue(const int address) const;
     const Frame& getFrame() const;
+    uint64_t getFrameGeneration() const;
+    const Fault& getFault() const;
+    bool isWaitingForKey() const;
+    uint64_t getExecutedInstructionCount() const;
+    uint64_t getSkippedInstructionCount() const;
+    uint64_t getStateHash() const;
 private:
-    std::string disassembleOpcode(const int address) const;
+    // The tick and run loops instantiated for the current quirk settings
+    struct Dispatch {
+        void (Interpreter::*tick)();
+        int (Interpreter::*run)(const int instructionCount);
+    };
+
+    void selectQuirks();
+    template <typename Quirks>
+    void tickWith();
+    template <typename Quirks>
+    int tickUntilHalted(int remaining);
+    template <typename Quirks>
+    int runWith(const int instructionCount);
+    template <typename Quirks>
+    FaultKind execute(const Operation operation, const Opcode& opcode);
+    template <typename Quirks>
+    int execute(const MicroOp& microOp);
+    int jumpUnlessSkipped(const uint16_t next, const Opcode& jump);
+    int skipIdleLoop(const Block& block, const int instructionCount);
+    bool waitForKey(const Opcode& opcode);
+    bool isHalted() const;
+    template <typename Store>
+    FaultKind runStore(const int length, Store store);
+    uint64_t hashMemory(const int address, const int length) const;
+    void invalidateCode(const int address, const int length);
+    void clearCode();
+    void raiseFault(const FaultKind kind, const Opcode& opcode);
     Memory memory;
     Registers registers;
     Stack stack;
     Frame frame;
+    FrameChanges frameChanges;
     Keypad keypad;
     Keypad prevKeypadState;
     Random random;
+    InstructionCache instructionCache;
+    BlockCache blockCache;
+    // Filled in by the const disassembly queries, so it is not part of the 
+    // observable state
+    mutable DisassemblyCache disassemblyCache;
     bool loadStoreQuirk;
     bool shiftQuirk;
     bool wrapQuirk;
+    Dispatch dispatch;
+    Fault fault;
+    bool waitingForKey;
+    uint64_t executedInstructionCount;
+    uint64_t skippedInstructionCount;
+    // The pages shared with the last fork taken or restored, with one bit 
+    // in storedPages for each page stored to since
+    std::array<std::shared_ptr<const Page>, PAGE_COUNT> pages;
+    uint16_t storedPages;
+    // XOR of a key for the value at every address, see getStateHash()
+    uint64_t memoryHash;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstdint>
+
+// Vector operations on the per-lane byte arrays of the lockstep engine. AVX2 
+// is used when the compiler targets it, SSE2 on other x86 targets, and plain 
+// bytes everywhere else. OCTACHIP_DISABLE_SIMD forces the scalar version.
+#if !defined(OCTACHIP_DISABLE_SIMD) && defined(__AVX2__)
+#define OCTACHIP_LANE_VECTOR_AVX2
+#include <immintrin.h>
+#elif !defined(OCTACHIP_DISABLE_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64))
+#define OCTACHIP_LANE_VECTOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace OCTACHIP::lanes {
+
+#if defined(OCTACHIP_LANE_VECTOR_AVX2)
+
+using Vector = __m256i;
+static constexpr int WIDTH = 32;
+
+inline Vector load(const uint8_t* bytes) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes));
+}
+
+inline void store(uint8_t* bytes, const Vector value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes), value);
+}
+
+inline Vector broadcast(const uint8_t value) {
+    return _mm256_set1_epi8(static_cast<char>(value));
+}
+
+inline Vector add(const Vector a, const Vector b) {
+    return _mm256_add_epi8(a, b);
+}
+
+inline Vector subtract(const Vector a, const Vector b) {
+    return _mm256_sub_epi8(a, b);
+}
+
+inline Vector bitAnd(const Vector a, const Vector b) {
+    return _mm256_and_si256(a, b);
+}
+
+inline Vector bitOr(const Vector a, const Vector b) {
+    return _mm256_or_si256(a, b);
+}
+
+inline Vector bitXor(const Vector a, const Vector b) {
+    return _mm256_xor_si256(a, b);
+}
+
+// Returns b with the bits set in a cleared.
+inline Vector andNot(const Vector a, const Vector b) {
+    return _mm256_andnot_si256(a, b);
+}
+
+inline Vector equal(const Vector a, const Vector b) {
+    return _mm256_cmpeq_epi8(a, b);
+}
+
+inline Vector minimum(const Vector a, const Vector b) {
+    return _mm256_min_epu8(a, b);
+}
+
+inline Vector saturatingSubtract(const Vector a, const Vector b) {
+    return _mm256_subs_epu8(a, b);
+}
+
+// Bytes are shifted as pairs, so the bits shifted in from the neighbouring 
+// byte have to be masked off.
+inline Vector shiftRight(const Vector a, const int count) {
+    return _mm256_and_si256(_mm256_srli_epi16(a, count), 
+        _mm256_set1_epi8(static_cast<char>(0xFF >> count)));
+}
+
+#elif defined(OCTACHIP_LANE_VECTOR_SSE2)
+
+using Vector = __m128i;
+static constexpr int WIDTH = 16;
+
+inline Vector load(const uint8_t* bytes) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+inline void store(uint8_t* bytes, const Vector value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), value);
+}
+
+inline Vector broadcast(const uint8_t value) {
+    return _mm_set1_epi8(static_cast<char>(value));
+}
+
+inline Vector add(const Vector a, const Vector b) {
+    return _mm_add_epi8(a, b);
+}
+
+inline Vector subtract(const Vector a, const Vector b) {
+    return _mm_sub_epi8(a, b);
+}
+
+inline Vector bitAnd(const Vector a, const Vector b) {
+    return _mm_and_si128(a, b);
+}
+
+inline Vector bitOr(const Vector a, const Vector b) {
+    return _mm_or_si128(a, b);
+}
+
+inline Vector bitXor(const Vector a, const Vector b) {
+    return _mm_xor_si128(a, b);
+}
+
+// Returns b with the bits set in a cleared.
+inline Vector andNot(const Vector a, const Vector b) {
+    return _mm_andnot_si128(a, b);
+}
+
+inline Vector equal(const Vector a, const Vector b) {
+    return _mm_cmpeq_epi8(a, b);
+}
+
+inline Vector minimum(const Vector a, const Vector b) {
+    return _mm_min_epu8(a, b);
+}
+
+inline Vector saturatingSubtract(const Vector a, const Vector b) {
+    return _mm_subs_epu8(a, b);
+}
+
+// Bytes are shifted as pairs, so the bits shifted in from the neighbouring 
+// byte have to be masked off.
+inline Vector shiftRight(const Vector a, const int count) {
+    return _mm_and_si128(_mm_srli_epi16(a, count), 
+        _mm_set1_epi8(static_cast<char>(0xFF >> count)));
+}
+
+#else
+
+using Vector = uint8_t;
+static constexpr int WIDTH = 1;
+
+inline Vector load(const uint8_t* bytes) {
+    return *bytes;
+}
+
+inline void store(uint8_t* bytes, const Vector value) {
+    *bytes = value;
+}
+
+inline Vector broadcast(const uint8_t value) {
+    return value;
+}
+
+inline Vector add(const Vector a, const Vector b) {
+    return static_cast<uint8_t>(a + b);
+}
+
+inline Vector subtract(const Vector a, const Vector b) {
+    return static_cast<uint8_t>(a - b);
+}
+
+inline Vector bitAnd(const Vector a, const Vector b) {
+    return a & b;
+}
+
+inline Vector bitOr(const Vector a, const Vector b) {
+    return a | b;
+}
+
+inline Vector bitXor(const Vector a, const Vector b) {
+    return a ^ b;
+}
+
+// Returns b with the bits set in a cleared.
+inline Vector andNot(const Vector a, const Vector b) {
+    return static_cast<uint8_t>(~a & b);
+}
+
+inline Vector equal(const Vector a, const Vector b) {
+    return a == b ? 0xFF : 0x00;
+}
+
+inline Vector minimum(const Vector a, const Vector b) {
+    return a < b ? a : b;
+}
+
+inline Vector saturatingSubtract(const Vector a, const Vector b) {
+    return a > b ? static_cast<uint8_t>(a - b) : 0;
+}
+
+inline Vector shiftRight(const Vector a, const int count) {
+    return static_cast<uint8_t>(a >> count);
+}
+
+#endif
+
+// Picks the bytes of a where the mask is set and the bytes of b elsewhere.
+inline Vector select(const Vector mask, const Vector a, const Vector b) {
+    return bitOr(bitAnd(mask, a), andNot(mask, b));
+}
+
+// Returns a mask of the bytes where a is less than b, comparing unsigned.
+inline Vector lessThan(const Vector a, const Vector b) {
+    return andNot(equal(a, b), equal(minimum(a, b), a));
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,803 @@
+#include <algorithm>
+
+#include "core/instructions.hpp"
+#include "core/interpreter.hpp"
+#include "core/lane_vector.hpp"
+#include "core/lockstep_engine.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+// Lane arrays are padded to a multiple of the widest vector, so every vector 
+// width divides the stride
+constexpr int LANE_ALIGNMENT = 32;
+static_assert(LANE_ALIGNMENT % lanes::WIDTH == 0);
+
+// Instructions that only read and write the register arrays, which can be 
+// executed for a whole group of lanes with vector operations
+bool isVectorOperation(const Operation operation) {
+    switch (operation) {
+        case Operation::JP_ADDR: 
+        case Operation::SE_VX_BYTE: 
+        case Operation::SNE_VX_BYTE: 
+        case Operation::SE_VX_VY: 
+        case Operation::LD_VX_BYTE: 
+        case Operation::ADD_VX_BYTE: 
+        case Operation::LD_VX_VY: 
+        case Operation::OR_VX_VY: 
+        case Operation::AND_VX_VY: 
+        case Operation::XOR_VX_VY: 
+        case Operation::ADD_VX_VY: 
+        case Operation::SUB_VX_VY: 
+        case Operation::SHR_VX_VY: 
+        case Operation::SUBN_VX_VY: 
+        case Operation::SHL_VX_VY: 
+        case Operation::SNE_VX_VY: 
+        case Operation::LD_I_ADDR: 
+        case Operation::SKP_VX: 
+        case Operation::SKNP_VX: 
+        case Operation::LD_VX_DT: 
+        case Operation::LD_DT_VX: 
+        case Operation::LD_ST_VX: 
+        case Operation::ADD_I_VX: 
+        case Operation::LD_F_VX: 
+            return true;
+        default: 
+            return false;
+    }
+}
+
+}
+
+LockstepEngine::LockstepEngine(const int requestedLaneCount) : 
+    laneCount{std::clamp(requestedLaneCount, 1, MAX_LANE_COUNT)}, 
+    stride{(laneCount + LANE_ALIGNMENT - 1) / LANE_ALIGNMENT *
+        LANE_ALIGNMENT}, 
+    v(Registers::V_REG_COUNT * stride), 
+    pc(stride), 
+    indexRegisters(stride), 
+    sp(stride), 
+    delayTimer(stride), 
+    soundTimer(stride), 
+    memory(laneCount), 
+    stacks(laneCount), 
+    frames(laneCount), 
+    frameChanges(laneCount), 
+    keypads(laneCount), 
+    keyMasks(stride), 
+    prevKeypadStates(laneCount), 
+    random(laneCount), 
+    faults(laneCount), 
+    waitingForKey(laneCount), 
+    halted(laneCount), 
+    executedInstructionCounts(laneCount), 
+    fetchedPc(laneCount), 
+    fetchedOpcodes(laneCount), 
+    nextInBucket(laneCount), 
+    bucketHeads(PC_BUCKET_COUNT, NO_LANE), 
+    groupLanes(laneCount), 
+    groupMask(stride), 
+    laneMask(stride), 
+    scratch(stride), 
+    storedAddresses{}, 
+    loadStoreQuirk{true}, 
+    shiftQuirk{true}, 
+    wrapQuirk{false}, 
+    lockstepInstructionCount{}, 
+    vectorGroupCount{}, 
+    scalarLaneCount{} {
+    std::fill(std::begin(laneMask), std::begin(laneMask) + laneCount, 
+        uint8_t{0xFF});
+    reset();
+}
+
+/**
+ * Resets every lane to the state of a newly reset Interpreter. The quirks are 
+ * reset to their defaults as well.
+ */
+void LockstepEngine::reset() {
+    for (int lane = 0; lane < laneCount; lane++) {
+        memory[lane].fill(0);
+        std::copy(std::begin(Interpreter::FONT_SET), 
+            std::end(Interpreter::FONT_SET), 
+            std::begin(memory[lane]) + Interpreter::FONT_START_ADDRESS);
+        stacks[lane].fill(0);
+        frames[lane].fill(0);
+        frameChanges[lane].dirtyRows = ALL_FRAME_ROWS;
+        frameChanges[lane].generation++;
+        keypads[lane].fill(false);
+        keyMasks[lane] = 0;
+        prevKeypadStates[lane].fill(false);
+        faults[lane] = {};
+        waitingForKey[lane] = false;
+        halted[lane] = false;
+        executedInstructionCounts[lane] = 0;
+    }
+    storedAddresses.reset();
+
+    std::fill(std::begin(v), std::end(v), uint8_t{0});
+    std::fill(std::begin(pc), std::end(pc), Interpreter::PROG_START_ADDRESS);
+    std::fill(std::begin(indexRegisters), std::end(indexRegisters), 
+        uint16_t{0});
+    std::fill(std::begin(sp), std::end(sp), uint8_t{0});
+    std::fill(std::begin(delayTimer), std::end(delayTimer), uint8_t{0});
+    std::fill(std::begin(soundTimer), std::end(soundTimer), uint8_t{0});
+
+    loadStoreQuirk = true;
+    shiftQuirk = true;
+    wrapQuirk = false;
+    lockstepInstructionCount = 0;
+    vectorGroupCount = 0;
+    scalarLaneCount = 0;
+}
+
+/**
+ * Loads the same ROM image into the memory of every lane. Returns a 
+ * description of the error if the ROM could not be loaded.
+ */
+std::optional<std::string> LockstepEngine::loadRom(const uint8_t* romData, 
+    const size_t romSize) {
+    const size_t maxRomSize = MEMORY_SIZE - Interpreter::PROG_START_ADDRESS;
+
+    if (romSize > maxRomSize) {
+        return "ROM exceeds maximum size (current size: " + 
+            std::to_string(romSize) + " bytes, maximum size: " + 
+            std::to_string(maxRomSize) + " bytes)";
+    }
+
+    storedAddresses.reset();
+    for (int lane = 0; lane < laneCount; lane++) {
+        faults[lane] = {};
+        waitingForKey[lane] = false;
+        halted[lane] = false;
+        std::copy(romData, romData + romSize, 
+            std::begin(memory[lane]) + Interpreter::PROG_START_ADDRESS);
+    }
+
+    return std::nullopt;
+}
+
+void LockstepEngine::updateTimers() {
+    const lanes::Vector one = lanes::broadcast(1);
+
+    for (int lane = 0; lane < stride; lane += lanes::WIDTH) {
+        lanes::store(&delayTimer[lane], lanes::saturatingSubtract(
+            lanes::load(&delayTimer[lane]), one));
+        lanes::store(&soundTimer[lane], lanes::saturatingSubtract(
+            lanes::load(&soundTimer[lane]), one));
+    }
+}
+
+// Makes the values drawn by Cxkk on a lane reproducible from the given seed.
+void LockstepEngine::seedRandom(const int lane, const uint64_t seed) {
+    if (lane >= 0 && lane < laneCount) {
+        random[lane].seed(seed);
+    }
+}
+
+void LockstepEngine::setKey(const int lane, const int key, 
+    const bool isPressed) {
+    if (lane < 0 || lane >= laneCount || key < 0 || key >= KEY_COUNT) {
+        return;
+    }
+    if (keypads[lane][key] != isPressed) {
+        keypads[lane][key] = isPressed;
+        keyMasks[lane] ^= 1 << key;
+        waitingForKey[lane] = false;
+        halted[lane] = faults[lane].kind != FaultKind::NONE;
+    }
+}
+
+void LockstepEngine::setLoadStoreQuirk(const bool isEnabled) {
+    loadStoreQuirk = isEnabled;
+}
+
+void LockstepEngine::setShiftQuirk(const bool isEnabled) {
+    shiftQuirk = isEnabled;
+}
+
+void LockstepEngine::setWrapQuirk(const bool isEnabled) {
+    wrapQuirk = isEnabled;
+}
+
+/**
+ * Executes a single instruction on every lane that is not halted. The lanes 
+ * are bucketed by program counter, and each bucket is split into groups of 
+ * lanes that fetched the same opcode, since lanes can modify their own code.
+ */
+void LockstepEngine::tick() {
+    if (tickInLockstep()) {
+        return;
+    }
+
+    for (int lane = laneCount - 1; lane >= 0; lane--) {
+        if (halted[lane]) {
+            fetchedPc[lane] = NO_ADDRESS;
+            continue;
+        }
+
+        const uint16_t address = pc[lane];
+        fetchedPc[lane] = address;
+        fetchedOpcodes[lane] = address < MEMORY_SIZE - 1 ?
+            memory[lane][address] << 8 | memory[lane][address + 1] : 0;
+        nextInBucket[lane] = bucketHeads[address];
+        bucketHeads[address] = static_cast<uint16_t>(lane);
+    }
+
+    for (int lane = 0; lane < laneCount; lane++) {
+        if (fetchedPc[lane] == NO_ADDRESS) {
+            continue;
+        }
+
+        const uint16_t address = fetchedPc[lane];
+        const Opcode opcode = fetchedOpcodes[lane];
+        const Operation operation = address < MEMORY_SIZE - 1 ?
+            decode(opcode) : Operation::PC_OUT_OF_BOUNDS;
+        executeGroup(collectGroup(lane), operation, opcode);
+    }
+}
+
+// Executes up to the given number of instructions on every lane.
+void LockstepEngine::run(const int instructionCount) {
+    for (int instruction = 0; instruction < instructionCount; instruction++) {
+        tick();
+    }
+}
+
+/**
+ * Executes the next instruction on every lane at once if all of them are 
+ * running and share a program counter, the instruction can be vectorized, and 
+ * no lane has stored to its address, which guarantees that every lane fetches 
+ * the same opcode. Returns whether the instruction was executed.
+ */
+bool LockstepEngine::tickInLockstep() {
+    const uint16_t address = pc[0];
+    int divergence = 0;
+    for (int lane = 0; lane < laneCount; lane++) {
+        divergence |= (pc[lane] ^ address) | halted[lane];
+    }
+    if (divergence != 0 || address >= MEMORY_SIZE - 1 || 
+        storedAddresses[address] || storedAddresses[address + 1]) {
+        return false;
+    }
+
+    const Opcode opcode = memory[0][address] << 8 | memory[0][address + 1];
+    const Operation operation = decode(opcode);
+    if (!isVectorOperation(operation)) {
+        return false;
+    }
+
+    executeVector(operation, opcode, laneMask.data());
+    lockstepInstructionCount++;
+    vectorGroupCount++;
+    return true;
+}
+
+uint8_t* LockstepEngine::registerLanes(const int index) {
+    return &v[index * stride];
+}
+
+/**
+ * Removes the lanes that fetched the same instruction as the leader from its 
+ * bucket and lists them in groupLanes. Returns the number of lanes in the 
+ * group. Lanes at the same address that fetched a different opcode are left 
+ * in the bucket for a later group.
+ */
+int LockstepEngine::collectGroup(const int leader) {
+    const uint16_t opcode = fetchedOpcodes[leader];
+    uint16_t* link = &bucketHeads[fetchedPc[leader]];
+    int memberCount = 0;
+
+    while (*link != NO_LANE) {
+        const uint16_t lane = *link;
+        if (fetchedOpcodes[lane] == opcode) {
+            groupLanes[memberCount++] = lane;
+            fetchedPc[lane] = NO_ADDRESS;
+            *link = nextInBucket[lane];
+        } else {
+            link = &nextInBucket[lane];
+        }
+    }
+    return memberCount;
+}
+
+/**
+ * Executes one instruction for the lanes in groupLanes. A vector pass touches 
+ * every lane, so it is only used when the group has more lanes than there 
+ * are vectors in a lane array.
+ */
+void LockstepEngine::executeGroup(const int memberCount, 
+    const Operation operation, const Opcode& opcode) {
+    if (memberCount > stride / lanes::WIDTH && isVectorOperation(operation)) {
+        for (int member = 0; member < memberCount; member++) {
+            groupMask[groupLanes[member]] = 0xFF;
+        }
+        executeVector(operation, opcode, groupMask.data());
+        for (int member = 0; member < memberCount; member++) {
+            const int lane = groupLanes[member];
+            groupMask[lane] = 0x00;
+            executedInstructionCounts[lane]++;
+        }
+        vectorGroupCount++;
+        return;
+    }
+
+    for (int member = 0; member < memberCount; member++) {
+        executeLane(groupLanes[member], operation, opcode);
+    }
+    scalarLaneCount += memberCount;
+}
+
+/**
+ * Executes an instruction for the lanes set in the mask. Each statement of 
+ * the scalar instruction becomes a separate masked pass over the lanes, so 
+ * the result is the same when its operands are the same register.
+ */
+void LockstepEngine::executeVector(const Operation operation, 
+    const Opcode& opcode, const uint8_t* mask) {
+    using namespace lanes;
+
+    uint8_t* vx = registerLanes(opcode.x());
+    uint8_t* vy = registerLanes(opcode.y());
+    uint8_t* vf = registerLanes(0xF);
+    const Vector one = broadcast(1);
+    const Vector two = broadcast(2);
+
+    // Stores the value computed for each vector into the group's lanes of the 
+    // destination array
+    const auto assign = [this, mask](uint8_t* destination, 
+        const auto& compute) {
+        forEachVector([destination, mask, &compute](const int lane) {
+            store(destination + lane, select(load(mask + lane), 
+                compute(lane), load(destination + lane)));
+        });
+    };
+
+    // Skips set the increment of each lane to 4 if the condition holds
+    const auto skipIf = [this, mask, two](const auto& condition) {
+        forEachVector([this, mask, two, &condition](const int lane) {
+            store(&scratch[lane], bitAnd(load(mask + lane), 
+                add(two, bitAnd(condition(lane), two))));
+        });
+        advanceProgramCounters(scratch.data(), 0xFF);
+    };
+
+    switch (operation) {
+        case Operation::JP_ADDR: 
+            for (int lane = 0; lane < stride; lane++) {
+                pc[lane] = mask[lane] ? opcode.address() : pc[lane];
+            }
+            return;
+        case Operation::SE_VX_BYTE: {
+            const Vector byte = broadcast(opcode.byte());
+            skipIf([vx, byte](const int lane) {
+                return equal(load(vx + lane), byte);
+            });
+            return;
+        }
+        case Operation::SNE_VX_BYTE: {
+            const Vector byte = broadcast(opcode.byte());
+            skipIf([vx, byte](const int lane) {
+                return andNot(equal(load(vx + lane), byte), broadcast(0xFF));
+            });
+            return;
+        }
+        case Operation::SE_VX_VY: 
+            skipIf([vx, vy](const int lane) {
+                return equal(load(vx + lane), load(vy + lane));
+            });
+            return;
+        case Operation::SNE_VX_VY: 
+            skipIf([vx, vy](const int lane) {
+                return andNot(equal(load(vx + lane), load(vy + lane)), 
+                    broadcast(0xFF));
+            });
+            return;
+        case Operation::SKP_VX: 
+        case Operation::SKNP_VX: {
+            // Keys above 0xF are never pressed
+            const int expected = operation == Operation::SKP_VX ? 1 : 0;
+            for (int lane = 0; lane < stride; lane++) {
+                const int isPressed = vx[lane] < KEY_COUNT ? 
+                    keyMasks[lane] >> vx[lane] & 1 : 0;
+                scratch[lane] = mask[lane] & 
+                    (isPressed == expected ? 4 : 2);
+            }
+            advanceProgramCounters(scratch.data(), 0xFF);
+            return;
+        }
+        case Operation::LD_VX_BYTE: {
+            const Vector byte = broadcast(opcode.byte());
+            assign(vx, [byte](const int) { return byte; });
+            break;
+        }
+        case Operation::ADD_VX_BYTE: {
+            const Vector byte = broadcast(opcode.byte());
+            assign(vx, [vx, byte](const int lane) {
+                return add(load(vx + lane), byte);
+            });
+            break;
+        }
+        case Operation::LD_VX_VY: 
+            assign(vx, [vy](const int lane) { return load(vy + lane); });
+            break;
+        case Operation::OR_VX_VY: 
+            assign(vx, [vx, vy](const int lane) {
+                return bitOr(load(vx + lane), load(vy + lane));
+            });
+            break;
+        case Operation::AND_VX_VY: 
+            assign(vx, [vx, vy](const int lane) {
+                return bitAnd(load(vx + lane), load(vy + lane));
+            });
+            break;
+        case Operation::XOR_VX_VY: 
+            assign(vx, [vx, vy](const int lane) {
+                return bitXor(load(vx + lane), load(vy + lane));
+            });
+            break;
+        case Operation::ADD_VX_VY: 
+            // The carry is kept in the scratch array, since Vx may be VF
+            forEachVector([this, vx, vy, one](const int lane) {
+                const Vector sum = add(load(vx + lane), load(vy + lane));
+                store(&scratch[lane], 
+                    bitAnd(lessThan(sum, load(vx + lane)), one));
+            });
+            assign(vx, [vx, vy](const int lane) {
+                return add(load(vx + lane), load(vy + lane));
+            });
+            assign(vf, [this](const int lane) {
+                return load(&scratch[lane]);
+            });
+            break;
+        case Operation::SUB_VX_VY: 
+            forEachVector([this, vx, vy, one](const int lane) {
+                store(&scratch[lane], andNot(
+                    lessThan(load(vx + lane), load(vy + lane)), one));
+            });
+            assign(vx, [vx, vy](const int lane) {
+                return subtract(load(vx + lane), load(vy + lane));
+            });
+            assign(vf, [this](const int lane) {
+                return load(&scratch[lane]);
+            });
+            break;
+        case Operation::SUBN_VX_VY: 
+            forEachVector([this, vx, vy, one](const int lane) {
+                store(&scratch[lane], andNot(
+                    lessThan(load(vy + lane), load(vx + lane)), one));
+            });
+            assign(vx, [vx, vy](const int lane) {
+                return subtract(load(vy + lane), load(vx + lane));
+            });
+            assign(vf, [this](const int lane) {
+                return load(&scratch[lane]);
+            });
+            break;
+        case Operation::SHR_VX_VY: 
+            if (!shiftQuirk) {
+                assign(vx, [vy](const int lane) { return load(vy + lane); });
+            }
+            assign(vf, [vx, one](const int lane) {
+                return bitAnd(load(vx + lane), one);
+            });
+            assign(vx, [vx](const int lane) {
+                return shiftRight(load(vx + lane), 1);
+            });
+            break;
+        case Operation::SHL_VX_VY: 
+            if (!shiftQuirk) {
+                assign(vx, [vy](const int lane) { return load(vy + lane); });
+            }
+            assign(vf, [vx](const int lane) {
+                return shiftRight(load(vx + lane), 7);
+            });
+            assign(vx, [vx](const int lane) {
+                return add(load(vx + lane), load(vx + lane));
+            });
+            break;
+        case Operation::LD_I_ADDR: 
+            for (int lane = 0; lane < stride; lane++) {
+                indexRegisters[lane] = mask[lane] ? opcode.address() : 
+                    indexRegisters[lane];
+            }
+            break;
+        case Operation::LD_VX_DT: 
+            assign(vx, [this](const int lane) {
+                return load(&delayTimer[lane]);
+            });
+            break;
+        case Operation::LD_DT_VX: 
+            assign(delayTimer.data(), [vx](const int lane) {
+                return load(vx + lane);
+            });
+            break;
+        case Operation::LD_ST_VX: 
+            assign(soundTimer.data(), [vx](const int lane) {
+                return load(vx + lane);
+            });
+            break;
+        case Operation::ADD_I_VX: 
+            for (int lane = 0; lane < stride; lane++) {
+                indexRegisters[lane] += mask[lane] & vx[lane];
+            }
+            break;
+        case Operation::LD_F_VX: 
+            for (int lane = 0; lane < stride; lane++) {
+                indexRegisters[lane] = mask[lane] ? 
+                    Interpreter::FONT_START_ADDRESS + 
+                    Interpreter::FONT_CHAR_SIZE * vx[lane] : 
+                    indexRegisters[lane];
+            }
+            break;
+        default: 
+            break;
+    }
+    advanceProgramCounters(mask, 2);
+}
+
+/**
+ * Executes an instruction for a single lane with the same instruction 
+ * handlers as the Interpreter, on a copy of the lane's registers.
+ */
+void LockstepEngine::executeLane(const int lane, const Operation operation, 
+    const Opcode& opcode) {
+    Registers registers{};
+    for (int index = 0; index < Registers::V_REG_COUNT; index++) {
+        registers.v[index] = v[index * stride + lane];
+    }
+    registers.pc = pc[lane];
+    registers.i = indexRegisters[lane];
+    registers.sp = sp[lane];
+    registers.delayTimer = delayTimer[lane];
+    registers.soundTimer = soundTimer[lane];
+
+    registers.pc += 2;
+
+    const FaultKind faultKind = execute(lane, registers, operation, opcode);
+    if (faultKind != FaultKind::NONE) {
+        registers.pc -= 2;
+        faults[lane] = {faultKind, registers.pc, opcode.full()};
+    }
+
+    for (int index = 0; index < Registers::V_REG_COUNT; index++) {
+        v[index * stride + lane] = registers.v[index];
+    }
+    pc[lane] = registers.pc;
+    indexRegisters[lane] = registers.i;
+    sp[lane] = registers.sp;
+    delayTimer[lane] = registers.delayTimer;
+    soundTimer[lane] = registers.soundTimer;
+
+    halted[lane] = faultKind != FaultKind::NONE || waitingForKey[lane];
+    if (!halted[lane]) {
+        executedInstructionCounts[lane]++;
+    }
+}
+
+FaultKind LockstepEngine::execute(const int lane, Registers& registers, 
+    const Operation operation, const Opcode& opcode) {
+    switch (operation) {
+        case Operation::CLS: 
+            instructions::CLS(frames[lane], frameChanges[lane]);
+            break;
+        case Operation::RET: 
+            return instructions::RET(registers, stacks[lane]);
+        case Operation::JP_ADDR: 
+            instructions::JP_ADDR(opcode, registers);
+            break;
+        case Operation::CALL_ADDR: 
+            return instructions::CALL_ADDR(opcode, registers, stacks[lane]);
+        case Operation::SE_VX_BYTE: 
+            instructions::SE_VX_BYTE(opcode, registers);
+            break;
+        case Operation::SNE_VX_BYTE: 
+            instructions::SNE_VX_BYTE(opcode, registers);
+            break;
+        case Operation::SE_VX_VY: 
+            instructions::SE_VX_VY(opcode, registers);
+            break;
+        case Operation::LD_VX_BYTE: 
+            instructions::LD_VX_BYTE(opcode, registers);
+            break;
+        case Operation::ADD_VX_BYTE: 
+            instructions::ADD_VX_BYTE(opcode, registers);
+            break;
+        case Operation::LD_VX_VY: 
+            instructions::LD_VX_VY(opcode, registers);
+            break;
+        case Operation::OR_VX_VY: 
+            instructions::OR_VX_VY(opcode, registers);
+            break;
+        case Operation::AND_VX_VY: 
+            instructions::AND_VX_VY(opcode, registers);
+            break;
+        case Operation::XOR_VX_VY: 
+            instructions::XOR_VX_VY(opcode, registers);
+            break;
+        case Operation::ADD_VX_VY: 
+            instructions::ADD_VX_VY(opcode, registers);
+            break;
+        case Operation::SUB_VX_VY: 
+            instructions::SUB_VX_VY(opcode, registers);
+            break;
+        case Operation::SHR_VX_VY: 
+            if (shiftQuirk) {
+                instructions::SHR_VX_VY<true>(opcode, registers);
+            } else {
+                instructions::SHR_VX_VY<false>(opcode, registers);
+            }
+            break;
+        case Operation::SUBN_VX_VY: 
+            instructions::SUBN_VX_VY(opcode, registers);
+            break;
+        case Operation::SHL_VX_VY: 
+            if (shiftQuirk) {
+                instructions::SHL_VX_VY<true>(opcode, registers);
+            } else {
+                instructions::SHL_VX_VY<false>(opcode, registers);
+            }
+            break;
+        case Operation::SNE_VX_VY: 
+            instructions::SNE_VX_VY(opcode, registers);
+            break;
+        case Operation::LD_I_ADDR: 
+            instructions::LD_I_ADDR(opcode, registers);
+            break;
+        case Operation::JP_V0_ADDR: 
+            instructions::JP_V0_ADDR(opcode, registers);
+            break;
+        case Operation::RND_VX_BYTE: 
+            instructions::RND_VX_BYTE(opcode, registers, random[lane]);
+            break;
+        case Operation::DRW_VX_VY_NIBBLE: 
+            if (wrapQuirk) {
+                return instructions::DRW_VX_VY_NIBBLE<true>(opcode, 
+                    memory[lane], registers, frames[lane], frameChanges[lane]);
+            }
+            return instructions::DRW_VX_VY_NIBBLE<false>(opcode, 
+                memory[lane], registers, frames[lane], frameChanges[lane]);
+        case Operation::SKP_VX: 
+            instructions::SKP_VX(opcode, registers, keypads[lane]);
+            break;
+        case Operation::SKNP_VX: 
+            instructions::SKNP_VX(opcode, registers, keypads[lane]);
+            break;
+        case Operation::LD_VX_DT: 
+            instructions::LD_VX_DT(opcode, registers);
+            break;
+        case Operation::LD_VX_K: 
+            waitingForKey[lane] = instructions::LD_VX_K(opcode, registers, 
+                keypads[lane], prevKeypadStates[lane]);
+            break;
+        case Operation::LD_DT_VX: 
+            instructions::LD_DT_VX(opcode, registers);
+            break;
+        case Operation::LD_ST_VX: 
+            instructions::LD_ST_VX(opcode, registers);
+            break;
+        case Operation::ADD_I_VX: 
+            instructions::ADD_I_VX(opcode, registers);
+            break;
+        case Operation::LD_F_VX: 
+            instructions::LD_F_VX(opcode, registers);
+            break;
+        case Operation::LD_B_VX: 
+            markStored(registers.i, 3);
+            return instructions::LD_B_VX(opcode, memory[lane], registers);
+        case Operation::LD_I_VX: 
+            markStored(registers.i, opcode.x() + 1);
+            if (loadStoreQuirk) {
+                return instructions::LD_I_VX<true>(opcode, memory[lane], 
+                    registers);
+            }
+            return instructions::LD_I_VX<false>(opcode, memory[lane], 
+                registers);
+        case Operation::LD_VX_I: 
+            if (loadStoreQuirk) {
+                return instructions::LD_VX_I<true>(opcode, memory[lane], 
+                    registers);
+            }
+            return instructions::LD_VX_I<false>(opcode, memory[lane], 
+                registers);
+        case Operation::PC_OUT_OF_BOUNDS: 
+            return FaultKind::PC_OUT_OF_BOUNDS;
+        default: 
+            return instructions::ILLEGAL_OPCODE(opcode);
+    }
+    return FaultKind::NONE;
+}
+
+// Records that some lane may have written the given range of its memory.
+void LockstepEngine::markStored(const int address, const int length) {
+    const int end = std::min(address + length, MEMORY_SIZE);
+    for (int stored = address; stored < end; stored++) {
+        storedAddresses.set(stored);
+    }
+}
+
+void LockstepEngine::advanceProgramCounters(const uint8_t* increments, 
+    const uint8_t incrementMask) {
+    for (int lane = 0; lane < stride; lane++) {
+        pc[lane] += increments[lane] & incrementMask;
+    }
+}
+
+template <typename Kernel>
+void LockstepEngine::forEachVector(Kernel kernel) {
+    for (int lane = 0; lane < stride; lane += lanes::WIDTH) {
+        kernel(lane);
+    }
+}
+
+int LockstepEngine::getLaneCount() const {
+    return laneCount;
+}
+
+uint8_t LockstepEngine::getRegisterValue(const int lane, 
+    const int index) const {
+    if (lane < 0 || lane >= laneCount || index < 0 || 
+        index >= Registers::V_REG_COUNT) {
+        return 0;
+    }
+    return v[index * stride + lane];
+}
+
+uint16_t LockstepEngine::getProgramCounterValue(const int lane) const {
+    return lane >= 0 && lane < laneCount ? pc[lane] : 0;
+}
+
+uint16_t LockstepEngine::getIndexRegisterValue(const int lane) const {
+    return lane >= 0 && lane < laneCount ? indexRegisters[lane] : 0;
+}
+
+uint8_t LockstepEngine::getStackPointerValue(const int lane) const {
+    return lane >= 0 && lane < laneCount ? sp[lane] : 0;
+}
+
+uint8_t LockstepEngine::getDelayTimerValue(const int lane) const {
+    return lane >= 0 && lane < laneCount ? delayTimer[lane] : 0;
+}
+
+uint8_t LockstepEngine::getSoundTimerValue(const int lane) const {
+    return lane >= 0 && lane < laneCount ? soundTimer[lane] : 0;
+}
+
+uint16_t LockstepEngine::getStackValue(const int lane, const int index) const {
+    if (lane < 0 || lane >= laneCount || index < 0 || index >= STACK_SIZE) {
+        return 0;
+    }
+    return stacks[lane][index];
+}
+
+const Frame& LockstepEngine::getFrame(const int lane) const {
+    return frames[lane];
+}
+
+const Fault& LockstepEngine::getFault(const int lane) const {
+    return faults[lane];
+}
+
+bool LockstepEngine::isWaitingForKey(const int lane) const {
+    return waitingForKey[lane];
+}
+
+/**
+ * Returns the number of instructions the lane has executed since the engine 
+ * was reset. An instruction the lane halted on is not counted until it 
+ * completes.
+ */
+uint64_t LockstepEngine::getExecutedInstructionCount(const int lane) const {
+    return executedInstructionCounts[lane] + lockstepInstructionCount;
+}
+
+// Returns the number of lane groups that were executed with vector operations.
+uint64_t LockstepEngine::getVectorGroupCount() const {
+    return vectorGroupCount;
+}
+
+// Returns the number of lane steps that were executed one lane at a time.
+uint64_t LockstepEngine::getScalarLaneCount() const {
+    return scalarLaneCount;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/fault.hpp"
+#include "core/instruction_cache.hpp"
+#include "core/opcode.hpp"
+#include "core/random.hpp"
+#include "core/types.hpp"
+
+namespace OCTACHIP {
+
+/**
+ * Runs many copies of the same program in lockstep, one machine per lane. The 
+ * V registers, program counters, index registers and timers are stored as 
+ * structure-of-arrays, so lanes executing the same instruction are stepped 
+ * together with vector operations. Lanes are grouped by program counter and 
+ * opcode on every step; small groups left by diverging control flow, and 
+ * instructions that touch memory, the stack or the display, are executed one 
+ * lane at a time. Every lane produces the same results as an Interpreter 
+ * given the same inputs and random seed.
+ */
+class LockstepEngine {
+public:
+    // Lane numbers must fit in the 16-bit links between lanes that share a 
+    // program counter
+    static constexpr int MAX_LANE_COUNT = 4096;
+
+    explicit LockstepEngine(const int requestedLaneCount);
+
+    void reset();
+    std::optional<std::string> loadRom(const uint8_t* romData, 
+        const size_t romSize);
+    void updateTimers();
+    void seedRandom(const int lane, const uint64_t seed);
+    void setKey(const int lane, const int key, const bool isPressed);
+    void setLoadStoreQuirk(const bool isEnabled);
+    void setShiftQuirk(const bool isEnabled);
+    void setWrapQuirk(const bool isEnabled);
+    void tick();
+    void run(const int instructionCount);
+
+    int getLaneCount() const;
+    uint8_t getRegisterValue(const int lane, const int index) const;
+    uint16_t getProgramCounterValue(const int lane) const;
+    uint16_t getIndexRegisterValue(const int lane) const;
+    uint8_t getStackPointerValue(const int lane) const;
+    uint8_t getDelayTimerValue(const int lane) const;
+    uint8_t getSoundTimerValue(const int lane) const;
+    uint16_t getStackValue(const int lane, const int index) const;
+    const Frame& getFrame(const int lane) const;
+    const Fault& getFault(const int lane) const;
+    bool isWaitingForKey(const int lane) const;
+    uint64_t getExecutedInstructionCount(const int lane) const;
+    uint64_t getVectorGroupCount() const;
+    uint64_t getScalarLaneCount() const;
+private:
+    // No lane can fetch from beyond 0xFFF + 0xFF, the furthest Bnnn can jump
+    static constexpr int PC_BUCKET_COUNT = MEMORY_SIZE + 0x100;
+    static constexpr uint16_t NO_LANE = 0xFFFF;
+    static constexpr uint16_t NO_ADDRESS = 0xFFFF;
+
+    bool tickInLockstep();
+    uint8_t* registerLanes(const int index);
+    int collectGroup(const int leader);
+    void executeGroup(const int memberCount, const Operation operation, 
+        const Opcode& opcode);
+    void executeVector(const Operation operation, const Opcode& opcode, 
+        const uint8_t* mask);
+    void executeLane(const int lane, const Operation operation, 
+        const Opcode& opcode);
+    FaultKind execute(const int lane, Registers& registers, 
+        const Operation operation, const Opcode& opcode);
+    void markStored(const int address, const int length);
+    void advanceProgramCounters(const uint8_t* increments, 
+        const uint8_t incrementMask);
+    template <typename Kernel>
+    void forEachVector(Kernel kernel);
+
+    const int laneCount;
+    // Lane arrays are padded to a whole number of vectors
+    const int stride;
+
+    std::vector<uint8_t> v;
+    std::vector<uint16_t> pc;
+    std::vector<uint16_t> indexRegisters;
+    std::vector<uint8_t> sp;
+    std::vector<uint8_t> delayTimer;
+    std::vector<uint8_t> soundTimer;
+    std::vector<Memory> memory;
+    std::vector<Stack> stacks;
+    std::vector<Frame> frames;
+    std::vector<FrameChanges> frameChanges;
+    std::vector<Keypad> keypads;
+    // The keypad of each lane with one bit per key, for vectorized key skips
+    std::vector<uint16_t> keyMasks;
+    std::vector<Keypad> prevKeypadStates;
+    std::vector<Random> random;
+    std::vector<Fault> faults;
+    std::vector<uint8_t> waitingForKey;
+    std::vector<uint8_t> halted;
+    std::vector<uint64_t> executedInstructionCounts;
+
+    // Scratch state for grouping the lanes on each step
+    std::vector<uint16_t> fetchedPc;
+    std::vector<uint16_t> fetchedOpcodes;
+    std::vector<uint16_t> nextInBucket;
+    std::vector<uint16_t> bucketHeads;
+    std::vector<uint16_t> groupLanes;
+    std::vector<uint8_t> groupMask;
+    // Selects every lane, leaving out the padding
+    std::vector<uint8_t> laneMask;
+    std::vector<uint8_t> scratch;
+    // Addresses that any lane has stored to, where lanes may hold different 
+    // code
+    std::bitset<MEMORY_SIZE> storedAddresses;
+
+    bool loadStoreQuirk;
+    bool shiftQuirk;
+    bool wrapQuirk;
+    // Instructions executed by every lane at once, which are not added to 
+    // the count of each lane
+    uint64_t lockstepInstructionCount;
+    uint64_t vectorGroupCount;
+    uint64_t scalarLaneCount;
+};
+
+}
\ No newline at end of file
@@ -2,26 +2,32 @@
 
 using namespace OCTACHIP;
 
-Opcode::Opcode(const uint16_t instructionCode) : opcode{instructionCode} {}
+Opcode::Opcode(const uint16_t instructionCode) : 
+    opcode{instructionCode},
+    addressField{static_cast<uint16_t>(instructionCode & 0x0FFF)},
+    xField{static_cast<uint8_t>((instructionCode & 0x0F00) >> 8)},
+    yField{static_cast<uint8_t>((instructionCode & 0x00F0) >> 4)},
+    nibbleField{static_cast<uint8_t>(instructionCode & 0x000F)},
+    byteField{static_cast<uint8_t>(instructionCode & 0x00FF)} {}
 
 uint8_t Opcode::x() const {
-    return (opcode & 0x0F00) >> 8;
+    return xField;
 }
 
 uint8_t Opcode::y() const {
-    return (opcode & 0x00F0) >> 4;
+    return yField;
 }
 
 uint8_t Opcode::nibble() const {
-    return opcode & 0x000F;
+    return nibbleField;
 }
 
 uint8_t Opcode::byte() const {
-    return opcode & 0x00FF;
+    return byteField;
 }
 
 uint16_t Opcode::address() const {
-    return opcode & 0x0FFF;
+    return addressField;
 }
 
 uint8_t Opcode::prefix() const {
@@ -15,7 +15,14 @@ public:
     uint8_t prefix() const;
     uint16_t full() const;
 private:
+    // Operand fields are extracted once on construction so that predecoded 
+    // instructions can be executed without re-masking the raw opcode.
     uint16_t opcode;
+    uint16_t addressField;
+    uint8_t xField;
+    uint8_t yField;
+    uint8_t nibbleField;
+    uint8_t byteField;
 };
 
 }
\ No newline at end of file
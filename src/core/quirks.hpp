@@ -0,0 +1,22 @@
+#pragma once
+
+namespace OCTACHIP {
+
+/**
+ * Compile-time selection of the behaviors that differ between CHIP-8 
+ * implementations. The interpreter is instantiated once per combination, so 
+ * the instructions it executes never test a quirk at runtime.
+ * 
+ * - LoadStore: Fx55 and Fx65 leave I unchanged instead of incrementing it
+ * - Shift: 8xy6 and 8xyE shift Vx in place instead of copying Vy into it first
+ * - Wrap: sprites drawn past the edge of the display wrap around instead of 
+ *   being clipped
+ */
+template <bool LoadStore, bool Shift, bool Wrap>
+struct QuirkPolicy {
+    static constexpr bool loadStore = LoadStore;
+    static constexpr bool shift = Shift;
+    static constexpr bool wrap = Wrap;
+};
+
+}
\ No newline at end of file
@@ -1,14 +1,33 @@
-#include <limits>
+#include <random>
 
 #include "core/random.hpp"
 
 using namespace OCTACHIP;
 
-Random::Random() :
-    engine{std::random_device{}()},
-    distribution{std::numeric_limits<uint8_t>::min(),
-        std::numeric_limits<uint8_t>::max()} {}
+// Seeds the generator from the system's source of randomness.
+Random::Random() : 
+    state{} {
+    std::random_device device{};
+    seed(static_cast<uint64_t>(device()) << 32 | device());
+}
 
-uint8_t Random::generateNumber() {
-    return static_cast<uint8_t>(distribution(engine));
+Random::Random(const uint64_t seedValue) : 
+    state{} {
+    seed(seedValue);
+}
+
+// Restarts the sequence of generated numbers from the given seed.
+void Random::seed(const uint64_t value) {
+    state = 0;
+    generateNumber();
+    state += value;
+    generateNumber();
+}
+
+uint64_t Random::getState() const {
+    return state;
+}
+
+void Random::setState(const uint64_t value) {
+    state = value;
 }
\ No newline at end of file
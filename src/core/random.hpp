@@ -1,17 +1,42 @@
 #pragma once
 
-#include <random>
+#include <cstdint>
 
 namespace OCTACHIP {
 
+/**
+ * PCG32 generator for Cxkk. Its whole state is a single 64-bit word, so 
+ * instances are cheap to copy and seeding one makes every value it draws 
+ * reproducible. generateNumber() is defined here so that it can be inlined 
+ * into the instruction handlers.
+ */
 class Random {
 public:
     Random();
-    virtual ~Random() = default;
-    virtual uint8_t generateNumber();
+    explicit Random(const uint64_t seedValue);
+
+    void seed(const uint64_t value);
+    uint64_t getState() const;
+    void setState(const uint64_t value);
+
+    uint8_t generateNumber() {
+        const uint64_t oldState = state;
+        state = oldState * MULTIPLIER + INCREMENT;
+
+        // Output permutation XSH RR: an xorshift of the high bits, followed 
+        // by a rotation selected by the top 5 bits of the old state
+        const uint32_t shifted = 
+            static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+        const uint32_t rotation = static_cast<uint32_t>(oldState >> 59);
+        const uint32_t output = 
+            (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+        return static_cast<uint8_t>(output >> 24);
+    }
 private:
-    std::mt19937 engine;
-    std::uniform_int_distribution<unsigned int> distribution;
+    static constexpr uint64_t MULTIPLIER = 6364136223846793005u;
+    static constexpr uint64_t INCREMENT = 1442695040888963407u;
+
+    uint64_t state;
 };
 
 }
\ No newline at end of file
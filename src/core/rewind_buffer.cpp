@@ -0,0 +1,285 @@
+#include <algorithm>
+
+#include "core/rewind_buffer.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+void writeSize(uint8_t* bytes, const size_t size) {
+    bytes[0] = static_cast<uint8_t>(size);
+    bytes[1] = static_cast<uint8_t>(size >> 8);
+}
+
+size_t readSize(const uint8_t* bytes) {
+    return static_cast<size_t>(bytes[0] | bytes[1] << 8);
+}
+
+}
+
+/**
+ * Allocates a ring of the given capacity in bytes, raised if needed so that 
+ * it always holds at least two frames.
+ */
+RewindBuffer::RewindBuffer(const size_t capacity, 
+    const int requestedKeyframeInterval) : 
+    keyframeInterval{std::max(requestedKeyframeInterval, 1)}, 
+    storage(std::max(capacity, 2 * MAX_ENTRY_SIZE)), 
+    frameCount{0}, 
+    oldestEntry{0}, 
+    newestEntry{0}, 
+    head{0}, 
+    wrapped{false}, 
+    wrapEnd{0}, 
+    usedBytes{0}, 
+    framesSinceKeyframe{0}, 
+    newestState{}, 
+    state{}, 
+    payload{} {}
+
+/**
+ * Appends the current state of the interpreter, dropping the oldest frames 
+ * if there is no room left for it.
+ */
+void RewindBuffer::record(const Interpreter& interpreter) {
+    interpreter.saveState(state.data(), state.size());
+
+    bool keyframe = frameCount == 0 || 
+        framesSinceKeyframe + 1 >= keyframeInterval;
+    size_t payloadSize = 0;
+    size_t offset = 0;
+    if (!keyframe) {
+        payloadSize = encode(newestState);
+        offset = allocate(ENTRY_HEADER_SIZE + payloadSize + ENTRY_FOOTER_SIZE);
+        // Making room may have dropped the frame the state was encoded 
+        // against
+        keyframe = frameCount == 0;
+    }
+
+    if (keyframe) {
+        newestState.fill(0);
+        payloadSize = encode(newestState);
+        offset = allocate(ENTRY_HEADER_SIZE + payloadSize + ENTRY_FOOTER_SIZE);
+        framesSinceKeyframe = 0;
+    } else {
+        framesSinceKeyframe++;
+    }
+
+    append(offset, payloadSize, keyframe);
+    newestState = state;
+}
+
+/**
+ * Drops the newest frame and restores the interpreter to the one recorded 
+ * before it, which becomes the newest. Returns false if there is no earlier 
+ * frame to go back to.
+ */
+bool RewindBuffer::rewind(Interpreter& interpreter) {
+    if (frameCount < 2) {
+        return false;
+    }
+
+    if (!isKeyframe(newestEntry)) {
+        decode(newestEntry, newestState);
+        removeNewest();
+        framesSinceKeyframe--;
+    } else {
+        // The frame before a keyframe is rebuilt forwards from the keyframe 
+        // it depends on
+        removeNewest();
+        size_t entry = newestEntry;
+        framesSinceKeyframe = 0;
+        while (!isKeyframe(entry)) {
+            entry = getPreviousEntry(entry);
+            framesSinceKeyframe++;
+        }
+
+        newestState.fill(0);
+        decode(entry, newestState);
+        while (entry != newestEntry) {
+            entry = getNextEntry(entry);
+            decode(entry, newestState);
+        }
+    }
+
+    return interpreter.loadState(newestState.data(), newestState.size());
+}
+
+void RewindBuffer::clear() {
+    frameCount = 0;
+    oldestEntry = 0;
+    newestEntry = 0;
+    head = 0;
+    wrapped = false;
+    wrapEnd = 0;
+    usedBytes = 0;
+    framesSinceKeyframe = 0;
+}
+
+size_t RewindBuffer::getFrameCount() const {
+    return frameCount;
+}
+
+size_t RewindBuffer::getUsedBytes() const {
+    return usedBytes;
+}
+
+/**
+ * Encodes the state being recorded into the payload as its XOR with the 
+ * reference, and returns the size of the encoding.
+ */
+size_t RewindBuffer::encode(const State& reference) {
+    const size_t end = state.size();
+    size_t size = 0;
+    size_t position = 0;
+
+    while (position < end) {
+        const size_t unchangedStart = position;
+        while (position < end && state[position] == reference[position]) {
+            position++;
+        }
+
+        const size_t changedStart = position;
+        size_t changedEnd = position;
+        size_t unchangedRun = 0;
+        while (position < end && unchangedRun < MIN_UNCHANGED_RUN) {
+            if (state[position] == reference[position]) {
+                unchangedRun++;
+            } else {
+                unchangedRun = 0;
+                changedEnd = position + 1;
+            }
+            position++;
+        }
+        if (changedEnd == changedStart) {
+            break;
+        }
+        position = changedEnd;
+
+        writeSize(&payload[size], changedStart - unchangedStart);
+        writeSize(&payload[size + 2], changedEnd - changedStart);
+        size += TOKEN_HEADER_SIZE;
+        for (size_t index = changedStart; index < changedEnd; index++) {
+            payload[size++] = state[index] ^ reference[index];
+        }
+    }
+    return size;
+}
+
+// XORs the delta stored in the entry at the given offset into the state.
+void RewindBuffer::decode(const size_t offset, State& target) const {
+    const size_t payloadSize = readSize(&storage[offset]);
+    const uint8_t* bytes = &storage[offset + ENTRY_HEADER_SIZE];
+    size_t position = 0;
+    size_t read = 0;
+
+    while (read < payloadSize) {
+        position += readSize(&bytes[read]);
+        const size_t changedCount = readSize(&bytes[read + 2]);
+        read += TOKEN_HEADER_SIZE;
+        for (size_t index = 0; index < changedCount; index++) {
+            target[position++] ^= bytes[read++];
+        }
+    }
+}
+
+bool RewindBuffer::isKeyframe(const size_t offset) const {
+    return storage[offset + 2] != 0;
+}
+
+size_t RewindBuffer::getEntrySize(const size_t offset) const {
+    return ENTRY_HEADER_SIZE + readSize(&storage[offset]) + ENTRY_FOOTER_SIZE;
+}
+
+// Returns the entry before the one at the given offset, which must not be 
+// the oldest.
+size_t RewindBuffer::getPreviousEntry(const size_t offset) const {
+    const size_t end = offset == 0 ? wrapEnd : offset;
+    const size_t footer = end - ENTRY_FOOTER_SIZE;
+    return footer - readSize(&storage[footer]) - ENTRY_HEADER_SIZE;
+}
+
+size_t RewindBuffer::getNextEntry(const size_t offset) const {
+    const size_t next = offset + getEntrySize(offset);
+    return wrapped && next == wrapEnd ? 0 : next;
+}
+
+/**
+ * Returns the offset to write an entry of the given size at, dropping the 
+ * oldest keyframes until it fits without overlapping the remaining entries.
+ */
+size_t RewindBuffer::allocate(const size_t entrySize) {
+    while (frameCount > 0) {
+        if (!wrapped) {
+            if (head + entrySize <= storage.size()) {
+                return head;
+            }
+            if (entrySize <= oldestEntry) {
+                wrapped = true;
+                wrapEnd = head;
+                return 0;
+            }
+        } else if (head + entrySize <= oldestEntry) {
+            return head;
+        }
+        evictOldestKeyframe();
+    }
+    return 0;
+}
+
+void RewindBuffer::append(const size_t offset, const size_t payloadSize, 
+    const bool keyframe) {
+    uint8_t* entry = &storage[offset];
+    writeSize(entry, payloadSize);
+    entry[2] = keyframe ? 1 : 0;
+    std::copy(std::begin(payload), std::begin(payload) + payloadSize, 
+        entry + ENTRY_HEADER_SIZE);
+    writeSize(entry + ENTRY_HEADER_SIZE + payloadSize, payloadSize);
+
+    const size_t entrySize = 
+        ENTRY_HEADER_SIZE + payloadSize + ENTRY_FOOTER_SIZE;
+    if (frameCount == 0) {
+        oldestEntry = offset;
+    }
+    newestEntry = offset;
+    head = offset + entrySize;
+    usedBytes += entrySize;
+    frameCount++;
+}
+
+// Drops the oldest keyframe and every frame encoded against it.
+void RewindBuffer::evictOldestKeyframe() {
+    do {
+        const size_t entrySize = getEntrySize(oldestEntry);
+        usedBytes -= entrySize;
+        frameCount--;
+        oldestEntry += entrySize;
+        if (wrapped && oldestEntry == wrapEnd) {
+            oldestEntry = 0;
+            wrapped = false;
+        }
+    } while (frameCount > 0 && !isKeyframe(oldestEntry));
+
+    if (frameCount == 0) {
+        clear();
+    }
+}
+
+void RewindBuffer::removeNewest() {
+    const size_t entrySize = getEntrySize(newestEntry);
+    usedBytes -= entrySize;
+    frameCount--;
+    if (frameCount == 0) {
+        clear();
+        return;
+    }
+
+    const size_t previous = getPreviousEntry(newestEntry);
+    if (newestEntry == 0 && wrapped) {
+        head = wrapEnd;
+        wrapped = false;
+    } else {
+        head = newestEntry;
+    }
+    newestEntry = previous;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/interpreter.hpp"
+
+namespace OCTACHIP {
+
+/**
+ * Records the state of an interpreter once per frame so that it can be 
+ * stepped backwards. Only a few bytes change from one frame to the next, so 
+ * each frame is stored as its XOR with the frame before it, run-length 
+ * encoded. As XOR is its own inverse, the same delta steps back one frame. 
+ * A whole state is stored as a keyframe every keyframeInterval frames, which 
+ * bounds the work of rebuilding a frame after a keyframe has been stepped 
+ * over. Entries are packed into a ring of bytes allocated up front: once it 
+ * is full, the oldest keyframe is dropped together with the frames that 
+ * depend on it.
+ */
+class RewindBuffer {
+public:
+    // Ten seconds at 60 frames per second. Keyframes take a few KB each, while 
+    // most deltas take a few dozen bytes.
+    static constexpr int DEFAULT_KEYFRAME_INTERVAL = 600;
+
+    explicit RewindBuffer(const size_t capacity, 
+        const int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    void record(const Interpreter& interpreter);
+    bool rewind(Interpreter& interpreter);
+    void clear();
+
+    size_t getFrameCount() const;
+    size_t getUsedBytes() const;
+private:
+    using State = std::array<uint8_t, Interpreter::STATE_SIZE>;
+
+    // Each entry is framed by its payload size, with a keyframe flag after 
+    // the leading size, so the ring can be walked in both directions
+    static constexpr size_t ENTRY_HEADER_SIZE = 3;
+    static constexpr size_t ENTRY_FOOTER_SIZE = 2;
+    // A token is a run of unchanged bytes followed by a run of XORed ones, 
+    // each preceded by its 16-bit length
+    static constexpr size_t TOKEN_HEADER_SIZE = 4;
+    // Shorter runs of unchanged bytes are folded into the changed ones, as a 
+    // new token would cost more than it saves
+    static constexpr size_t MIN_UNCHANGED_RUN = TOKEN_HEADER_SIZE;
+    // Every token but the first skips at least as many bytes as its header 
+    // takes up
+    static constexpr size_t MAX_PAYLOAD_SIZE = 
+        Interpreter::STATE_SIZE + TOKEN_HEADER_SIZE;
+    static constexpr size_t MAX_ENTRY_SIZE = 
+        ENTRY_HEADER_SIZE + MAX_PAYLOAD_SIZE + ENTRY_FOOTER_SIZE;
+
+    size_t encode(const State& reference);
+    void decode(const size_t offset, State& target) const;
+    bool isKeyframe(const size_t offset) const;
+    size_t getEntrySize(const size_t offset) const;
+    size_t getPreviousEntry(const size_t offset) const;
+    size_t getNextEntry(const size_t offset) const;
+    size_t allocate(const size_t entrySize);
+    void append(const size_t offset, const size_t payloadSize, 
+        const bool keyframe);
+    void evictOldestKeyframe();
+    void removeNewest();
+
+    const int keyframeInterval;
+    std::vector<uint8_t> storage;
+    size_t frameCount;
+    size_t oldestEntry;
+    size_t newestEntry;
+    // Where the next entry is written
+    size_t head;
+    // Whether the entries run past the end of the ring and continue from its 
+    // start, in which case the older part ends at wrapEnd
+    bool wrapped;
+    size_t wrapEnd;
+    size_t usedBytes;
+    // Number of entries after the newest keyframe
+    int framesSinceKeyframe;
+    // The state of the newest entry, which the next one is encoded against
+    State newestState;
+    // The state being recorded, and its encoding
+    State state;
+    std::array<uint8_t, MAX_PAYLOAD_SIZE> payload;
+};
+
+}
\ No newline at end of file
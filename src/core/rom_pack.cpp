@@ -0,0 +1,200 @@
+#include <array>
+#include <limits>
+#include <unordered_map>
+
+#include "core/input_movie.hpp"
+#include "core/rom_pack.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+constexpr std::array<uint8_t, 4> PACK_MAGIC = {'O', 'C', '8', 'P'};
+
+class PackWriter {
+public:
+    explicit PackWriter(std::vector<uint8_t>& target) : 
+        bytes{target} {}
+
+    template <typename Value>
+    void write(const Value value) {
+        for (size_t byte = 0; byte < sizeof(Value); byte++) {
+            bytes.push_back(static_cast<uint8_t>(value >> byte * 8));
+        }
+    }
+
+    void writeString(const std::string& value) {
+        write(static_cast<uint16_t>(value.size()));
+        bytes.insert(bytes.end(), value.begin(), value.end());
+    }
+
+    // Overwrites a value written earlier, once it is known
+    void patch(const size_t position, const uint32_t value) {
+        for (size_t byte = 0; byte < sizeof(value); byte++) {
+            bytes[position + byte] = static_cast<uint8_t>(value >> byte * 8);
+        }
+    }
+private:
+    std::vector<uint8_t>& bytes;
+};
+
+class PackReader {
+public:
+    PackReader(const uint8_t* data, const size_t size) : 
+        position{data}, 
+        end{data + size} {}
+
+    template <typename Value>
+    bool read(Value& value) {
+        if (static_cast<size_t>(end - position) < sizeof(Value)) {
+            return false;
+        }
+        value = 0;
+        for (size_t byte = 0; byte < sizeof(Value); byte++) {
+            value |= static_cast<Value>(
+                static_cast<Value>(*position++) << byte * 8);
+        }
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        uint16_t length = 0;
+        if (!read(length) || static_cast<size_t>(end - position) < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(position), length);
+        position += length;
+        return true;
+    }
+
+    bool isAtEnd() const {
+        return position == end;
+    }
+private:
+    const uint8_t* position;
+    const uint8_t* end;
+};
+
+}
+
+/**
+ * Serializes ROM images and their settings into a pack, where images[i] is 
+ * the image of roms[i]. The hash, offset and size of each ROM are filled in 
+ * from its image. Multi-byte fields are stored little-endian.
+ */
+std::vector<uint8_t> OCTACHIP::encodeRomPack(
+    const std::vector<PackedRom>& roms, 
+    const std::vector<std::vector<uint8_t>>& images) {
+    std::vector<uint8_t> bytes;
+    PackWriter writer{bytes};
+    for (const uint8_t byte : PACK_MAGIC) {
+        writer.write(byte);
+    }
+    writer.write(RomPack::VERSION);
+    writer.write(static_cast<uint16_t>(roms.size()));
+    const size_t indexSizePosition = bytes.size();
+    writer.write(uint32_t{0});
+
+    // The offsets are only known once the whole index has been written
+    std::vector<size_t> offsetPositions;
+    for (size_t index = 0; index < roms.size(); index++) {
+        const PackedRom& rom = roms[index];
+        writer.write(hashBytes(images[index].data(), images[index].size()));
+        offsetPositions.push_back(bytes.size());
+        writer.write(uint32_t{0});
+        writer.write(static_cast<uint32_t>(images[index].size()));
+        writer.write(static_cast<uint32_t>(rom.speed));
+        writer.write(static_cast<uint8_t>(rom.loadStoreQuirk << 2 | 
+            rom.shiftQuirk << 1 | rom.wrapQuirk));
+        writer.writeString(rom.title);
+        writer.writeString(rom.filename);
+    }
+    writer.patch(indexSizePosition, static_cast<uint32_t>(bytes.size()));
+
+    std::unordered_map<uint64_t, uint32_t> offsets;
+    for (size_t index = 0; index < roms.size(); index++) {
+        const std::vector<uint8_t>& image = images[index];
+        const uint64_t hash = hashBytes(image.data(), image.size());
+        const auto [entry, isNew] = 
+            offsets.emplace(hash, static_cast<uint32_t>(bytes.size()));
+        if (isNew) {
+            bytes.insert(bytes.end(), image.begin(), image.end());
+        }
+        writer.patch(offsetPositions[index], entry->second);
+    }
+    return bytes;
+}
+
+/**
+ * Parses the index of a pack written by encodeRomPack(), without copying or 
+ * hashing the images. Returns a description of the error if the data is not 
+ * a valid pack, leaving the given pack unchanged.
+ */
+std::optional<std::string> OCTACHIP::decodeRomPack(const uint8_t* data, 
+    const size_t size, RomPack& pack) {
+    PackReader header{data, size};
+    for (const uint8_t expected : PACK_MAGIC) {
+        uint8_t byte = 0;
+        if (!header.read(byte) || byte != expected) {
+            return "Not a ROM pack";
+        }
+    }
+
+    uint16_t version = 0;
+    if (!header.read(version) || version != RomPack::VERSION) {
+        return "Unsupported ROM pack version";
+    }
+
+    RomPack decoded{};
+    uint16_t romCount = 0;
+    if (!header.read(romCount) || !header.read(decoded.indexSize) || 
+        decoded.indexSize > size) {
+        return "ROM pack is truncated";
+    }
+    if (decoded.indexSize < RomPack::HEADER_SIZE) {
+        return "ROM pack has an invalid header";
+    }
+
+    PackReader reader{data + RomPack::HEADER_SIZE, 
+        decoded.indexSize - RomPack::HEADER_SIZE};
+    for (uint16_t index = 0; index < romCount; index++) {
+        PackedRom rom{};
+        uint32_t speed = 0;
+        uint8_t quirks = 0;
+        if (!reader.read(rom.hash) || !reader.read(rom.offset) || 
+            !reader.read(rom.size) || !reader.read(speed) || 
+            !reader.read(quirks) || !reader.readString(rom.title) || 
+            !reader.readString(rom.filename)) {
+            return "ROM pack index is truncated";
+        }
+        // Images live after the index, and entirely within the pack
+        if (rom.offset < decoded.indexSize || 
+            static_cast<uint64_t>(rom.offset) + rom.size > size || 
+            speed > static_cast<uint32_t>(std::numeric_limits<int>::max()) || 
+            quirks > 0x7) {
+            return "ROM pack has an invalid entry";
+        }
+        rom.speed = static_cast<int>(speed);
+        rom.loadStoreQuirk = quirks & 0x4;
+        rom.shiftQuirk = quirks & 0x2;
+        rom.wrapQuirk = quirks & 0x1;
+        decoded.roms.push_back(std::move(rom));
+    }
+    if (!reader.isAtEnd()) {
+        return "ROM pack index has trailing data";
+    }
+
+    pack = std::move(decoded);
+    return std::nullopt;
+}
+
+// Returns the ROM whose image has the given hash, or nullptr if there is none
+const PackedRom* OCTACHIP::findPackedRom(const RomPack& pack, 
+    const uint64_t hash) {
+    for (const PackedRom& rom : pack.roms) {
+        if (rom.hash == hash) {
+            return &rom;
+        }
+    }
+    return nullptr;
+}
\ No newline at end of file
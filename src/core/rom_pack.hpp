@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace OCTACHIP {
+
+// A ROM image stored in a pack, with the speed and quirk settings it runs 
+// with, as listed in roms.json
+struct PackedRom {
+    // 64-bit FNV-1a hash of the image, as computed by hashBytes()
+    uint64_t hash{};
+    std::string title;
+    std::string filename;
+    int speed{};
+    bool loadStoreQuirk{};
+    bool shiftQuirk{};
+    bool wrapQuirk{};
+    // Position of the image from the start of the pack
+    uint32_t offset{};
+    uint32_t size{};
+};
+
+/**
+ * The index of a single file holding many ROM images. The index comes first, 
+ * so a reader only needs its first indexSize bytes to find any image, and 
+ * images with the same contents are stored once.
+ */
+struct RomPack {
+    static constexpr uint16_t VERSION = 1;
+    // Magic, version, ROM count and index size, which is all a reader has to 
+    // fetch before it knows how large the index is
+    static constexpr size_t HEADER_SIZE = 12;
+
+    uint32_t indexSize{};
+    std::vector<PackedRom> roms;
+};
+
+std::vector<uint8_t> encodeRomPack(const std::vector<PackedRom>& roms, 
+    const std::vector<std::vector<uint8_t>>& images);
+std::optional<std::string> decodeRomPack(const uint8_t* data, 
+    const size_t size, RomPack& pack);
+const PackedRom* findPackedRom(const RomPack& pack, const uint64_t hash);
+
+}
\ No newline at end of file
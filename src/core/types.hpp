@@ -13,7 +13,41 @@ using Stack = std::array<uint16_t, STACK_SIZE>;
 
 static constexpr int FRAME_WIDTH = 64;
 static constexpr int FRAME_HEIGHT = 32;
-using Frame = std::array<bool, FRAME_WIDTH * FRAME_HEIGHT>;
+// Each row of the display is packed into a single word, with the leftmost 
+// pixel in the most significant bit.
+using FrameRow = uint64_t;
+using Frame = std::array<FrameRow, FRAME_HEIGHT>;
+static_assert(sizeof(FrameRow) * 8 == FRAME_WIDTH);
+
+// Returns the mask of the bit holding the pixel in column col of a frame row.
+constexpr FrameRow pixelMask(const int col) {
+    return FrameRow{1} << (FRAME_WIDTH - 1 - col);
+}
+
+constexpr bool getPixel(const Frame& frame, const int col, const int row) {
+    return (frame[row] & pixelMask(col)) != 0;
+}
+
+constexpr void setPixel(Frame& frame, const int col, const int row, 
+    const bool value) {
+    if (value) {
+        frame[row] |= pixelMask(col);
+    } else {
+        frame[row] &= ~pixelMask(col);
+    }
+}
+
+// Tracks which rows of the frame have been modified, with one bit per row, 
+// and counts the instructions that modified it, so hosts can skip redrawing 
+// frames that did not change.
+using FrameRowMask = uint32_t;
+static constexpr FrameRowMask ALL_FRAME_ROWS = ~FrameRowMask{0};
+static_assert(sizeof(FrameRowMask) * 8 == FRAME_HEIGHT);
+
+struct FrameChanges {
+    FrameRowMask dirtyRows{};
+    uint64_t generation{};
+};
 
 static constexpr int KEY_COUNT = 16;
 using Keypad = std::array<bool, KEY_COUNT>;
@@ -1,55 +1,219 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "emulator.hpp"
+#include "core/fault.hpp"
 #include "core/types.hpp"
 
 using namespace OCTACHIP;
 
-Emulator::Emulator(const std::filesystem::path& romPath, 
-    const int instructionsPerSecond, const int windowScale) : 
+Emulator::Emulator(const std::filesystem::path& romFilePath, 
+    const int instructionsPerSecond, const int windowScale, 
+    const size_t rewindCapacity, std::unique_ptr<FrameClock> frameClock) : 
+    romPath{romFilePath}, 
+    statePath{romFilePath.string() + ".state"}, 
+    stateBuffer{}, 
     instructionsPerUpdate{static_cast<int>(instructionsPerSecond / 
-        UPDATES_PER_SECOND)},
-    interpreter{},
-    input{},
-    renderer{FRAME_WIDTH, FRAME_HEIGHT, windowScale, "OCTACHIP"} {
-    interpreter.loadRom(romPath);
+        UPDATES_PER_SECOND)}, 
+    interpreter{}, 
+    rewindBuffer{rewindCapacity}, 
+    rewinding{false}, 
+    recorder{}, 
+    moviePath{}, 
+    input{}, 
+    renderer{FRAME_WIDTH, FRAME_HEIGHT, windowScale, "OCTACHIP"}, 
+    clock{std::move(frameClock)}, 
+    scheduler{UPDATES_PER_SECOND, *clock} {
+    const std::optional<std::string> error = interpreter.loadRom(romPath);
+    if (error) {
+        throw std::runtime_error(*error);
+    }
+}
+
+void Emulator::seedRandom(const uint64_t seed) {
+    interpreter.seedRandom(seed);
+}
+
+/**
+ * Restarts the ROM with the given seed and records the keypad from then on. 
+ * The movie is written to the given path when the emulator stops.
+ */
+void Emulator::startRecording(const std::filesystem::path& path, 
+    const uint64_t seed) {
+    std::ifstream romFile{romPath, std::ios_base::binary};
+    const std::vector<uint8_t> rom{std::istreambuf_iterator<char>{romFile}, 
+        std::istreambuf_iterator<char>{}};
+
+    recorder.emplace(interpreter, seed, instructionsPerUpdate);
+    const std::optional<std::string> error = 
+        recorder->start(rom.data(), rom.size());
+    if (error) {
+        throw std::runtime_error(*error);
+    }
+    moviePath = path;
+    rewindBuffer.clear();
 }
 
+/**
+ * Runs the emulator at 60 updates per second until the window is closed. The 
+ * loop sleeps between updates, and runs several updates back to back to catch 
+ * up if it falls behind.
+ * 
+ * The updates are paced by the emulator's clock, so a virtual clock runs them 
+ * back to back as fast as the host allows. Input, drawing and rewinding are 
+ * due at 60 Hz steps of real time whatever the clock, and a clock that 
+ * follows real time wakes once per step, so it presents after every update.
+ */
 void Emulator::run() {
+    const auto presentInterval = 
+        std::chrono::duration_cast<FrameClock::Duration>(
+            std::chrono::duration<double>(1.0 / UPDATES_PER_SECOND));
+    FrameClock::TimePoint nextPresentTime = std::chrono::steady_clock::now();
     bool running = true;
-    auto lastUpdateTime = std::chrono::high_resolution_clock::now();
-    double accumulator = 0.0;
+    int dueUpdates = 1;
+    scheduler.start();
 
     while (running) {
-        double deltaTime = getDeltaTime(lastUpdateTime);
+        const FrameClock::TimePoint presentTime = 
+            std::chrono::steady_clock::now();
+        const bool isPresenting = presentTime >= nextPresentTime;
+        if (isPresenting) {
+            while (nextPresentTime <= presentTime) {
+                nextPresentTime += presentInterval;
+            }
+            running = input.processInput(
+                [&](const int key, const bool isPressed) {
+                    if (recorder) {
+                        recorder->setKey(key, isPressed);
+                    } else {
+                        interpreter.setKey(key, isPressed);
+                    }
+                }, 
+                [&](const Hotkey hotkey, const bool isPressed) {
+                    handleHotkey(hotkey, isPressed);
+                });
+        }
 
-        if (deltaTime > 0.25) {
-            deltaTime = 0.25;
+        if (rewinding) {
+            // Steps back on the 60 Hz steps of real time, so rewinding runs 
+            // at normal speed even when the clock runs the ROM faster
+            if (isPresenting) {
+                rewindBuffer.rewind(interpreter);
+            }
+        } else {
+            for (int update = 0; update < dueUpdates; update++) {
+                const Fault& fault = runUpdate();
+                if (fault.kind != FaultKind::NONE) {
+                    finishRecording();
+                    throw std::runtime_error(describeFault(fault));
+                }
+                if (!recorder) {
+                    rewindBuffer.record(interpreter);
+                }
+            }
         }
 
-        accumulator += deltaTime;
+        if (isPresenting) {
+            renderer.drawFrame(interpreter.getFrame(), 
+                interpreter.takeDirtyRows());
+        }
 
-        while (accumulator >= UPDATE_INTERVAL) {
-            accumulator -= UPDATE_INTERVAL;
+        dueUpdates = scheduler.waitForNextFrame();
+    }
 
-            for (int i = 0; i < instructionsPerUpdate; i++) {
-                interpreter.tick();
-            }
+    finishRecording();
+}
 
-            interpreter.updateTimers();
-        }
+FramePacing Emulator::getPacing() const {
+    return scheduler.getPacing();
+}
 
-        renderer.drawFrame(interpreter.getFrame());
+// Runs one 60 Hz update, through the recorder while a movie is recorded
+const Fault& Emulator::runUpdate() {
+    if (recorder) {
+        return recorder->runFrame();
+    }
+    const Fault& fault = interpreter.run(instructionsPerUpdate);
+    if (fault.kind == FaultKind::NONE) {
+        interpreter.updateTimers();
+    }
+    return fault;
+}
 
-        running = input.processInput([&](const int key, const bool isPressed) {
-            interpreter.setKey(key, isPressed);
-        });
+void Emulator::finishRecording() {
+    if (!recorder) {
+        return;
+    }
+    const std::vector<uint8_t> movie = encodeMovie(recorder->finish());
+    recorder.reset();
+    std::ofstream movieFile{moviePath, std::ios_base::binary};
+    movieFile.write(reinterpret_cast<const char*>(movie.data()), 
+        static_cast<std::streamsize>(movie.size()));
+    if (!movieFile) {
+        std::cerr << "Failed to write input movie: " << moviePath.string() 
+            << "\n";
+        return;
     }
+    std::cout << "Saved input movie to " << moviePath.string() << "\n";
 }
 
-double Emulator::getDeltaTime(
-    std::chrono::high_resolution_clock::time_point& lastUpdateTime) {
-    const auto now = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double> deltaTime = now - lastUpdateTime;
-    lastUpdateTime = now;
+/**
+ * Saves and loads states when their keys are pressed, and rewinds for as long 
+ * as the rewind key is held down.
+ */
+void Emulator::handleHotkey(const Hotkey hotkey, const bool isPressed) {
+    switch (hotkey) {
+        case Hotkey::SAVE_STATE: 
+            if (isPressed) {
+                saveState();
+            }
+            break;
+        case Hotkey::LOAD_STATE: 
+            if (isPressed && recorder) {
+                std::cerr << "Loading states is disabled while recording\n";
+            } else if (isPressed) {
+                loadState();
+            }
+            break;
+        case Hotkey::REWIND: 
+            if (isPressed && recorder) {
+                std::cerr << "Rewinding is disabled while recording\n";
+            }
+            rewinding = isPressed && !recorder;
+            break;
+    }
+}
 
-    return deltaTime.count();
+void Emulator::saveState() {
+    const size_t stateSize = 
+        interpreter.saveState(stateBuffer.data(), stateBuffer.size());
+    std::ofstream stateFile{statePath, std::ios_base::binary};
+    stateFile.write(reinterpret_cast<const char*>(stateBuffer.data()), 
+        stateSize);
+    if (!stateFile) {
+        std::cerr << "Failed to write save state: " << statePath.string() 
+            << "\n";
+        return;
+    }
+    std::cout << "Saved state to " << statePath.string() << "\n";
+}
+
+void Emulator::loadState() {
+    std::ifstream stateFile{statePath, std::ios_base::binary};
+    stateFile.read(reinterpret_cast<char*>(stateBuffer.data()), 
+        stateBuffer.size());
+    const size_t stateSize = static_cast<size_t>(stateFile.gcount());
+    if (!interpreter.loadState(stateBuffer.data(), stateSize)) {
+        std::cerr << "Failed to load save state: " << statePath.string() 
+            << "\n";
+        return;
+    }
+    std::cout << "Loaded state from " << statePath.string() << "\n";
 }
\ No newline at end of file
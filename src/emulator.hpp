@@ -1,9 +1,16 @@
 #pragma once
 
-#include <chrono>
+#include <array>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <optional>
 
+#include "frame_clock.hpp"
+#include "frame_scheduler.hpp"
+#include "core/input_movie.hpp"
 #include "core/interpreter.hpp"
+#include "core/rewind_buffer.hpp"
 #include "io/input.hpp"
 #include "io/renderer.hpp"
 
@@ -12,20 +19,44 @@ namespace OCTACHIP {
 class Emulator {
 public:
     Emulator(const std::filesystem::path& romPath, 
-        const int instructionsPerSecond, const int windowScale);
+        const int instructionsPerSecond, const int windowScale, 
+        const size_t rewindCapacity, 
+        std::unique_ptr<FrameClock> frameClock = 
+            std::make_unique<SystemClock>());
+    void seedRandom(const uint64_t seed);
+    void startRecording(const std::filesystem::path& path, 
+        const uint64_t seed);
     void run();
+    FramePacing getPacing() const;
 private:
     static constexpr double UPDATES_PER_SECOND = 60.0;
-    static constexpr double UPDATE_INTERVAL = 1.0 / UPDATES_PER_SECOND;
 
+    const Fault& runUpdate();
+    void finishRecording();
+    void handleHotkey(const Hotkey hotkey, const bool isPressed);
+    void saveState();
+    void loadState();
+
+    // Save states are kept next to the ROM, in a file named after it
+    const std::filesystem::path romPath;
+    const std::filesystem::path statePath;
+    std::array<uint8_t, Interpreter::STATE_SIZE> stateBuffer;
     const int instructionsPerUpdate;
 
     Interpreter interpreter;
+    RewindBuffer rewindBuffer;
+    // Whether updates step back through the rewind buffer instead of running 
+    // the ROM
+    bool rewinding;
+    // Records the keypad while set, which rules out loading states and 
+    // rewinding, as the movie could not reproduce them
+    std::optional<MovieRecorder> recorder;
+    std::filesystem::path moviePath;
     Input input;
     Renderer renderer;
-
-    double getDeltaTime(
-        std::chrono::high_resolution_clock::time_point& lastUpdateTime);
+    // Paces the updates, which need not follow real time
+    std::unique_ptr<FrameClock> clock;
+    FrameScheduler scheduler;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <thread>
+
+#include "frame_clock.hpp"
+
+using namespace OCTACHIP;
+
+FrameClock::TimePoint SystemClock::now() const {
+    return std::chrono::steady_clock::now();
+}
+
+/**
+ * Sleeps until shortly before the deadline, then spins for the remainder so 
+ * the caller wakes up on time without burning a core while it waits.
+ */
+void SystemClock::sleepUntil(const TimePoint deadline) {
+    if (deadline - now() > SPIN_THRESHOLD) {
+        std::this_thread::sleep_until(deadline - SPIN_THRESHOLD);
+    }
+    while (now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+VirtualClock::VirtualClock() :
+    time{} {}
+
+FrameClock::TimePoint VirtualClock::now() const {
+    return time;
+}
+
+// Jumps straight to the deadline instead of waiting for it.
+void VirtualClock::sleepUntil(const TimePoint deadline) {
+    if (deadline > time) {
+        time = deadline;
+    }
+}
\ No newline at end of file
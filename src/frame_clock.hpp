@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+
+namespace OCTACHIP {
+
+/**
+ * Source of time used to pace the emulator. The system clock follows real 
+ * time, while the virtual clock only moves when it is told to wait, which lets 
+ * turbo mode run frames back to back as fast as the host allows.
+ */
+class FrameClock {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    using Duration = std::chrono::steady_clock::duration;
+
+    virtual ~FrameClock() = default;
+    virtual TimePoint now() const = 0;
+    virtual void sleepUntil(const TimePoint deadline) = 0;
+};
+
+class SystemClock : public FrameClock {
+public:
+    TimePoint now() const override;
+    void sleepUntil(const TimePoint deadline) override;
+private:
+    // Sleeping is only accurate to within a millisecond or so, so the last 
+    // stretch before a deadline is spun instead
+    static constexpr std::chrono::microseconds SPIN_THRESHOLD{1000};
+};
+
+class VirtualClock : public FrameClock {
+public:
+    VirtualClock();
+    TimePoint now() const override;
+    void sleepUntil(const TimePoint deadline) override;
+private:
+    TimePoint time;
+};
+
+}
\ No newline at end of file
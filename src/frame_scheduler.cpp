@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+
+#include "frame_scheduler.hpp"
+
+using namespace OCTACHIP;
+
+FrameScheduler::FrameScheduler(const double framesPerSecond, 
+    FrameClock& frameClock) : 
+    frameInterval{std::chrono::duration_cast<FrameClock::Duration>(
+        std::chrono::duration<double>(1.0 / framesPerSecond))}, 
+    clock{frameClock}, 
+    nextDeadline{}, 
+    frameCount{}, 
+    droppedFrameCount{}, 
+    totalJitter{}, 
+    maxJitter{} {}
+
+/**
+ * Schedules the first frame to start immediately and clears the pacing 
+ * statistics.
+ */
+void FrameScheduler::start() {
+    nextDeadline = clock.now();
+    frameCount = 0;
+    droppedFrameCount = 0;
+    totalJitter = FrameClock::Duration::zero();
+    maxJitter = FrameClock::Duration::zero();
+}
+
+/**
+ * Blocks until the deadline of the next frame. Returns the number of frames 
+ * that are due, which is more than 1 when the caller fell behind and has to 
+ * catch up. Frames beyond the catch-up limit are dropped.
+ */
+int FrameScheduler::waitForNextFrame() {
+    nextDeadline += frameInterval;
+
+    clock.sleepUntil(nextDeadline);
+    const FrameClock::TimePoint now = clock.now();
+
+    const FrameClock::Duration jitter = now - nextDeadline;
+    int dueFrames = 1 + static_cast<int>(jitter / frameInterval);
+    if (dueFrames > MAX_CATCH_UP_FRAMES) {
+        droppedFrameCount += dueFrames - MAX_CATCH_UP_FRAMES;
+        dueFrames = MAX_CATCH_UP_FRAMES;
+        nextDeadline = now;
+    } else {
+        nextDeadline += frameInterval * (dueFrames - 1);
+    }
+
+    frameCount++;
+    totalJitter += jitter;
+    maxJitter = std::max(maxJitter, jitter);
+    return dueFrames;
+}
+
+FramePacing FrameScheduler::getPacing() const {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    FramePacing pacing{};
+    pacing.frameCount = frameCount;
+    pacing.droppedFrameCount = droppedFrameCount;
+    if (frameCount > 0) {
+        pacing.meanJitterMilliseconds = 
+            Milliseconds(totalJitter).count() / frameCount;
+    }
+    pacing.maxJitterMilliseconds = Milliseconds(maxJitter).count();
+    return pacing;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "frame_clock.hpp"
+
+namespace OCTACHIP {
+
+// Summary of how far past their deadlines frames actually started.
+struct FramePacing {
+    uint64_t frameCount{};
+    uint64_t droppedFrameCount{};
+    double meanJitterMilliseconds{};
+    double maxJitterMilliseconds{};
+};
+
+/**
+ * Paces a loop at a fixed frame rate by waiting on a clock for the deadline of 
+ * each frame, so the loop does not burn a core while it is idle.
+ */
+class FrameScheduler {
+public:
+    FrameScheduler(const double framesPerSecond, FrameClock& frameClock);
+
+    void start();
+    int waitForNextFrame();
+    FramePacing getPacing() const;
+private:
+    // Limits how many frames are caught up on after a stall, matching the 
+    // quarter second of emulation the loop used to allow
+    static constexpr int MAX_CATCH_UP_FRAMES = 15;
+
+    const FrameClock::Duration frameInterval;
+    FrameClock& clock;
+    FrameClock::TimePoint nextDeadline;
+    uint64_t frameCount;
+    uint64_t droppedFrameCount;
+    FrameClock::Duration totalJitter;
+    FrameClock::Duration maxJitter;
+};
+
+}
\ No newline at end of file
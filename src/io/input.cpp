@@ -2,7 +2,7 @@
 
 using namespace OCTACHIP;
 
-Input::Input() : keyMap{} {
+Input::Input() : keyMap{}, hotkeyMap{} {
     keyMap[SDLK_x] = 0;
     keyMap[SDLK_1] = 1;
     keyMap[SDLK_2] = 2;
@@ -19,10 +19,15 @@ Input::Input() : keyMap{} {
     keyMap[SDLK_r] = 0xD;
     keyMap[SDLK_f] = 0xE;
     keyMap[SDLK_v] = 0xF;
+
+    hotkeyMap[SDLK_F5] = Hotkey::SAVE_STATE;
+    hotkeyMap[SDLK_F9] = Hotkey::LOAD_STATE;
+    hotkeyMap[SDLK_BACKSPACE] = Hotkey::REWIND;
 }
 
 bool Input::processInput(
-    const std::function<void(const int, const bool)>& keyEventHandler) {
+    const std::function<void(const int, const bool)>& keyEventHandler, 
+    const std::function<void(const Hotkey, const bool)>& hotkeyHandler) {
     SDL_Event event{};
     while (SDL_PollEvent(&event)) {
         if (event.type == SDL_QUIT) {
@@ -36,11 +41,18 @@ bool Input::processInput(
             if (keyMap.find(key) != keyMap.end()) {
                 keyEventHandler(keyMap[key], true);
             }
+            if (hotkeyHandler && event.key.repeat == 0 && 
+                hotkeyMap.find(key) != hotkeyMap.end()) {
+                hotkeyHandler(hotkeyMap[key], true);
+            }
         }
         if (event.type == SDL_KEYUP) {
             if (keyMap.find(key) != keyMap.end()) {
                 keyEventHandler(keyMap[key], false);
             }
+            if (hotkeyHandler && hotkeyMap.find(key) != hotkeyMap.end()) {
+                hotkeyHandler(hotkeyMap[key], false);
+            }
         }
     }
     return true;
@@ -6,12 +6,21 @@
 
 namespace OCTACHIP {
 
+// Emulator functions bound to keys outside of the CHIP-8 keypad
+enum class Hotkey {
+    SAVE_STATE,
+    LOAD_STATE,
+    REWIND
+};
+
 class Input {
 public:
     Input();
-    bool processInput(const std::function<void(int, bool)>& keyEventHandler);
+    bool processInput(const std::function<void(int, bool)>& keyEventHandler, 
+        const std::function<void(Hotkey, bool)>& hotkeyHandler = {});
 private:
     std::unordered_map<SDL_Keycode, uint8_t> keyMap;
+    std::unordered_map<SDL_Keycode, Hotkey> hotkeyMap;
 };
 
 }
\ No newline at end of file
@@ -8,6 +8,8 @@ Renderer::Renderer(const int width, const int height, const int scalar,
     const std::string& title) :
         window{nullptr},
         renderer{nullptr},
+        texture{nullptr},
+        texels(width * height, PIXEL_OFF_COLOR),
         baseWidth{width},
         baseHeight{height},
         windowScale{scalar} {
@@ -25,32 +27,66 @@ Renderer::Renderer(const int width, const int height, const int scalar,
     }
     
     SDL_SetWindowTitle(window, title.data());
+
+    // The frame is drawn into a texture at its native resolution and scaled up 
+    // by SDL when copied to the window, so keep the pixels sharp
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, 
+        SDL_TEXTUREACCESS_STREAMING, width, height);
+
+    if (texture == nullptr) {
+        throw std::runtime_error("Failed to create SDL texture: " + 
+            std::string(SDL_GetError()));
+    }
 }
 
 Renderer::~Renderer() { 
+    SDL_DestroyTexture(texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 }
 
-void Renderer::drawFrame(const Frame& frame) {
-    clearRenderer();
-    for (int row = 0; row < baseHeight; row++) {
-        for (int col = 0; col < baseWidth; col++) {
-            if (frame[col + (row * baseWidth)]) {
-                drawPixel(col, row);
+/**
+ * Converts the dirty rows of the frame into texels and uploads them to the 
+ * streaming texture, then presents it with a single copy scaled to the size of 
+ * the window. Nothing is presented if no rows are dirty.
+ * 
+ * Each run of consecutive dirty rows is uploaded with one texture update, so a 
+ * full redraw is a single upload. Locking the texture instead would require 
+ * rewriting every row, since the locked pixels are write-only.
+ */
+void Renderer::drawFrame(const Frame& frame, const FrameRowMask dirtyRows) {
+    if (dirtyRows == 0) {
+        return;
+    }
+
+    const int pitch = baseWidth * static_cast<int>(sizeof(Uint32));
+    int row = 0;
+    while (row < baseHeight) {
+        if ((dirtyRows & (FrameRowMask{1} << row)) == 0) {
+            row++;
+            continue;
+        }
+
+        const int firstRow = row;
+        for (; row < baseHeight && (dirtyRows & (FrameRowMask{1} << row)); 
+            row++) {
+            Uint32* rowTexels = texels.data() + row * baseWidth;
+            for (int col = 0; col < baseWidth; col++) {
+                rowTexels[col] = getPixel(frame, col, row) ? PIXEL_ON_COLOR : 
+                    PIXEL_OFF_COLOR;
             }
         }
+
+        const SDL_Rect rows{0, firstRow, baseWidth, row - firstRow};
+        SDL_UpdateTexture(texture, &rows, texels.data() + firstRow * baseWidth, 
+            pitch);
     }
-    SDL_RenderPresent(renderer);
-}
 
-void Renderer::drawPixel(const int col, const int row) {
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_Rect pixelBlock{col * windowScale, row * windowScale, windowScale, 
-        windowScale};
-    SDL_RenderDrawRect(renderer, &pixelBlock);
-    SDL_RenderFillRect(renderer, &pixelBlock);
+    clearRenderer();
+    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+    SDL_RenderPresent(renderer);
 }
 
 void Renderer::clearRenderer() {
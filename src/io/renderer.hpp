@@ -2,6 +2,7 @@
 
 #include <SDL.h>
 #include <string>
+#include <vector>
 
 #include "core/types.hpp"
 
@@ -12,12 +13,17 @@ public:
     Renderer(const int width, const int height, const int scalar, 
         const std::string& title);
     ~Renderer();
-    void drawFrame(const Frame& frame);
-    void drawPixel(const int row, const int col);
+    void drawFrame(const Frame& frame, 
+        const FrameRowMask dirtyRows = ALL_FRAME_ROWS);
     void clearRenderer();
 private:
+    static constexpr Uint32 PIXEL_ON_COLOR = 0xFFFFFFFF;
+    static constexpr Uint32 PIXEL_OFF_COLOR = 0xFF000000;
+
     SDL_Window* window;
     SDL_Renderer* renderer;
+    SDL_Texture* texture;
+    std::vector<Uint32> texels;
     int baseWidth;
     int baseHeight;
     int windowScale;
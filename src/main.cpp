@@ -1,14 +1,21 @@
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cxxopts.hpp>
 #include <exception>
 #include <iostream>
+#include <memory>
+#include <random>
 #include <string>
+#include <utility>
 
 #include "emulator.hpp"
 
 std::string parsePath(const cxxopts::ParseResult& result);
 int parseSpeed(const cxxopts::ParseResult& result);
 int parseScale(const cxxopts::ParseResult& result);
+size_t parseRewindCapacity(const cxxopts::ParseResult& result);
+void printPacing(const OCTACHIP::FramePacing& pacing);
 
 int main(int argc, char* argv[]) {
     cxxopts::Options options{"octachip", "A CHIP-8 interpreter written in C++"};
@@ -18,7 +25,15 @@ int main(int argc, char* argv[]) {
         ("s,speed", "Emulation speed (in ticks per second)", 
             cxxopts::value<int>()->default_value("800"))
         ("x,scale", "Window scale factor", 
-            cxxopts::value<int>()->default_value("20"));
+            cxxopts::value<int>()->default_value("20"))
+        ("p,pacing", "Report frame pacing jitter on exit")
+        ("t,turbo", "Run as fast as possible instead of in real time")
+        ("seed", "Seed for random numbers, for reproducible runs", 
+            cxxopts::value<uint64_t>())
+        ("rewind-mb", "Memory for rewinding (in megabytes)", 
+            cxxopts::value<int>()->default_value("8"))
+        ("record", "Record the keypad to an input movie file", 
+            cxxopts::value<std::string>());
     
     try {
         cxxopts::ParseResult result = options.parse(argc, argv);
@@ -31,9 +46,36 @@ int main(int argc, char* argv[]) {
         int windowScale = parseScale(result);
         std::string romPath = parsePath(result);
         int emulationSpeed = parseSpeed(result);
+        bool isTurbo = result.count("turbo") > 0;
+        size_t rewindCapacity = parseRewindCapacity(result);
 
-        OCTACHIP::Emulator emulator{romPath, emulationSpeed, windowScale};
+        // Turbo mode paces updates by a virtual clock, which never waits
+        std::unique_ptr<OCTACHIP::FrameClock> clock;
+        if (isTurbo) {
+            clock = std::make_unique<OCTACHIP::VirtualClock>();
+        } else {
+            clock = std::make_unique<OCTACHIP::SystemClock>();
+        }
+
+        OCTACHIP::Emulator emulator{romPath, emulationSpeed, windowScale, 
+            rewindCapacity, std::move(clock)};
+        if (result.count("seed")) {
+            emulator.seedRandom(result["seed"].as<uint64_t>());
+        }
+        if (result.count("record")) {
+            // Movies always store a seed, so that replays draw the same 
+            // random numbers
+            std::random_device device;
+            const uint64_t seed = result.count("seed") ? 
+                result["seed"].as<uint64_t>() : 
+                static_cast<uint64_t>(device()) << 32 | device();
+            emulator.startRecording(result["record"].as<std::string>(), seed);
+        }
         emulator.run();
+
+        if (result.count("pacing")) {
+            printPacing(emulator.getPacing());
+        }
     }
     catch (const cxxopts::exceptions::exception& e) {
         std::cerr << "Error parsing options: " << e.what() << "\n";
@@ -69,4 +111,19 @@ int parseScale(const cxxopts::ParseResult& result) {
             "Invalid argument: window scale factor must be greater than 0");
     }
     return result["scale"].as<int>();
+}
+
+size_t parseRewindCapacity(const cxxopts::ParseResult& result) {
+    if (result["rewind-mb"].as<int>() <= 0) {
+        throw std::invalid_argument(
+            "Invalid argument: rewind memory must be greater than 0");
+    }
+    return static_cast<size_t>(result["rewind-mb"].as<int>()) << 20;
+}
+
+void printPacing(const OCTACHIP::FramePacing& pacing) {
+    std::cout << "Frames: " << pacing.frameCount 
+        << " (" << pacing.droppedFrameCount << " dropped)\n"
+        << "Mean jitter: " << pacing.meanJitterMilliseconds << " ms\n"
+        << "Max jitter: " << pacing.maxJitterMilliseconds << " ms\n";
 }
\ No newline at end of file
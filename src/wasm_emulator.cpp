@@ -1,29 +1,43 @@
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "core/fault.hpp"
 #include "core/types.hpp"
 #include "wasm_emulator.hpp"
 
 using namespace OCTACHIP;
 
 Emulator::Emulator(const int windowScale, const int instructionsPerSecond) : 
-    lastUpdateTime{},
-    accumulator{},
+    clock{}, 
+    lastUpdateTime{}, 
+    accumulator{}, 
     instructionsPerUpdate{static_cast<int>(instructionsPerSecond / 
-        UPDATES_PER_SECOND)},
-    interpreter{},
-    input{},
+        UPDATES_PER_SECOND)}, 
+    turbo{false}, 
+    interpreter{}, 
+    rewindBuffer{REWIND_CAPACITY}, 
+    rewinding{false}, 
+    input{}, 
     renderer{FRAME_WIDTH, FRAME_HEIGHT, windowScale, "OCTACHIP"} {}
 
 void Emulator::reset() {
     accumulator = 0.0;
     interpreter.reset();
-    renderer.drawFrame(interpreter.getFrame());
+    rewindBuffer.clear();
+    renderer.drawFrame(interpreter.getFrame(), interpreter.takeDirtyRows());
 }
 
 void Emulator::refreshUpdateTimer() {
-    lastUpdateTime = std::chrono::high_resolution_clock::now();
+    lastUpdateTime = clock.now();
 }
 
-void Emulator::loadRom(const std::filesystem::path& romPath) {
-    interpreter.loadRom(romPath);
+void Emulator::loadRom(const uint8_t* romData, const size_t romSize) {
+    const std::optional<std::string> error = 
+        interpreter.loadRom(romData, romSize);
+    if (error) {
+        std::cerr << *error << "\n";
+    }
 }
 
 void Emulator::setSpeed(const int instructionsPerSecond) {
@@ -43,34 +57,113 @@ void Emulator::setWrapQuirk(const bool isEnabled) {
     interpreter.setWrapQuirk(isEnabled);
 }
 
-void Emulator::update() {
-    input.processInput([&](const int key, const bool isPressed) {
-        interpreter.setKey(key, isPressed);
-    });
+/**
+ * Enables or disables turbo mode, where updates run back to back for most of 
+ * each browser frame instead of 60 times per second.
+ */
+void Emulator::setTurbo(const bool isEnabled) {
+    turbo = isEnabled;
+    accumulator = 0.0;
+    refreshUpdateTimer();
+}
+
+void Emulator::seedRandom(const uint64_t seed) {
+    interpreter.seedRandom(seed);
+}
 
-    double deltaTime = getDeltaTime();
+size_t Emulator::saveState(uint8_t* buffer, const size_t bufferSize) const {
+    return interpreter.saveState(buffer, bufferSize);
+}
 
-    if (deltaTime > 0.25) {
-        deltaTime = 0.25;
+// While rewinding, each update steps back one frame instead of running one.
+void Emulator::setRewinding(const bool isRewinding) {
+    rewinding = isRewinding;
+}
+
+// Restores a snapshot and redraws, so the frame is shown even while paused.
+bool Emulator::loadState(const uint8_t* buffer, const size_t bufferSize) {
+    if (!interpreter.loadState(buffer, bufferSize)) {
+        return false;
     }
+    accumulator = 0.0;
+    renderer.drawFrame(interpreter.getFrame(), interpreter.takeDirtyRows());
+    return true;
+}
+
+/**
+ * Advances the emulator by the time elapsed since the last update. Returns 
+ * false once the ROM has faulted and the interpreter can no longer make 
+ * progress.
+ */
+bool Emulator::update() {
+    input.processInput(
+        [&](const int key, const bool isPressed) {
+            interpreter.setKey(key, isPressed);
+        }, 
+        [&](const Hotkey hotkey, const bool isPressed) {
+            if (hotkey == Hotkey::REWIND) {
+                setRewinding(isPressed);
+            }
+        });
+
+    // Rewinding steps back at 60 Hz, so it runs at normal speed even in 
+    // turbo mode
+    if (turbo && !rewinding) {
+        const FrameClock::TimePoint budgetEnd = clock.now() + 
+            TURBO_UPDATE_BUDGET;
+        do {
+            if (!runUpdate()) {
+                return false;
+            }
+        } while (clock.now() < budgetEnd);
+        // Paced updates measure their time from the end of the last turbo 
+        // burst
+        refreshUpdateTimer();
+    } else {
+        double deltaTime = getDeltaTime();
+
+        if (deltaTime > 0.25) {
+            deltaTime = 0.25;
+        }
 
-    accumulator += deltaTime;
+        accumulator += deltaTime;
 
-    while (accumulator >= UPDATE_INTERVAL) {
-        accumulator -= UPDATE_INTERVAL;
+        while (accumulator >= UPDATE_INTERVAL) {
+            accumulator -= UPDATE_INTERVAL;
 
-        for (int i = 0; i < instructionsPerUpdate; i++) {
-            interpreter.tick();
+            if (!runUpdate()) {
+                return false;
+            }
         }
+    }
 
-        interpreter.updateTimers();
+    renderer.drawFrame(interpreter.getFrame(), interpreter.takeDirtyRows());
+    return true;
+}
+
+/**
+ * Runs the instructions of a single 60 Hz update, then steps the timers and 
+ * records the state for rewinding. While rewinding, steps back one recorded 
+ * update instead. Returns false if the ROM faulted.
+ */
+bool Emulator::runUpdate() {
+    if (rewinding) {
+        rewindBuffer.rewind(interpreter);
+        return true;
     }
 
-    renderer.drawFrame(interpreter.getFrame());
+    const Fault& fault = interpreter.run(instructionsPerUpdate);
+    if (fault.kind != FaultKind::NONE) {
+        std::cerr << describeFault(fault) << "\n";
+        return false;
+    }
+    interpreter.updateTimers();
+    rewindBuffer.record(interpreter);
+    return true;
 }
 
-std::string Emulator::getDisassembledInstructions() const {
-    return interpreter.getDisassembledInstructions();
+std::string Emulator::disassemble(const int start, const int count) const {
+    return interpreter.disassemble(start, count);
 }
 
 uint8_t Emulator::getRegisterValue(const int index) const {
@@ -102,7 +195,7 @@ uint16_t Emulator::getStackValue(const int index) const {
 }
 
 double Emulator::getDeltaTime() {
-    const auto now = std::chrono::high_resolution_clock::now();
+    const FrameClock::TimePoint now = clock.now();
     const std::chrono::duration<double> deltaTime = now - lastUpdateTime;
     lastUpdateTime = now;
 
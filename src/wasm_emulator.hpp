@@ -1,9 +1,12 @@
 #pragma once
 
 #include <chrono>
-#include <filesystem>
+#include <cstddef>
+#include <cstdint>
 
+#include "frame_clock.hpp"
 #include "core/interpreter.hpp"
+#include "core/rewind_buffer.hpp"
 #include "io/input.hpp"
 #include "io/renderer.hpp"
 
@@ -15,14 +18,19 @@ public:
 
     void reset();
     void refreshUpdateTimer();
-    void loadRom(const std::filesystem::path& romPath);
+    void loadRom(const uint8_t* romData, const size_t romSize);
     void setSpeed(const int instructionsPerSecond);
     void setLoadStoreQuirk(const bool isEnabled);
     void setShiftQuirk(const bool isEnabled);
     void setWrapQuirk(const bool isEnabled);
-    void update();
+    void setTurbo(const bool isEnabled);
+    void seedRandom(const uint64_t seed);
+    void setRewinding(const bool isRewinding);
+    size_t saveState(uint8_t* buffer, const size_t bufferSize) const;
+    bool loadState(const uint8_t* buffer, const size_t bufferSize);
+    bool update();
 
-    std::string getDisassembledInstructions() const;
+    std::string disassemble(const int start, const int count) const;
     uint8_t getRegisterValue(const int index) const;
     uint16_t getProgramCounterValue() const;
     uint16_t getIndexRegisterValue() const;
@@ -33,15 +41,26 @@ public:
 private:
     static constexpr double UPDATES_PER_SECOND = 60.0;
     static constexpr double UPDATE_INTERVAL = 1.0 / UPDATES_PER_SECOND;
+    // Time spent running updates per browser frame in turbo mode, leaving the 
+    // rest of the frame to the browser
+    static constexpr std::chrono::milliseconds TURBO_UPDATE_BUDGET{12};
+    // Enough for roughly 20 minutes to an hour of the included ROMs, while 
+    // staying well within the initial WebAssembly memory
+    static constexpr size_t REWIND_CAPACITY = 4 << 20;
 
-    std::chrono::high_resolution_clock::time_point lastUpdateTime;
+    SystemClock clock;
+    FrameClock::TimePoint lastUpdateTime;
     double accumulator;
     int instructionsPerUpdate;
+    bool turbo;
 
     Interpreter interpreter;
+    RewindBuffer rewindBuffer;
+    bool rewinding;
     Input input;
     Renderer renderer;
 
+    bool runUpdate();
     double getDeltaTime();
 };
 
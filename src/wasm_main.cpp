@@ -1,3 +1,5 @@
+#include <array>
+#include <cstdint>
 #include <emscripten.h>
 #include <emscripten/bind.h>
 #include <string>
@@ -9,10 +11,15 @@ static constexpr int defaultWindowScale = 15;
 static constexpr int defaultEmulationSpeed = 700;
 
 OCTACHIP::Emulator emulator{defaultWindowScale, defaultEmulationSpeed};
+std::array<uint8_t, OCTACHIP::Interpreter::STATE_SIZE> stateBuffer{};
 
-extern "C" void loadRom(const char* romPath) {
+// ROM images are fetched from the ROM pack by the page, so the module starts 
+// without downloading any of them
+extern "C" void loadRom(const uint8_t* romData, const int size) {
     emulator.reset();
-    emulator.loadRom(romPath);
+    if (size >= 0) {
+        emulator.loadRom(romData, static_cast<size_t>(size));
+    }
 }
 
 extern "C" void setSpeed(const int emulationSpeed) {
@@ -45,6 +52,34 @@ extern "C" void setWrapQuirk(bool isEnabled) {
     emulator.setWrapQuirk(isEnabled);
 }
 
+extern "C" void setTurbo(bool isEnabled) {
+    emulator.setTurbo(isEnabled);
+}
+
+// JavaScript numbers only pass 32-bit integers through ccall
+extern "C" void seedRandom(const uint32_t seed) {
+    emulator.seedRandom(seed);
+}
+
+extern "C" void setRewinding(bool isRewinding) {
+    emulator.setRewinding(isRewinding);
+}
+
+extern "C" int getStateSize() {
+    return static_cast<int>(stateBuffer.size());
+}
+
+// Returns the address of the snapshot in the module's memory, where it stays 
+// until the next call
+extern "C" uint8_t* saveState() {
+    emulator.saveState(stateBuffer.data(), stateBuffer.size());
+    return stateBuffer.data();
+}
+
+extern "C" bool loadState(const uint8_t* state, const int size) {
+    return size >= 0 && emulator.loadState(state, static_cast<size_t>(size));
+}
+
 extern "C" uint8_t getRegisterValue(const int index) {
     return emulator.getRegisterValue(index);
 }
@@ -74,30 +109,33 @@ extern "C" uint16_t getStackValue(const int index) {
 }
 
 extern "C" void pushKeyDownEvent(const int key) {
-    SDL_Event event;
+    SDL_Event event{};
     event.type = SDL_KEYDOWN;
     event.key.keysym.sym = key;
     SDL_PushEvent(&event);
 }
 
 extern "C" void pushKeyUpEvent(const int key) {
-    SDL_Event event;
+    SDL_Event event{};
     event.type = SDL_KEYUP;
     event.key.keysym.sym = key;
     SDL_PushEvent(&event);
 }
 
-std::string getDisassembledInstructions() {
-    return emulator.getDisassembledInstructions();
+// Lists only the rows the monitor shows, so the listing costs the same no 
+// matter how large the ROM is
+std::string disassemble(const int start, const int count) {
+    return emulator.disassemble(start, count);
 }
 
 EMSCRIPTEN_BINDINGS(my_module) {
-    emscripten::function("getDisassembledInstructions", 
-        &getDisassembledInstructions);
+    emscripten::function("disassemble", &disassemble);
 }
 
 void mainLoop() {
-    emulator.update();
+    if (!emulator.update()) {
+        emscripten_cancel_main_loop();
+    }
 }
 
 extern "C" int main() {
@@ -0,0 +1,231 @@
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "batch/batch_runner.hpp"
+#include "batch/json.hpp"
+#include "batch/mapped_file.hpp"
+#include "batch/thread_pool.hpp"
+#include "core/input_movie.hpp"
+#include "core/interpreter.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+std::filesystem::path writeTempFile(const std::string& name, 
+    const std::vector<uint8_t>& contents) {
+    const std::filesystem::path path = 
+        std::filesystem::temp_directory_path() / name;
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(contents.data()), 
+        static_cast<std::streamsize>(contents.size()));
+    return path;
+}
+
+// Writes a ROM list with a single entry that has the given speed
+std::filesystem::path writeRomList(const std::string& speed) {
+    const std::string list = "[{\"filename\": \"test.ch8\", \"speed\": " + 
+        speed + ", \"loadStoreQuirk\": false, \"shiftQuirk\": false, " 
+        "\"wrapQuirk\": true}]";
+    return writeTempFile("octachip_roms.json", 
+        std::vector<uint8_t>(list.begin(), list.end()));
+}
+
+RomProfile makeProfile(const std::filesystem::path& path, const int speed) {
+    RomProfile profile{};
+    profile.title = "Test";
+    profile.path = path;
+    profile.speed = speed;
+    return profile;
+}
+
+}
+
+TEST(JsonTest, ParseJson_RomList_ReadsFields) {
+    const JsonValue document = parseJson(
+        "[{\"title\": \"A \\\"B\\\"\", \"speed\": 1200, \"wrapQuirk\": true}]");
+
+    ASSERT_EQ(JsonValue::Type::ARRAY, document.type);
+    ASSERT_EQ(1u, document.array.size());
+    const JsonValue& entry = document.array[0];
+    EXPECT_EQ("A \"B\"", entry.find("title")->string);
+    EXPECT_EQ(1200.0, entry.find("speed")->number);
+    EXPECT_TRUE(entry.find("wrapQuirk")->boolean);
+    EXPECT_EQ(nullptr, entry.find("shiftQuirk"));
+}
+
+TEST(JsonTest, ParseJson_InvalidDocument_Throws) {
+    EXPECT_THROW(parseJson("[1, 2"), std::runtime_error);
+    EXPECT_THROW(parseJson("{\"a\": 1} x"), std::runtime_error);
+}
+
+TEST(JsonTest, QuoteJson_EscapesSpecialCharacters) {
+    EXPECT_EQ("\"a\\\"b\\\\c\\nd\\u0001\"", quoteJson("a\"b\\c\nd\x01"));
+}
+
+TEST(ThreadPoolTest, Wait_RunsEverySubmittedTask) {
+    std::atomic<int> counter{0};
+    ThreadPool pool{3};
+
+    for (int task = 0; task < 100; task++) {
+        pool.submit([&counter] { counter++; });
+    }
+    pool.wait();
+
+    EXPECT_EQ(100, counter.load());
+}
+
+TEST(BatchRunnerTest, LoadRomProfiles_ValidEntry_ReadsFields) {
+    const std::vector<RomProfile> profiles = 
+        loadRomProfiles(writeRomList("1200"), "roms");
+
+    ASSERT_EQ(1u, profiles.size());
+    EXPECT_EQ("test.ch8", profiles[0].title);
+    EXPECT_EQ(std::filesystem::path{"roms"} / "test.ch8", profiles[0].path);
+    EXPECT_EQ(1200, profiles[0].speed);
+    EXPECT_FALSE(profiles[0].loadStoreQuirk);
+    EXPECT_FALSE(profiles[0].shiftQuirk);
+    EXPECT_TRUE(profiles[0].wrapQuirk);
+}
+
+TEST(BatchRunnerTest, LoadRomProfiles_SpeedOutOfRange_Throws) {
+    // The parser reads nan and inf as numbers, and none of these speeds 
+    // fit in an int
+    for (const std::string speed : {"0", "-600", "1e12", "1e999", "nan", 
+        "inf"}) {
+        EXPECT_THROW(loadRomProfiles(writeRomList(speed), "roms"), 
+            std::runtime_error) << speed;
+    }
+}
+
+TEST(BatchRunnerTest, RunRom_InfiniteLoop_StopsAtBudget) {
+    const std::filesystem::path path = writeTempFile("octachip_loop.ch8", {
+        0x70, 0x01, // 0x200: ADD V0, 0x01
+        0x12, 0x00  // 0x202: JP 0x200
+    });
+    BatchLimits limits{};
+    limits.frameCount = 100;
+    limits.instructionBudget = 250;
+
+    const RunResult result = runRom(makeProfile(path, 600), limits);
+
+    EXPECT_TRUE(result.budgetExceeded);
+    EXPECT_EQ(25, result.framesRun);
+    EXPECT_EQ(250u, result.executedInstructionCount);
+    EXPECT_EQ(FaultKind::NONE, result.fault.kind);
+    std::filesystem::remove(path);
+}
+
+TEST(BatchRunnerTest, RunRom_IllegalOpcode_ReportsFault) {
+    const std::filesystem::path path = writeTempFile("octachip_fault.ch8", {
+        0x60, 0x01, // 0x200: LD V0, 0x01
+        0xFF, 0xFF  // 0x202: illegal
+    });
+    BatchLimits limits{};
+    limits.frameCount = 10;
+
+    const RunResult result = runRom(makeProfile(path, 600), limits);
+
+    EXPECT_EQ(FaultKind::ILLEGAL_OPCODE, result.fault.kind);
+    EXPECT_EQ(0x202, result.fault.pc);
+    EXPECT_EQ(0, result.framesRun);
+    EXPECT_EQ(1u, result.executedInstructionCount);
+    std::filesystem::remove(path);
+}
+
+TEST(BatchRunnerTest, RunBatch_MissingRom_ReportsErrorInOrder) {
+    const std::filesystem::path path = writeTempFile("octachip_idle.ch8", {
+        0x12, 0x00  // 0x200: JP 0x200
+    });
+    BatchLimits limits{};
+    limits.frameCount = 5;
+    const std::vector<RomProfile> profiles = {
+        makeProfile(path, 600), 
+        makeProfile(path.parent_path() / "octachip_missing.ch8", 600)
+    };
+
+    const std::vector<RunResult> results = runBatch(profiles, limits, 2);
+
+    ASSERT_EQ(2u, results.size());
+    EXPECT_TRUE(results[0].error.empty());
+    EXPECT_EQ(5, results[0].framesRun);
+    EXPECT_EQ(hashFrame(Frame{}), results[0].frameHash);
+    EXPECT_FALSE(results[1].error.empty());
+    EXPECT_EQ(0, results[1].framesRun);
+    std::filesystem::remove(path);
+}
+
+TEST(BatchRunnerTest, ReplayMovie_RecordedMovie_MatchesListedRom) {
+    const std::vector<uint8_t> rom = {
+        0xF0, 0x0A, // 0x200: LD V0, K
+        0x71, 0x01, // 0x202: ADD V1, 0x01
+        0x12, 0x00  // 0x204: JP 0x200
+    };
+    const std::filesystem::path romPath = 
+        writeTempFile("octachip_movie.ch8", rom);
+    Interpreter interpreter{};
+    MovieRecorder recorder{interpreter, 1, 10};
+    ASSERT_FALSE(recorder.start(rom.data(), rom.size()).has_value());
+    for (int frame = 0; frame < 20; frame++) {
+        recorder.setKey(0x5, frame % 4 == 1);
+        recorder.runFrame();
+    }
+    const std::filesystem::path moviePath = 
+        writeTempFile("octachip_movie.movie", encodeMovie(recorder.finish()));
+    const std::vector<RomProfile> profiles = {
+        makeProfile(romPath.parent_path() / "octachip_missing.ch8", 600), 
+        makeProfile(romPath, 600)
+    };
+
+    const MovieResult result = replayMovie(moviePath, profiles);
+
+    EXPECT_TRUE(result.error.empty());
+    EXPECT_EQ("Test", result.title);
+    EXPECT_EQ(20u, result.framesRun);
+    EXPECT_EQ(interpreter.getExecutedInstructionCount(), 
+        result.executedInstructionCount);
+    EXPECT_TRUE(result.matchesRecording);
+    std::filesystem::remove(romPath);
+    std::filesystem::remove(moviePath);
+}
+
+TEST(BatchRunnerTest, LoadPackProfiles_WrittenPack_RunsLikeRomFiles) {
+    const std::filesystem::path romPath = writeTempFile("octachip_pack.ch8", {
+        0x60, 0x05, // 0x200: LD V0, 0x05
+        0xF0, 0x29, // 0x202: LD F, V0
+        0xD1, 0x25, // 0x204: DRW V1, V2, 0x5
+        0x71, 0x08, // 0x206: ADD V1, 0x08
+        0x12, 0x04  // 0x208: JP 0x204
+    });
+    const std::filesystem::path packPath = 
+        std::filesystem::temp_directory_path() / "octachip_pack.pack";
+    std::vector<RomProfile> profiles = {makeProfile(romPath, 600)};
+    profiles[0].wrapQuirk = true;
+    writeRomPack(profiles, packPath);
+    BatchLimits limits{};
+    limits.frameCount = 10;
+
+    const MappedFile pack{packPath};
+    const std::vector<RomProfile> packProfiles = loadPackProfiles(pack);
+
+    ASSERT_EQ(1u, packProfiles.size());
+    EXPECT_EQ("Test", packProfiles[0].title);
+    EXPECT_EQ("octachip_pack.ch8", packProfiles[0].path.string());
+    EXPECT_EQ(600, packProfiles[0].speed);
+    EXPECT_TRUE(packProfiles[0].wrapQuirk);
+    const RunResult fileResult = runRom(profiles[0], limits);
+    const RunResult packResult = runRom(packProfiles[0], limits);
+    EXPECT_TRUE(packResult.error.empty());
+    EXPECT_EQ(fileResult.executedInstructionCount, 
+        packResult.executedInstructionCount);
+    EXPECT_EQ(fileResult.frameHash, packResult.frameHash);
+    EXPECT_NE(hashFrame(Frame{}), packResult.frameHash);
+    std::filesystem::remove(romPath);
+    std::filesystem::remove(packPath);
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "core/block_cache.hpp"
+#include "core/fault.hpp"
+#include "core/instruction_cache.hpp"
+#include "core/interpreter.hpp"
+#include "core/types.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+Memory makeMemory(const std::vector<uint8_t>& program) {
+    Memory memory{};
+    for (std::size_t i = 0; i < program.size(); i++) {
+        memory[0x200 + i] = program[i];
+    }
+    return memory;
+}
+
+}
+
+TEST(BlockCacheTest, Fetch_EndsAtTerminatingInstruction) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x60, 0x01, // 0x200: LD V0, 0x01
+        0x71, 0x02, // 0x202: ADD V1, 0x02
+        0x30, 0x01, // 0x204: SE V0, 0x01
+        0x60, 0x02  // 0x206: LD V0, 0x02
+    });
+
+    const Block& block = cache.fetch(memory, 0x200);
+
+    // The block should include the skip that ends it, but nothing after it
+    EXPECT_EQ(3, block.length);
+    EXPECT_EQ(3, block.instructionCount);
+    EXPECT_EQ(Operation::SE_VX_BYTE, cache.microOps(block)[2].operation);
+}
+
+TEST(BlockCacheTest, Fetch_StraightLineCode_StopsAtMaximumLength) {
+    BlockCache cache{};
+    Memory memory{};
+    for (int i = 0x200; i < MEMORY_SIZE; i += 2) {
+        memory[i] = 0x70; // ADD V0, 0x01
+        memory[i + 1] = 0x01;
+    }
+
+    EXPECT_EQ(BlockCache::MAX_BLOCK_LENGTH,
+        cache.fetch(memory, 0x200).instructionCount);
+}
+
+TEST(BlockCacheTest, Fetch_SkipFollowedByJump_FusesConditionalJump) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x30, 0x01, // 0x200: SE V0, 0x01
+        0x12, 0x00  // 0x202: JP 0x200
+    });
+
+    const Block& block = cache.fetch(memory, 0x200);
+
+    // The skip and the jump should be executed as a single micro-op
+    ASSERT_EQ(1, block.length);
+    EXPECT_EQ(2, block.instructionCount);
+    EXPECT_EQ(Operation::SE_VX_BYTE_JP, cache.microOps(block)[0].operation);
+    EXPECT_EQ(0x200, cache.microOps(block)[0].fused.address());
+}
+
+TEST(BlockCacheTest, Fetch_ConsecutiveByteLoads_FusesPairs) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x60, 0x01, // 0x200: LD V0, 0x01
+        0x61, 0x02, // 0x202: LD V1, 0x02
+        0x62, 0x03, // 0x204: LD V2, 0x03
+        0x12, 0x00  // 0x206: JP 0x200
+    });
+
+    const Block& block = cache.fetch(memory, 0x200);
+    const MicroOp* microOps = cache.microOps(block);
+
+    ASSERT_EQ(3, block.length);
+    EXPECT_EQ(4, block.instructionCount);
+    EXPECT_EQ(Operation::LD_VX_BYTE_PAIR, microOps[0].operation);
+    EXPECT_EQ(0x6102, microOps[0].fused.full());
+    EXPECT_EQ(Operation::LD_VX_BYTE, microOps[1].operation);
+    EXPECT_EQ(Operation::JP_ADDR, microOps[2].operation);
+}
+
+TEST(BlockCacheTest, Fetch_OverwrittenFlag_DropsFlagResult) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x80, 0x14, // 0x200: ADD V0, V1
+        0x80, 0x25, // 0x202: SUB V0, V2
+        0x6F, 0x00, // 0x204: LD VF, 0x00
+        0x12, 0x00  // 0x206: JP 0x200
+    });
+
+    const Block& block = cache.fetch(memory, 0x200);
+    const MicroOp* microOps = cache.microOps(block);
+
+    // Neither flag result is read before LD VF overwrites it
+    ASSERT_EQ(4, block.length);
+    EXPECT_EQ(Operation::ADD_VX_VY_NO_FLAG, microOps[0].operation);
+    EXPECT_EQ(Operation::SUB_VX_VY_NO_FLAG, microOps[1].operation);
+}
+
+TEST(BlockCacheTest, Fetch_ObservedFlag_KeepsFlagResult) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x80, 0x14, // 0x200: ADD V0, V1
+        0x81, 0xF0, // 0x202: LD V1, VF
+        0x80, 0x14, // 0x204: ADD V0, V1
+        0x12, 0x00  // 0x206: JP 0x200
+    });
+
+    const Block& block = cache.fetch(memory, 0x200);
+    const MicroOp* microOps = cache.microOps(block);
+
+    // The first carry is read by LD V1, VF, and the second one is still live
+    // when the block ends
+    ASSERT_EQ(4, block.length);
+    EXPECT_EQ(Operation::ADD_VX_VY, microOps[0].operation);
+    EXPECT_EQ(Operation::ADD_VX_VY, microOps[2].operation);
+}
+
+TEST(BlockCacheTest, Fetch_FlagBeforeDraw_KeepsFlagResult) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x80, 0x14, // 0x200: ADD V0, V1
+        0xD2, 0x35, // 0x202: DRW V2, V3, 0x5
+        0x12, 0x00  // 0x204: JP 0x200
+    });
+
+    const Block& block = cache.fetch(memory, 0x200);
+    const MicroOp* microOps = cache.microOps(block);
+
+    // DRW faults before writing VF when its sprite runs past the end of
+    // memory, so the carry may still be observed
+    ASSERT_EQ(2, block.length);
+    EXPECT_EQ(Operation::ADD_VX_VY, microOps[0].operation);
+}
+
+TEST(BlockCacheTest, Run_FaultingDrawAfterCarry_MatchesTick) {
+    const std::vector<uint8_t> rom = {
+        0xAF, 0xFE, // 0x200: LD I, 0xFFE
+        0x60, 0xFF, // 0x202: LD V0, 0xFF
+        0x61, 0x02, // 0x204: LD V1, 0x02
+        0x80, 0x14, // 0x206: ADD V0, V1
+        0xD2, 0x35, // 0x208: DRW V2, V3, 0x5
+        0x12, 0x0A  // 0x20A: JP 0x20A
+    };
+    Interpreter ticked{};
+    Interpreter run{};
+    ASSERT_FALSE(ticked.loadRom(rom.data(), rom.size()).has_value());
+    ASSERT_FALSE(run.loadRom(rom.data(), rom.size()).has_value());
+
+    FaultKind tickedFault = FaultKind::NONE;
+    for (int i = 0; i < 5 && tickedFault == FaultKind::NONE; i++) {
+        tickedFault = ticked.tick().kind;
+    }
+    const FaultKind runFault = run.run(5).kind;
+
+    // The carry of ADD has to survive the faulting DRW in both engines
+    EXPECT_EQ(FaultKind::MEMORY_OUT_OF_BOUNDS, tickedFault);
+    EXPECT_EQ(tickedFault, runFault);
+    EXPECT_EQ(0x1, ticked.getRegisterValue(0xF));
+    EXPECT_EQ(ticked.getRegisterValue(0xF), run.getRegisterValue(0xF));
+    EXPECT_EQ(ticked.getProgramCounterValue(), run.getProgramCounterValue());
+}
+
+TEST(BlockCacheTest, Fetch_DelayTimerPollingLoop_MarksIdleLoop) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0x12, 0x00, // 0x200: JP 0x200
+        0xF3, 0x07, // 0x202: LD V3, DT
+        0x33, 0x00, // 0x204: SE V3, 0x00
+        0x12, 0x02  // 0x206: JP 0x202
+    });
+
+    EXPECT_TRUE(cache.fetch(memory, 0x200).idleLoop);
+    EXPECT_TRUE(cache.fetch(memory, 0x202).idleLoop);
+}
+
+TEST(BlockCacheTest, Fetch_LoopTestingAnotherRegister_IsNotIdleLoop) {
+    BlockCache cache{};
+    const Memory memory = makeMemory({
+        0xF3, 0x07, // 0x200: LD V3, DT
+        0x34, 0x00, // 0x202: SE V4, 0x00
+        0x12, 0x00  // 0x204: JP 0x200
+    });
+
+    // V4 never changes inside the loop, so it does not wait on the timer
+    EXPECT_FALSE(cache.fetch(memory, 0x200).idleLoop);
+}
+
+TEST(BlockCacheTest, Invalidate_WriteIntoBlock_RetranslatesBlock) {
+    BlockCache cache{};
+    Memory memory = makeMemory({
+        0x60, 0x01, // 0x200: LD V0, 0x01
+        0x71, 0x02, // 0x202: ADD V1, 0x02
+        0x12, 0x00  // 0x204: JP 0x200
+    });
+
+    ASSERT_EQ(3, cache.fetch(memory, 0x200).instructionCount);
+
+    // Turn the second instruction into a jump
+    memory[0x202] = 0x12;
+    cache.invalidate(0x202, 1);
+
+    EXPECT_EQ(2, cache.fetch(memory, 0x200).instructionCount);
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "core/c_api.h"
+
+TEST(CApiTest, Create_NonPositiveInstructionCount_ReturnsNull) {
+    EXPECT_EQ(nullptr, octachip_create(0));
+    EXPECT_EQ(nullptr, octachip_create(-1));
+}
+
+TEST(CApiTest, LoadRom_RomTooLarge_ReturnsError) {
+    octachip_instance* instance = octachip_create(10);
+    const std::vector<uint8_t> rom(4096 - 0x200 + 1);
+
+    EXPECT_EQ(-1, octachip_load_rom(instance, rom.data(), rom.size()));
+    EXPECT_EQ(0, octachip_load_rom(instance, rom.data(), rom.size() - 1));
+
+    octachip_destroy(instance);
+}
+
+TEST(CApiTest, Step_DrawsSpriteIntoFrame) {
+    octachip_instance* instance = octachip_create(10);
+    const std::vector<uint8_t> rom = {
+        0x63, 0x04, // 0x200: LD V3, 0x04
+        0xF3, 0x29, // 0x202: LD F, V3
+        0xD0, 0x35, // 0x204: DRW V0, V3, 5
+        0x12, 0x06  // 0x206: JP 0x206
+    };
+    ASSERT_EQ(0, octachip_load_rom(instance, rom.data(), rom.size()));
+
+    EXPECT_EQ(OCTACHIP_FAULT_NONE, octachip_step(instance, 2));
+
+    octachip_registers registers{};
+    octachip_read_registers(instance, &registers);
+    EXPECT_EQ(0x04, registers.v[3]);
+    EXPECT_EQ(0x206, registers.pc);
+
+    // The top row of the font sprite for 4 is 0x90, drawn at row 4
+    std::vector<uint64_t> rows(OCTACHIP_FRAME_HEIGHT);
+    octachip_read_frame_rows(instance, rows.data());
+    EXPECT_EQ(uint64_t{0x90} << 56, rows[4]);
+
+    std::vector<uint8_t> pixels(OCTACHIP_FRAME_WIDTH * OCTACHIP_FRAME_HEIGHT);
+    octachip_read_frame(instance, pixels.data());
+    EXPECT_EQ(1, pixels[4 * OCTACHIP_FRAME_WIDTH]);
+    EXPECT_EQ(0, pixels[4 * OCTACHIP_FRAME_WIDTH + 1]);
+    EXPECT_EQ(1, pixels[4 * OCTACHIP_FRAME_WIDTH + 3]);
+
+    octachip_destroy(instance);
+}
+
+TEST(CApiTest, Step_WaitForKey_ResumesAfterKeyIsReleased) {
+    octachip_instance* instance = octachip_create(10);
+    const std::vector<uint8_t> rom = {
+        0xF3, 0x0A, // 0x200: LD V3, K
+        0x12, 0x02  // 0x202: JP 0x202
+    };
+    ASSERT_EQ(0, octachip_load_rom(instance, rom.data(), rom.size()));
+
+    // Keys outside of the keypad should be ignored
+    octachip_set_key(instance, OCTACHIP_KEY_COUNT, 1);
+    octachip_step(instance, 1);
+    octachip_set_key(instance, 0x5, 1);
+    octachip_step(instance, 1);
+    octachip_set_key(instance, 0x5, 0);
+    octachip_step(instance, 1);
+
+    octachip_registers registers{};
+    octachip_read_registers(instance, &registers);
+    EXPECT_EQ(0x05, registers.v[3]);
+    EXPECT_EQ(0x202, registers.pc);
+
+    octachip_destroy(instance);
+}
+
+TEST(CApiTest, Step_IllegalOpcode_ReturnsFault) {
+    octachip_instance* instance = octachip_create(10);
+    const std::vector<uint8_t> rom = {
+        0xFF, 0xFF // 0x200: Illegal opcode
+    };
+    ASSERT_EQ(0, octachip_load_rom(instance, rom.data(), rom.size()));
+
+    EXPECT_EQ(OCTACHIP_FAULT_ILLEGAL_OPCODE, octachip_step(instance, 1));
+
+    octachip_destroy(instance);
+}
+
+TEST(CApiTest, LoadState_RestoresRegisters) {
+    octachip_instance* instance = octachip_create(1);
+    const std::vector<uint8_t> rom = {
+        0x70, 0x01, // 0x200: ADD V0, 0x01
+        0x12, 0x00  // 0x202: JP 0x200
+    };
+    ASSERT_EQ(0, octachip_load_rom(instance, rom.data(), rom.size()));
+    octachip_step(instance, 3);
+
+    std::vector<uint8_t> state(OCTACHIP_STATE_SIZE);
+    EXPECT_EQ(0u, octachip_save_state(instance, state.data(), 
+        state.size() - 1));
+    ASSERT_EQ(state.size(), 
+        octachip_save_state(instance, state.data(), state.size()));
+    octachip_step(instance, 4);
+
+    EXPECT_EQ(-1, octachip_load_state(instance, state.data(), 16));
+    EXPECT_EQ(0, octachip_load_state(instance, state.data(), state.size()));
+
+    octachip_registers registers{};
+    octachip_read_registers(instance, &registers);
+    EXPECT_EQ(0x02, registers.v[0]);
+
+    const uint64_t hash = octachip_state_hash(instance);
+    octachip_step(instance, 4);
+    EXPECT_NE(hash, octachip_state_hash(instance));
+    octachip_load_state(instance, state.data(), state.size());
+    EXPECT_EQ(hash, octachip_state_hash(instance));
+
+    octachip_destroy(instance);
+}
+
+namespace {
+
+// Draws the font sprite for 4 once key 0 is pressed, then stores V0 to V3 at 
+// 0x300
+const std::vector<uint8_t> DRAW_ON_KEY_ROM = {
+    0x63, 0x04, // 0x200: LD V3, 0x04
+    0xF3, 0x29, // 0x202: LD F, V3
+    0xE0, 0x9E, // 0x204: SKP V0
+    0x12, 0x04, // 0x206: JP 0x204
+    0xD0, 0x35, // 0x208: DRW V0, V3, 5
+    0xA3, 0x00, // 0x20A: LD I, 0x300
+    0xF3, 0x55, // 0x20C: LD [I], V3
+    0x12, 0x0E  // 0x20E: JP 0x20E
+};
+
+octachip_env_config makeEnvConfig() {
+    octachip_env_config config{};
+    config.instructions_per_frame = 10;
+    config.frame_stack = 1;
+    config.load_store_quirk = 1;
+    config.shift_quirk = 1;
+    return config;
+}
+
+}
+
+TEST(CApiTest, EnvCreate_InvalidConfigOrRom_ReturnsNull) {
+    octachip_env_config config = makeEnvConfig();
+    const std::vector<uint8_t> rom(4096 - 0x200 + 1);
+    EXPECT_EQ(nullptr, octachip_env_create(&config, rom.data(), rom.size()));
+
+    config.frame_stack = 0;
+    EXPECT_EQ(nullptr, octachip_env_create(&config, 
+        DRAW_ON_KEY_ROM.data(), DRAW_ON_KEY_ROM.size()));
+}
+
+TEST(CApiTest, EnvStep_WritesFrameStackAndRam) {
+    const uint16_t ramAddresses[] = {0x303, 0x1000};
+    octachip_env_config config = makeEnvConfig();
+    config.frame_stack = 2;
+    config.ram_addresses = ramAddresses;
+    config.ram_address_count = 2;
+    octachip_env* env = octachip_env_create(&config, 
+        DRAW_ON_KEY_ROM.data(), DRAW_ON_KEY_ROM.size());
+    ASSERT_NE(nullptr, env);
+
+    std::vector<uint64_t> frames(2 * OCTACHIP_FRAME_HEIGHT, ~uint64_t{0});
+    std::vector<uint8_t> ram(2, 0xFF);
+    octachip_step_result result = 
+        octachip_env_reset(env, 1, frames.data(), ram.data());
+    EXPECT_EQ(0, result.done);
+    EXPECT_EQ(std::vector<uint64_t>(2 * OCTACHIP_FRAME_HEIGHT), frames);
+    EXPECT_EQ(0x00, ram[0]);
+
+    result = octachip_env_step(env, 0, 1, frames.data(), ram.data());
+    EXPECT_EQ(0, result.frame_changed);
+
+    result = octachip_env_step(env, 1 << 0x0, 1, frames.data(), ram.data());
+    EXPECT_EQ(1, result.frame_changed);
+    EXPECT_EQ(OCTACHIP_FAULT_NONE, result.fault);
+    // The newest frame comes first
+    EXPECT_EQ(uint64_t{0x90} << 56, frames[4]);
+    EXPECT_EQ(0u, frames[OCTACHIP_FRAME_HEIGHT + 4]);
+    EXPECT_EQ(0x04, ram[0]);
+    // Addresses outside of memory read as 0
+    EXPECT_EQ(0x00, ram[1]);
+
+    result = octachip_env_step(env, 0, 1, frames.data(), ram.data());
+    EXPECT_EQ(0, result.frame_changed);
+    EXPECT_EQ(uint64_t{0x90} << 56, frames[OCTACHIP_FRAME_HEIGHT + 4]);
+
+    octachip_env_destroy(env);
+}
+
+TEST(CApiTest, EnvStep_MaxFramesReached_IsDoneUntilReset) {
+    octachip_env_config config = makeEnvConfig();
+    config.max_frames = 3;
+    octachip_env* env = octachip_env_create(&config, 
+        DRAW_ON_KEY_ROM.data(), DRAW_ON_KEY_ROM.size());
+    ASSERT_NE(nullptr, env);
+
+    octachip_env_reset(env, 1, nullptr, nullptr);
+    EXPECT_EQ(0, octachip_env_step(env, 0, 2, nullptr, nullptr).done);
+    EXPECT_EQ(1, octachip_env_step(env, 0, 2, nullptr, nullptr).done);
+    EXPECT_EQ(1, octachip_env_step(env, 0, 2, nullptr, nullptr).done);
+
+    EXPECT_EQ(0, octachip_env_reset(env, 1, nullptr, nullptr).done);
+    EXPECT_EQ(0, octachip_env_step(env, 0, 1, nullptr, nullptr).done);
+
+    octachip_env_destroy(env);
+}
+
+TEST(CApiTest, EnvStep_IllegalOpcode_IsDone) {
+    const std::vector<uint8_t> rom = {
+        0xFF, 0xFF // 0x200: Illegal opcode
+    };
+    octachip_env_config config = makeEnvConfig();
+    octachip_env* env = octachip_env_create(&config, rom.data(), rom.size());
+    ASSERT_NE(nullptr, env);
+
+    octachip_env_reset(env, 1, nullptr, nullptr);
+    const octachip_step_result result = 
+        octachip_env_step(env, 0, 4, nullptr, nullptr);
+    EXPECT_EQ(1, result.done);
+    EXPECT_EQ(OCTACHIP_FAULT_ILLEGAL_OPCODE, result.fault);
+
+    octachip_env_destroy(env);
+}
+
+TEST(CApiTest, EnvReset_SameSeed_RepeatsRandomValues) {
+    const std::vector<uint8_t> rom = {
+        0xC0, 0xFF, // 0x200: RND V0, 0xFF
+        0xC1, 0xFF, // 0x202: RND V1, 0xFF
+        0xA3, 0x00, // 0x204: LD I, 0x300
+        0xF1, 0x55, // 0x206: LD [I], V1
+        0x12, 0x08  // 0x208: JP 0x208
+    };
+    const uint16_t ramAddresses[] = {0x300, 0x301};
+    octachip_env_config config = makeEnvConfig();
+    config.ram_addresses = ramAddresses;
+    config.ram_address_count = 2;
+    octachip_env* env = octachip_env_create(&config, rom.data(), rom.size());
+    ASSERT_NE(nullptr, env);
+
+    std::vector<uint8_t> first(2);
+    octachip_env_reset(env, 42, nullptr, nullptr);
+    octachip_env_step(env, 0, 1, nullptr, first.data());
+
+    std::vector<uint8_t> second(2);
+    octachip_env_reset(env, 42, nullptr, nullptr);
+    octachip_env_step(env, 0, 1, nullptr, second.data());
+    EXPECT_EQ(first, second);
+
+    octachip_env_destroy(env);
+}
\ No newline at end of file
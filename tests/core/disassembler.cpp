@@ -0,0 +1,63 @@
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "core/disassembler.hpp"
+#include "core/interpreter.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+std::string format(const uint16_t opcode) {
+    std::array<char, MAX_MNEMONIC_LENGTH> text{};
+    const int length = formatInstruction(opcode, text.data());
+    return std::string(text.data(), length);
+}
+
+}
+
+TEST(DisassemblerTest, FormatInstruction_Opcodes_WritesMnemonics) {
+    EXPECT_EQ("CLS", format(0x00E0));
+    EXPECT_EQ("JP 0x0ABC", format(0x1ABC));
+    EXPECT_EQ("SE V3, 0x0F", format(0x330F));
+    EXPECT_EQ("SUBN V1, V2", format(0x8127));
+    EXPECT_EQ("JP V0, 0x0FFF", format(0xBFFF));
+    EXPECT_EQ("DRW VF, VF, 0xF", format(0xDFFF));
+    EXPECT_EQ("LD V4, [I]", format(0xF465));
+    EXPECT_EQ("-", format(0x0123));
+    EXPECT_EQ("-", format(0x8008));
+    EXPECT_EQ("-", format(0xF0FF));
+}
+
+TEST(DisassemblerTest, Disassemble_Range_ListsEveryAddress) {
+    Interpreter interpreter{};
+    const std::vector<uint8_t> rom = {0x00, 0xE0, 0x12, 0x00};
+    ASSERT_FALSE(interpreter.loadRom(rom.data(), rom.size()).has_value());
+
+    EXPECT_EQ("0x0200: CLS\n0x0201: -\n0x0202: JP 0x0200\n", 
+        interpreter.disassemble(0x200, 3));
+    EXPECT_EQ("0x0FFE: -\n0x0FFF: -\n", interpreter.disassemble(0xFFE, 5));
+    EXPECT_EQ("", interpreter.disassemble(0x1000, 1));
+    EXPECT_EQ("", interpreter.disassemble(0x200, -1));
+}
+
+TEST(DisassemblerTest, Disassemble_AfterStore_ShowsNewInstruction) {
+    Interpreter interpreter{};
+    const std::vector<uint8_t> rom = {
+        0xA2, 0x07, // 0x200: LD I, 0x207
+        0x60, 0x12, // 0x202: LD V0, 0x12
+        0xF0, 0x55, // 0x204: LD [I], V0
+        0x12, 0x06  // 0x206: JP 0x206
+    };
+    ASSERT_FALSE(interpreter.loadRom(rom.data(), rom.size()).has_value());
+    EXPECT_EQ("0x0206: JP 0x0206\n0x0207: -\n", 
+        interpreter.disassemble(0x206, 2));
+
+    interpreter.run(3);
+
+    EXPECT_EQ("0x0206: JP 0x0212\n0x0207: JP 0x0200\n", 
+        interpreter.disassemble(0x206, 2));
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include "frame_clock.hpp"
+#include "frame_scheduler.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+constexpr double FRAMES_PER_SECOND = 60.0;
+
+double secondsBetween(const FrameClock::TimePoint start, 
+    const FrameClock::TimePoint end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Moves the virtual clock forward as if the caller spent the given number of 
+// frame intervals on a frame
+void spendFrames(VirtualClock& clock, const double frames) {
+    clock.sleepUntil(clock.now() + 
+        std::chrono::duration_cast<FrameClock::Duration>(
+            std::chrono::duration<double>(frames / FRAMES_PER_SECOND)));
+}
+
+}
+
+TEST(FrameSchedulerTest, WaitForNextFrame_OnTime_PacesAtFrameRate) {
+    VirtualClock clock{};
+    FrameScheduler scheduler{FRAMES_PER_SECOND, clock};
+    scheduler.start();
+    const FrameClock::TimePoint start = clock.now();
+
+    for (int frame = 0; frame < 60; frame++) {
+        EXPECT_EQ(1, scheduler.waitForNextFrame());
+    }
+
+    // Sixty frames at 60 Hz should take a second of clock time, with every 
+    // frame starting on its deadline
+    EXPECT_NEAR(1.0, secondsBetween(start, clock.now()), 1e-6);
+    const FramePacing pacing = scheduler.getPacing();
+    EXPECT_EQ(60u, pacing.frameCount);
+    EXPECT_EQ(0u, pacing.droppedFrameCount);
+    EXPECT_DOUBLE_EQ(0.0, pacing.maxJitterMilliseconds);
+}
+
+TEST(FrameSchedulerTest, WaitForNextFrame_LateFrame_CatchesUp) {
+    VirtualClock clock{};
+    FrameScheduler scheduler{FRAMES_PER_SECOND, clock};
+    scheduler.start();
+    const FrameClock::TimePoint start = clock.now();
+    ASSERT_EQ(1, scheduler.waitForNextFrame());
+
+    spendFrames(clock, 2.5);
+
+    // The frame that ran late leaves the next deadline a frame and a half in 
+    // the past, so two frames are due at once, after which pacing resumes on 
+    // the original deadlines
+    EXPECT_EQ(2, scheduler.waitForNextFrame());
+    EXPECT_EQ(1, scheduler.waitForNextFrame());
+    EXPECT_NEAR(4.0 / FRAMES_PER_SECOND, secondsBetween(start, clock.now()), 
+        1e-6);
+    EXPECT_NEAR(1500.0 / FRAMES_PER_SECOND, 
+        scheduler.getPacing().maxJitterMilliseconds, 1e-3);
+}
+
+TEST(FrameSchedulerTest, WaitForNextFrame_LongStall_DropsFramesBeyondLimit) {
+    VirtualClock clock{};
+    FrameScheduler scheduler{FRAMES_PER_SECOND, clock};
+    scheduler.start();
+    ASSERT_EQ(1, scheduler.waitForNextFrame());
+
+    spendFrames(clock, 60.0);
+
+    // Only a quarter second of frames is caught up on, and the rest are 
+    // dropped rather than run back to back
+    EXPECT_EQ(15, scheduler.waitForNextFrame());
+    EXPECT_EQ(45u, scheduler.getPacing().droppedFrameCount);
+    EXPECT_EQ(1, scheduler.waitForNextFrame());
+}
+
+TEST(FrameSchedulerTest, WaitForNextFrame_VirtualClock_DoesNotWaitInRealTime) {
+    VirtualClock clock{};
+    FrameScheduler scheduler{FRAMES_PER_SECOND, clock};
+    scheduler.start();
+    const FrameClock::TimePoint virtualStart = clock.now();
+    const auto realStart = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < 600; frame++) {
+        scheduler.waitForNextFrame();
+    }
+
+    // Turbo mode runs ten seconds of frames without sleeping for any of them
+    EXPECT_NEAR(10.0, secondsBetween(virtualStart, clock.now()), 1e-6);
+    EXPECT_LT(secondsBetween(realStart, std::chrono::steady_clock::now()), 
+        1.0);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "fixtures/test_helpers.hpp"
+#include "core/input_movie.hpp"
+#include "core/interpreter.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+// Waits for a key, mixes it with a random number, stores both and waits out 
+// the delay timer, then skips on the key that was pressed
+const std::vector<uint8_t> inputProgram = {
+    0xA3, 0x00, // 0x200: LD I, 0x300
+    0xF0, 0x0A, // 0x202: LD V0, K
+    0xC1, 0xFF, // 0x204: RND V1, 0xFF
+    0x81, 0x04, // 0x206: ADD V1, V0
+    0xF1, 0x55, // 0x208: LD [I], V1
+    0x61, 0x05, // 0x20A: LD V1, 0x05
+    0xF1, 0x15, // 0x20C: LD DT, V1
+    0xF1, 0x07, // 0x20E: LD V1, DT
+    0x31, 0x00, // 0x210: SE V1, 0x00
+    0x12, 0x0E, // 0x212: JP 0x20E
+    0xE0, 0x9E, // 0x214: SKP V0
+    0x12, 0x02, // 0x216: JP 0x202
+    0x7F, 0x01, // 0x218: ADD VF, 0x01
+    0x12, 0x02  // 0x21A: JP 0x202
+};
+
+// Records 120 frames, pressing and releasing keys every few frames
+InputMovie recordMovie(Interpreter& interpreter) {
+    MovieRecorder recorder{interpreter, 42, 10};
+    EXPECT_FALSE(recorder.start(inputProgram.data(), 
+        inputProgram.size()).has_value());
+    for (int frame = 0; frame < 120; frame++) {
+        if (frame % 7 == 3) {
+            recorder.setKey(frame % 16, true);
+        } else if (frame % 7 == 5) {
+            recorder.setKey((frame - 2) % 16, false);
+        }
+        recorder.runFrame();
+    }
+    return recorder.finish();
+}
+
+}
+
+TEST(InputMovieTest, Replay_RecordedMovie_ReproducesFinalState) {
+    Interpreter recorded{};
+    const InputMovie movie = recordMovie(recorded);
+    EXPECT_EQ(120u, movie.frameCount);
+    EXPECT_EQ(34u, movie.events.size());
+
+    Interpreter replayed{};
+    replayed.seedRandom(7);
+    replayed.setKey(0x3, true);
+    MoviePlayer player{replayed, movie};
+    ASSERT_FALSE(player.start(inputProgram.data(), 
+        inputProgram.size()).has_value());
+    while (!player.isFinished()) {
+        player.runFrame();
+    }
+
+    EXPECT_FALSE(player.isDesynchronized());
+    EXPECT_TRUE(player.matchesRecording());
+    EXPECT_EQ(saveState(recorded), saveState(replayed));
+}
+
+TEST(InputMovieTest, Replay_AlteredEvent_IsDetected) {
+    Interpreter recorded{};
+    InputMovie movie = recordMovie(recorded);
+    movie.events[4].key ^= 0x1;
+
+    Interpreter replayed{};
+    MoviePlayer player{replayed, movie};
+    ASSERT_FALSE(player.start(inputProgram.data(), 
+        inputProgram.size()).has_value());
+    while (!player.isFinished()) {
+        player.runFrame();
+    }
+
+    EXPECT_FALSE(player.matchesRecording());
+}
+
+TEST(InputMovieTest, DecodeMovie_EncodedMovie_RoundTrips) {
+    Interpreter interpreter{};
+    const InputMovie movie = recordMovie(interpreter);
+    const std::vector<uint8_t> bytes = encodeMovie(movie);
+
+    InputMovie decoded{};
+    ASSERT_FALSE(decodeMovie(bytes.data(), bytes.size(), 
+        decoded).has_value());
+    EXPECT_EQ(movie.romHash, decoded.romHash);
+    EXPECT_EQ(movie.seed, decoded.seed);
+    EXPECT_EQ(movie.instructionsPerFrame, decoded.instructionsPerFrame);
+    EXPECT_EQ(movie.frameCount, decoded.frameCount);
+    EXPECT_EQ(movie.finalStateHash, decoded.finalStateHash);
+    ASSERT_EQ(movie.events.size(), decoded.events.size());
+    for (size_t index = 0; index < movie.events.size(); index++) {
+        SCOPED_TRACE(index);
+        EXPECT_EQ(movie.events[index].frame, decoded.events[index].frame);
+        EXPECT_EQ(movie.events[index].instructionCount, 
+            decoded.events[index].instructionCount);
+        EXPECT_EQ(movie.events[index].key, decoded.events[index].key);
+        EXPECT_EQ(movie.events[index].isPressed, 
+            decoded.events[index].isPressed);
+    }
+}
+
+TEST(InputMovieTest, DecodeMovie_InvalidData_ReturnsError) {
+    Interpreter interpreter{};
+    const InputMovie movie = recordMovie(interpreter);
+    std::vector<uint8_t> bytes = encodeMovie(movie);
+
+    InputMovie decoded{};
+    EXPECT_TRUE(decodeMovie(bytes.data(), bytes.size() - 1, 
+        decoded).has_value());
+    bytes.push_back(0);
+    EXPECT_TRUE(decodeMovie(bytes.data(), bytes.size(), 
+        decoded).has_value());
+    bytes.pop_back();
+    bytes[0] = 'X';
+    EXPECT_TRUE(decodeMovie(bytes.data(), bytes.size(), 
+        decoded).has_value());
+    EXPECT_EQ(0u, decoded.frameCount);
+}
+
+TEST(InputMovieTest, Start_DifferentRom_ReturnsError) {
+    Interpreter interpreter{};
+    const InputMovie movie = recordMovie(interpreter);
+    std::vector<uint8_t> rom = inputProgram;
+    rom.back() ^= 0x1;
+
+    MoviePlayer player{interpreter, movie};
+    EXPECT_TRUE(player.start(rom.data(), rom.size()).has_value());
+}
\ No newline at end of file
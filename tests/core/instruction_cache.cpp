@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "core/instruction_cache.hpp"
+#include "core/opcode.hpp"
+#include "core/types.hpp"
+
+using namespace OCTACHIP;
+
+TEST(InstructionCacheTest, Decode_ResolvesNestedOpcodeGroups) {
+    EXPECT_EQ(Operation::CLS, decode(0x00E0));
+    EXPECT_EQ(Operation::SHL_VX_VY, decode(0x812E));
+    EXPECT_EQ(Operation::SKNP_VX, decode(0xE3A1));
+    EXPECT_EQ(Operation::LD_I_VX, decode(0xF455));
+
+    // Unassigned encodings within a group should resolve to an illegal opcode
+    EXPECT_EQ(Operation::ILLEGAL_OPCODE, decode(0x0123));
+    EXPECT_EQ(Operation::ILLEGAL_OPCODE, decode(0x8128));
+    EXPECT_EQ(Operation::ILLEGAL_OPCODE, decode(0xF0FF));
+}
+
+TEST(InstructionCacheTest, Fetch_ExtractsOperands) {
+    InstructionCache cache{};
+    Memory memory{};
+    memory[0x200] = 0xD1;
+    memory[0x201] = 0x2A;
+
+    const DecodedInstruction& instruction = cache.fetch(memory, 0x200);
+
+    // Fetch should decode the instruction and extract its operands
+    EXPECT_EQ(Operation::DRW_VX_VY_NIBBLE, instruction.operation);
+    EXPECT_EQ(0x1, instruction.opcode.x());
+    EXPECT_EQ(0x2, instruction.opcode.y());
+    EXPECT_EQ(0xA, instruction.opcode.nibble());
+    EXPECT_EQ(0x2A, instruction.opcode.byte());
+    EXPECT_EQ(0x12A, instruction.opcode.address());
+}
+
+TEST(InstructionCacheTest, Fetch_UnwrittenMemory_ReturnsCachedInstruction) {
+    InstructionCache cache{};
+    Memory memory{};
+    memory[0x200] = 0x62;
+    memory[0x201] = 0x05;
+
+    cache.fetch(memory, 0x200);
+    memory[0x201] = 0x07;
+
+    // Without an invalidation, fetch should keep returning the predecoded 
+    // instruction
+    EXPECT_EQ(0x6205, cache.fetch(memory, 0x200).opcode.full());
+}
+
+TEST(InstructionCacheTest, Invalidate_OverlappingWrite_RedecodesInstruction) {
+    InstructionCache cache{};
+    Memory memory{};
+    memory[0x200] = 0x62;
+    memory[0x201] = 0x05;
+    memory[0x202] = 0x00;
+    memory[0x203] = 0xE0;
+
+    cache.fetch(memory, 0x200);
+    cache.fetch(memory, 0x202);
+
+    // Overwrite only the second byte of the first instruction
+    memory[0x201] = 0x07;
+    cache.invalidate(0x201, 1);
+
+    // The instruction whose second byte was written should be decoded again, 
+    // and instructions outside the written range should be kept
+    EXPECT_EQ(0x6207, cache.fetch(memory, 0x200).opcode.full());
+    EXPECT_EQ(Operation::CLS, cache.fetch(memory, 0x202).operation);
+}
+
+TEST(InstructionCacheTest, Clear_RedecodesAllInstructions) {
+    InstructionCache cache{};
+    Memory memory{};
+    memory[0x300] = 0x00;
+    memory[0x301] = 0xEE;
+
+    cache.fetch(memory, 0x300);
+    memory[0x301] = 0xE0;
+    cache.clear();
+
+    // Clear should discard every predecoded instruction
+    EXPECT_EQ(Operation::CLS, cache.fetch(memory, 0x300).operation);
+}
+TEST(InstructionCacheTest, Fetch_PastEndOfMemory_ReturnsOutOfBounds) {
+    InstructionCache cache{};
+    Memory memory{};
+
+    // Instructions that would be fetched from outside memory, including the 
+    // last byte of memory, should resolve to an out-of-bounds entry
+    EXPECT_EQ(Operation::PC_OUT_OF_BOUNDS, 
+        cache.fetch(memory, MEMORY_SIZE - 1).operation);
+    EXPECT_EQ(Operation::PC_OUT_OF_BOUNDS, 
+        cache.fetch(memory, 0xFFF + 0xFF).operation);
+
+    // Invalidating the end of memory should keep the out-of-bounds entries
+    cache.invalidate(MEMORY_SIZE - 4, 4);
+    EXPECT_EQ(Operation::PC_OUT_OF_BOUNDS, 
+        cache.fetch(memory, MEMORY_SIZE - 1).operation);
+}
\ No newline at end of file
@@ -0,0 +1,503 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/fault.hpp"
+#include "core/interpreter.hpp"
+#include "core/types.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+void loadProgram(Interpreter& interpreter, 
+    const std::vector<uint8_t>& program) {
+    const std::filesystem::path romPath = 
+        std::filesystem::temp_directory_path() / "octachip_test.ch8";
+    {
+        std::ofstream romFile{romPath, std::ios_base::binary};
+        romFile.write(reinterpret_cast<const char*>(program.data()), 
+            program.size());
+    }
+    EXPECT_FALSE(interpreter.loadRom(romPath).has_value());
+    std::filesystem::remove(romPath);
+}
+
+// Counts V0 up to 0x20, storing each value over the operand of the LD V1 
+// instruction that follows
+const std::vector<uint8_t> selfModifyingProgram = {
+    0xA2, 0x07, // 0x200: LD I, 0x207
+    0x70, 0x01, // 0x202: ADD V0, 0x01
+    0xF0, 0x55, // 0x204: LD [I], V0
+    0x61, 0x00, // 0x206: LD V1, 0x00 (operand rewritten by LD [I], V0)
+    0x30, 0x20, // 0x208: SE V0, 0x20
+    0x12, 0x02, // 0x20A: JP 0x202
+    0x12, 0x0C  // 0x20C: JP 0x20C
+};
+
+// Builds a program of random instructions, weighted towards the arithmetic, 
+// skips and jumps that blocks are made of. Jumps, calls and I stay inside 
+// the program, so stores overwrite its code.
+std::vector<uint8_t> makeRandomProgram(const uint32_t seed) {
+    constexpr int INSTRUCTION_COUNT = 64;
+    std::mt19937 generator{seed};
+    const auto random = [&](const int bound) {
+        return static_cast<int>(generator() % static_cast<uint32_t>(bound));
+    };
+
+    std::vector<uint8_t> program;
+    for (int i = 0; i < INSTRUCTION_COUNT; i++) {
+        const int x = random(16) << 8;
+        const int y = random(16) << 4;
+        // Small values make skips and carries likely
+        const int byte = random(4) == 0 ? random(256) : random(4);
+        const int address = 0x200 + 2 * random(INSTRUCTION_COUNT);
+        const int stores[] = {0xF033, 0xF055, 0xF065};
+        const int timers[] = {0xF007, 0xF015, 0xF018};
+
+        int opcode = 0;
+        switch (random(16)) {
+            case 0: opcode = 0x6000 | x | byte; break;
+            case 1: opcode = 0x7000 | x | byte; break;
+            case 2: opcode = 0x8000 | x | y | random(8); break;
+            case 3: opcode = 0x800E | x | y; break;
+            case 4: opcode = 0x3000 | x | byte; break;
+            case 5: opcode = 0x4000 | x | byte; break;
+            case 6: opcode = 0x5000 | x | y; break;
+            case 7: opcode = 0x9000 | x | y; break;
+            case 8: opcode = 0x1000 | address; break;
+            case 9: opcode = 0xA000 | address; break;
+            case 10: opcode = 0xF01E | x; break;
+            case 11: opcode = 0xF029 | x; break;
+            case 12: opcode = timers[random(3)] | x; break;
+            case 13: opcode = stores[random(3)] | x; break;
+            case 14: opcode = random(2) == 0 ? 0x2000 | address : 0x00EE; break;
+            default: opcode = 0xC000 | x | byte; break;
+        }
+        program.push_back(static_cast<uint8_t>(opcode >> 8));
+        program.push_back(static_cast<uint8_t>(opcode));
+    }
+    return program;
+}
+
+}
+
+TEST(InterpreterTest, Run_MatchesTick) {
+    Interpreter ticked{};
+    Interpreter threaded{};
+    loadProgram(ticked, selfModifyingProgram);
+    loadProgram(threaded, selfModifyingProgram);
+
+    for (int i = 0; i < 150; i++) {
+        ticked.tick();
+    }
+    threaded.run(150);
+
+    // Running a batch of instructions should leave the interpreter in the same 
+    // state as ticking the same number of times
+    EXPECT_EQ(ticked.getProgramCounterValue(), 
+        threaded.getProgramCounterValue());
+    EXPECT_EQ(ticked.getIndexRegisterValue(), 
+        threaded.getIndexRegisterValue());
+    for (int i = 0; i < Registers::V_REG_COUNT; i++) {
+        EXPECT_EQ(ticked.getRegisterValue(i), threaded.getRegisterValue(i));
+    }
+}
+
+TEST(InterpreterTest, Run_SelfModifyingCode_ExecutesRewrittenInstruction) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+
+    interpreter.run(1000);
+
+    // LD V1 should load the value most recently stored over its operand 
+    // rather than a stale predecoded value
+    EXPECT_EQ(0x20, interpreter.getRegisterValue(0x0));
+    EXPECT_EQ(0x20, interpreter.getRegisterValue(0x1));
+    EXPECT_EQ(0x20C, interpreter.getProgramCounterValue());
+}
+
+TEST(InterpreterTest, Run_DelayTimerIdleLoop_SkipsToEndOfBudget) {
+    const std::vector<uint8_t> program = {
+        0x60, 0x02, // 0x200: LD V0, 0x02
+        0xF0, 0x15, // 0x202: LD DT, V0
+        0xF1, 0x07, // 0x204: LD V1, DT
+        0x31, 0x00, // 0x206: SE V1, 0x00
+        0x12, 0x04, // 0x208: JP 0x204
+        0x12, 0x0A  // 0x20A: JP 0x20A
+    };
+    Interpreter ticked{};
+    Interpreter skipped{};
+    loadProgram(ticked, program);
+    loadProgram(skipped, program);
+
+    for (int frame = 0; frame < 4; frame++) {
+        for (int i = 0; i < 500; i++) {
+            ticked.tick();
+        }
+        skipped.run(500);
+
+        // Skipping the idle loop should leave the interpreter in the same 
+        // state as spinning through it
+        EXPECT_EQ(ticked.getProgramCounterValue(), 
+            skipped.getProgramCounterValue());
+        EXPECT_EQ(ticked.getRegisterValue(0x1), skipped.getRegisterValue(0x1));
+
+        ticked.updateTimers();
+        skipped.updateTimers();
+    }
+
+    EXPECT_EQ(0x20A, skipped.getProgramCounterValue());
+    EXPECT_GT(skipped.getSkippedInstructionCount(), 1900u);
+}
+
+TEST(InterpreterTest, Run_RandomPrograms_MatchesTick) {
+    for (int quirks = 0; quirks < 8; quirks++) {
+        for (uint32_t seed = 0; seed < 64; seed++) {
+            SCOPED_TRACE("quirks " + std::to_string(quirks) + ", seed " + 
+                std::to_string(seed));
+            const std::vector<uint8_t> program = makeRandomProgram(seed);
+            Interpreter ticked{};
+            Interpreter run{};
+            for (Interpreter* interpreter : {&ticked, &run}) {
+                ASSERT_FALSE(interpreter->loadRom(program.data(), 
+                    program.size()).has_value());
+                interpreter->setLoadStoreQuirk((quirks & 0x4) != 0);
+                interpreter->setShiftQuirk((quirks & 0x2) != 0);
+                interpreter->setWrapQuirk((quirks & 0x1) != 0);
+                interpreter->seedRandom(seed);
+            }
+
+            std::mt19937 generator{seed};
+            for (int frame = 0; frame < 20; frame++) {
+                const int instructionCount = 1 + 
+                    static_cast<int>(generator() % 200);
+                for (int i = 0; i < instructionCount; i++) {
+                    ticked.tick();
+                }
+                run.run(instructionCount);
+                ticked.updateTimers();
+                run.updateTimers();
+
+                // The state hash covers memory, registers, stack, timers and 
+                // frame
+                ASSERT_EQ(ticked.getStateHash(), run.getStateHash());
+                ASSERT_EQ(ticked.getFault().kind, run.getFault().kind);
+                ASSERT_EQ(ticked.getExecutedInstructionCount(), 
+                    run.getExecutedInstructionCount());
+            }
+        }
+    }
+}
+
+TEST(InterpreterTest, Run_WaitForKey_HaltsUntilKeyIsReleased) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, {
+        0xF3, 0x0A, // 0x200: LD V3, K
+        0x60, 0x01, // 0x202: LD V0, 0x01
+        0x12, 0x04  // 0x204: JP 0x204
+    });
+
+    interpreter.run(100);
+
+    // No key has been pressed, so the interpreter should halt on LD V3, K
+    EXPECT_TRUE(interpreter.isWaitingForKey());
+    EXPECT_EQ(0x200, interpreter.getProgramCounterValue());
+
+    // Pressing a key is not enough, it also has to be released
+    interpreter.setKey(0x5, true);
+    interpreter.run(100);
+    EXPECT_TRUE(interpreter.isWaitingForKey());
+    EXPECT_EQ(0x200, interpreter.getProgramCounterValue());
+
+    interpreter.setKey(0x5, false);
+    interpreter.run(2);
+    EXPECT_FALSE(interpreter.isWaitingForKey());
+    EXPECT_EQ(0x05, interpreter.getRegisterValue(0x3));
+    EXPECT_EQ(0x01, interpreter.getRegisterValue(0x0));
+}
+
+TEST(InterpreterTest, TakeDirtyRows_ReturnsRowsChangedSinceLastCall) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, {
+        0x63, 0x04, // 0x200: LD V3, 0x04
+        0xF3, 0x29, // 0x202: LD F, V3
+        0xD0, 0x35, // 0x204: DRW V0, V3, 5
+        0x12, 0x06  // 0x206: JP 0x206
+    });
+
+    // A new interpreter has never been presented, so every row starts dirty
+    EXPECT_EQ(ALL_FRAME_ROWS, interpreter.takeDirtyRows());
+    EXPECT_EQ(0u, interpreter.takeDirtyRows());
+
+    const uint64_t generation = interpreter.getFrameGeneration();
+    interpreter.run(100);
+
+    // The 5 rows of the font sprite were drawn starting at row 4
+    EXPECT_EQ(0b11111u << 4, interpreter.takeDirtyRows());
+    EXPECT_EQ(generation + 1, interpreter.getFrameGeneration());
+
+    interpreter.run(100);
+    EXPECT_EQ(0u, interpreter.takeDirtyRows());
+    EXPECT_EQ(generation + 1, interpreter.getFrameGeneration());
+}
+
+TEST(InterpreterTest, Tick_ProgramCounterPastEndOfMemory_ReportsFault) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, {
+        0x6F, 0xFF, // 0x200: LD VF, 0xFF
+        0x80, 0xF0, // 0x202: LD V0, VF
+        0xBF, 0xFF  // 0x204: JP V0, 0xFFF
+    });
+
+    interpreter.run(3);
+    const Fault& fault = interpreter.tick();
+
+    // The jump lands past the end of memory, so the next fetch should fault
+    EXPECT_EQ(FaultKind::PC_OUT_OF_BOUNDS, fault.kind);
+    EXPECT_EQ(0x10FE, fault.pc);
+    EXPECT_EQ(0x10FE, interpreter.getProgramCounterValue());
+}
+
+TEST(InterpreterTest, Run_IllegalOpcode_HaltsOnFaultingInstruction) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, {
+        0x60, 0x01, // 0x200: LD V0, 0x01
+        0x01, 0x23, // 0x202: Illegal opcode
+        0x60, 0x02  // 0x204: LD V0, 0x02
+    });
+
+    const Fault& fault = interpreter.run(10);
+
+    // Execution should stop on the illegal opcode and report where it is
+    EXPECT_EQ(FaultKind::ILLEGAL_OPCODE, fault.kind);
+    EXPECT_EQ(0x202, fault.pc);
+    EXPECT_EQ(0x0123, fault.opcode);
+
+    // The interpreter should stay halted until it is reset
+    EXPECT_EQ(FaultKind::ILLEGAL_OPCODE, interpreter.tick().kind);
+    EXPECT_EQ(0x01, interpreter.getRegisterValue(0x0));
+    EXPECT_EQ(0x202, interpreter.getProgramCounterValue());
+}
+
+TEST(InterpreterTest, LoadRom_MissingFile_ReturnsError) {
+    Interpreter interpreter{};
+
+    // Loading should report the error instead of throwing
+    EXPECT_TRUE(interpreter.loadRom(
+        std::filesystem::temp_directory_path() / "octachip_missing.ch8"));
+}
+
+TEST(InterpreterTest, SetShiftQuirk_AfterLoadingRom_ChangesShiftBehavior) {
+    const std::vector<uint8_t> program = {
+        0x60, 0x08, // 0x200: LD V0, 0x08
+        0x61, 0x02, // 0x202: LD V1, 0x02
+        0x80, 0x16, // 0x204: SHR V0, V1
+        0x12, 0x06  // 0x206: JP 0x206
+    };
+    Interpreter quirky{};
+    Interpreter original{};
+    loadProgram(quirky, program);
+    loadProgram(original, program);
+
+    // Quirk settings take effect even when changed after the ROM is loaded
+    original.setShiftQuirk(false);
+    quirky.run(4);
+    original.run(4);
+
+    EXPECT_EQ(0x04, quirky.getRegisterValue(0x0));
+    EXPECT_EQ(0x01, original.getRegisterValue(0x0));
+}
+
+TEST(InterpreterTest, SeedRandom_SameSeed_RepeatsRandomValues) {
+    const std::vector<uint8_t> program = {
+        0xC0, 0xFF, // 0x200: RND V0, 0xFF
+        0xC1, 0xFF, // 0x202: RND V1, 0xFF
+        0xC2, 0xFF, // 0x204: RND V2, 0xFF
+        0xC3, 0xFF, // 0x206: RND V3, 0xFF
+        0x12, 0x08  // 0x208: JP 0x208
+    };
+    Interpreter first{};
+    Interpreter second{};
+    Interpreter other{};
+    loadProgram(first, program);
+    loadProgram(second, program);
+    loadProgram(other, program);
+    first.seedRandom(7);
+    second.seedRandom(7);
+    other.seedRandom(8);
+    first.run(4);
+    second.run(4);
+    other.run(4);
+
+    bool differs = false;
+    for (int index = 0x0; index <= 0x3; index++) {
+        EXPECT_EQ(first.getRegisterValue(index), 
+            second.getRegisterValue(index));
+        differs |= first.getRegisterValue(index) != 
+            other.getRegisterValue(index);
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(InterpreterTest, LoadState_RestoresSavedState) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+    interpreter.setShiftQuirk(false);
+    interpreter.seedRandom(3);
+    interpreter.run(20);
+
+    std::vector<uint8_t> state(Interpreter::STATE_SIZE);
+    ASSERT_EQ(Interpreter::STATE_SIZE, 
+        interpreter.saveState(state.data(), state.size()));
+
+    // Restoring into another interpreter should resume from the same point, 
+    // including the code rewritten since the ROM was loaded
+    Interpreter restored{};
+    ASSERT_TRUE(restored.loadState(state.data(), state.size()));
+    Interpreter& expected = interpreter;
+    expected.run(40);
+    restored.run(40);
+
+    for (int index = 0; index < Registers::V_REG_COUNT; index++) {
+        EXPECT_EQ(expected.getRegisterValue(index), 
+            restored.getRegisterValue(index));
+    }
+    EXPECT_EQ(expected.getProgramCounterValue(), 
+        restored.getProgramCounterValue());
+    EXPECT_EQ(expected.getExecutedInstructionCount(), 
+        restored.getExecutedInstructionCount());
+
+    std::vector<uint8_t> expectedState(Interpreter::STATE_SIZE);
+    std::vector<uint8_t> restoredState(Interpreter::STATE_SIZE);
+    expected.saveState(expectedState.data(), expectedState.size());
+    restored.saveState(restoredState.data(), restoredState.size());
+    EXPECT_EQ(expectedState, restoredState);
+}
+
+TEST(InterpreterTest, LoadState_InvalidState_LeavesStateUnchanged) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+    std::vector<uint8_t> state(Interpreter::STATE_SIZE);
+    interpreter.saveState(state.data(), state.size());
+    interpreter.run(10);
+    std::vector<uint8_t> current(Interpreter::STATE_SIZE);
+    interpreter.saveState(current.data(), current.size());
+
+    EXPECT_EQ(0u, interpreter.saveState(state.data(), state.size() - 1));
+    EXPECT_FALSE(interpreter.loadState(state.data(), state.size() - 1));
+
+    std::vector<uint8_t> wrongVersion = state;
+    wrongVersion[4]++;
+    EXPECT_FALSE(interpreter.loadState(wrongVersion.data(), 
+        wrongVersion.size()));
+
+    // The program counter follows the magic, version, memory and V registers, 
+    // and the stack follows it, I, SP and the timers
+    const size_t pcOffset = 4 + 2 + MEMORY_SIZE + Registers::V_REG_COUNT;
+    const size_t stackOffset = pcOffset + 7;
+    std::vector<uint8_t> pcOutside = state;
+    pcOutside[pcOffset] = 0x00;
+    pcOutside[pcOffset + 1] = 0x11;
+    EXPECT_FALSE(interpreter.loadState(pcOutside.data(), pcOutside.size()));
+    std::vector<uint8_t> stackOutside = state;
+    stackOutside[stackOffset + 2 * 5 + 1] = 0xFF;
+    EXPECT_FALSE(interpreter.loadState(stackOutside.data(), 
+        stackOutside.size()));
+
+    std::vector<uint8_t> unchanged(Interpreter::STATE_SIZE);
+    interpreter.saveState(unchanged.data(), unchanged.size());
+    EXPECT_EQ(current, unchanged);
+}
+
+TEST(InterpreterTest, Restore_Fork_ResumesFromForkedState) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+    interpreter.seedRandom(5);
+    // Stops between rewriting the operand of LD V1 and executing it
+    interpreter.run(18);
+    ASSERT_EQ(0x206, interpreter.getProgramCounterValue());
+
+    const Interpreter::Fork fork = interpreter.fork();
+    std::vector<uint8_t> forkedState(Interpreter::STATE_SIZE);
+    interpreter.saveState(forkedState.data(), forkedState.size());
+    interpreter.run(43);
+    std::vector<uint8_t> expectedState(Interpreter::STATE_SIZE);
+    interpreter.saveState(expectedState.data(), expectedState.size());
+
+    // The LD V1 decoded after the fork has a different operand, which has to 
+    // be decoded again from the restored memory
+    interpreter.restore(fork);
+    std::vector<uint8_t> restoredState(Interpreter::STATE_SIZE);
+    interpreter.saveState(restoredState.data(), restoredState.size());
+    EXPECT_EQ(forkedState, restoredState);
+    interpreter.run(3);
+    EXPECT_EQ(interpreter.getMemoryValue(0x207), 
+        interpreter.getRegisterValue(1));
+    interpreter.run(40);
+    interpreter.saveState(restoredState.data(), restoredState.size());
+    EXPECT_EQ(expectedState, restoredState);
+
+    // Forks can also be restored into other interpreters
+    Interpreter other{};
+    loadProgram(other, selfModifyingProgram);
+    other.run(100);
+    other.restore(fork);
+    other.run(43);
+    other.saveState(restoredState.data(), restoredState.size());
+    EXPECT_EQ(expectedState, restoredState);
+}
+
+TEST(InterpreterTest, Restore_EarlierFork_IgnoresLaterStores) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+    interpreter.run(7);
+    const Interpreter::Fork first = interpreter.fork();
+    const uint8_t firstOperand = interpreter.getMemoryValue(0x207);
+    interpreter.run(10);
+    const Interpreter::Fork second = interpreter.fork();
+    const uint8_t secondOperand = interpreter.getMemoryValue(0x207);
+    ASSERT_NE(firstOperand, secondOperand);
+
+    interpreter.restore(first);
+    EXPECT_EQ(firstOperand, interpreter.getMemoryValue(0x207));
+    interpreter.restore(second);
+    EXPECT_EQ(secondOperand, interpreter.getMemoryValue(0x207));
+    interpreter.restore(first);
+    EXPECT_EQ(firstOperand, interpreter.getMemoryValue(0x207));
+    EXPECT_EQ(7u, interpreter.getExecutedInstructionCount());
+}
+
+TEST(InterpreterTest, GetStateHash_AfterStores_MatchesRecomputedHash) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+    const uint64_t initialHash = interpreter.getStateHash();
+    interpreter.run(50);
+    EXPECT_NE(initialHash, interpreter.getStateHash());
+
+    // Loading a state hashes its memory from scratch, which should agree with 
+    // the hash updated by each store
+    std::vector<uint8_t> state(Interpreter::STATE_SIZE);
+    interpreter.saveState(state.data(), state.size());
+    Interpreter loaded{};
+    ASSERT_TRUE(loaded.loadState(state.data(), state.size()));
+    EXPECT_EQ(interpreter.getStateHash(), loaded.getStateHash());
+}
+
+TEST(InterpreterTest, GetStateHash_RestoredFork_MatchesForkedHash) {
+    Interpreter interpreter{};
+    loadProgram(interpreter, selfModifyingProgram);
+    interpreter.run(18);
+    const Interpreter::Fork fork = interpreter.fork();
+    const uint64_t forkedHash = interpreter.getStateHash();
+
+    interpreter.run(1);
+    EXPECT_NE(forkedHash, interpreter.getStateHash());
+    interpreter.run(40);
+    interpreter.restore(fork);
+    EXPECT_EQ(forkedHash, interpreter.getStateHash());
+}
\ No newline at end of file
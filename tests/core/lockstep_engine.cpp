@@ -0,0 +1,241 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "core/fault.hpp"
+#include "core/interpreter.hpp"
+#include "core/lockstep_engine.hpp"
+#include "core/types.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+// Takes a different path depending on whether key 0 is pressed, then runs 
+// through calls, arithmetic with flags, memory accesses and drawing
+const std::vector<uint8_t> branchingProgram = {
+    0x6A, 0x85, // 0x200: LD VA, 0x85
+    0xE0, 0x9E, // 0x202: SKP V0
+    0x12, 0x0A, // 0x204: JP 0x20A
+    0x7A, 0x40, // 0x206: ADD VA, 0x40
+    0x8A, 0xA4, // 0x208: ADD VA, VA
+    0x22, 0x22, // 0x20A: CALL 0x222
+    0xA3, 0x00, // 0x20C: LD I, 0x300
+    0xFA, 0x33, // 0x20E: LD B, VA
+    0xF2, 0x65, // 0x210: LD V2, [I]
+    0x8B, 0xA5, // 0x212: SUB VB, VA
+    0x8C, 0xA6, // 0x214: SHR VC, VA
+    0x8D, 0xAE, // 0x216: SHL VD, VA
+    0x8E, 0xA7, // 0x218: SUBN VE, VA
+    0xFA, 0x29, // 0x21A: LD F, VA
+    0xD0, 0x15, // 0x21C: DRW V0, V1, 5
+    0x8F, 0xA4, // 0x21E: ADD VF, VA
+    0x12, 0x20, // 0x220: JP 0x220
+    0xFA, 0x15, // 0x222: LD DT, VA
+    0xF5, 0x07, // 0x224: LD V5, DT
+    0x00, 0xEE  // 0x226: RET
+};
+
+void expectLaneMatches(const LockstepEngine& engine, const int lane, 
+    const Interpreter& interpreter) {
+    for (int index = 0; index < Registers::V_REG_COUNT; index++) {
+        EXPECT_EQ(interpreter.getRegisterValue(index), 
+            engine.getRegisterValue(lane, index));
+    }
+    for (int index = 0; index < STACK_SIZE; index++) {
+        EXPECT_EQ(interpreter.getStackValue(index), 
+            engine.getStackValue(lane, index));
+    }
+    EXPECT_EQ(interpreter.getProgramCounterValue(), 
+        engine.getProgramCounterValue(lane));
+    EXPECT_EQ(interpreter.getIndexRegisterValue(), 
+        engine.getIndexRegisterValue(lane));
+    EXPECT_EQ(interpreter.getStackPointerValue(), 
+        engine.getStackPointerValue(lane));
+    EXPECT_EQ(interpreter.getDelayTimerValue(), 
+        engine.getDelayTimerValue(lane));
+    EXPECT_EQ(interpreter.getFrame(), engine.getFrame(lane));
+    EXPECT_EQ(interpreter.getFault().kind, engine.getFault(lane).kind);
+    EXPECT_EQ(interpreter.getExecutedInstructionCount(), 
+        engine.getExecutedInstructionCount(lane));
+}
+
+}
+
+TEST(LockstepEngineTest, Tick_DivergingLanes_MatchInterpreter) {
+    constexpr int LANE_COUNT = 40;
+
+    for (const bool shiftQuirk : {false, true}) {
+        LockstepEngine engine{LANE_COUNT};
+        engine.setShiftQuirk(shiftQuirk);
+        ASSERT_FALSE(engine.loadRom(branchingProgram.data(), 
+            branchingProgram.size()).has_value());
+
+        std::vector<Interpreter> interpreters(LANE_COUNT);
+        for (int lane = 0; lane < LANE_COUNT; lane++) {
+            Interpreter& interpreter = interpreters[lane];
+            interpreter.setShiftQuirk(shiftQuirk);
+            ASSERT_FALSE(interpreter.loadRom(branchingProgram.data(), 
+                branchingProgram.size()).has_value());
+            if (lane % 3 == 0) {
+                engine.setKey(lane, 0, true);
+                interpreter.setKey(0, true);
+            }
+        }
+
+        for (int step = 0; step < 24; step++) {
+            engine.tick();
+            for (Interpreter& interpreter : interpreters) {
+                interpreter.tick();
+            }
+        }
+
+        for (int lane = 0; lane < LANE_COUNT; lane++) {
+            SCOPED_TRACE(lane);
+            expectLaneMatches(engine, lane, interpreters[lane]);
+        }
+    }
+}
+
+TEST(LockstepEngineTest, Tick_ConvergedLanes_ExecuteAsVectorGroups) {
+    const std::vector<uint8_t> program = {
+        0x60, 0x01, // 0x200: LD V0, 0x01
+        0x70, 0x01, // 0x202: ADD V0, 0x01
+        0x12, 0x02  // 0x204: JP 0x202
+    };
+    LockstepEngine engine{64};
+    ASSERT_FALSE(engine.loadRom(program.data(), program.size()).has_value());
+
+    engine.run(11);
+
+    EXPECT_EQ(11u, engine.getVectorGroupCount());
+    EXPECT_EQ(0u, engine.getScalarLaneCount());
+    for (int lane = 0; lane < engine.getLaneCount(); lane++) {
+        EXPECT_EQ(0x06, engine.getRegisterValue(lane, 0x0));
+        EXPECT_EQ(11u, engine.getExecutedInstructionCount(lane));
+    }
+}
+
+TEST(LockstepEngineTest, Tick_FaultingLane_OtherLanesKeepRunning) {
+    const std::vector<uint8_t> program = {
+        0xE0, 0x9E, // 0x200: SKP V0
+        0x00, 0xEE, // 0x202: RET (stack underflow)
+        0x70, 0x01, // 0x204: ADD V0, 0x01
+        0x12, 0x04  // 0x206: JP 0x204
+    };
+    LockstepEngine engine{2};
+    ASSERT_FALSE(engine.loadRom(program.data(), program.size()).has_value());
+    engine.setKey(1, 0, true);
+
+    engine.run(6);
+
+    EXPECT_EQ(FaultKind::STACK_UNDERFLOW, engine.getFault(0).kind);
+    EXPECT_EQ(0x202, engine.getFault(0).pc);
+    EXPECT_EQ(0x202, engine.getProgramCounterValue(0));
+    EXPECT_EQ(1u, engine.getExecutedInstructionCount(0));
+    EXPECT_EQ(FaultKind::NONE, engine.getFault(1).kind);
+    EXPECT_EQ(0x03, engine.getRegisterValue(1, 0x0));
+}
+
+TEST(LockstepEngineTest, Tick_WaitForKey_OnlyWaitingLaneHalts) {
+    const std::vector<uint8_t> program = {
+        0xE0, 0xA1, // 0x200: SKNP V0
+        0xF3, 0x0A, // 0x202: LD V3, K
+        0x12, 0x04  // 0x204: JP 0x204
+    };
+    LockstepEngine engine{2};
+    ASSERT_FALSE(engine.loadRom(program.data(), program.size()).has_value());
+    engine.setKey(0, 0, true);
+
+    engine.run(3);
+    EXPECT_TRUE(engine.isWaitingForKey(0));
+    EXPECT_FALSE(engine.isWaitingForKey(1));
+    EXPECT_EQ(0x204, engine.getProgramCounterValue(1));
+
+    engine.setKey(0, 0, false);
+    engine.run(2);
+    EXPECT_FALSE(engine.isWaitingForKey(0));
+    EXPECT_EQ(0x00, engine.getRegisterValue(0, 0x3));
+    EXPECT_EQ(0x204, engine.getProgramCounterValue(0));
+}
+
+TEST(LockstepEngineTest, Tick_DivergedLaneKeyAboveF_MatchesInterpreter) {
+    const std::vector<uint8_t> program = {
+        0x60, 0x10, // 0x200: LD V0, 0x10
+        0xE2, 0x9E, // 0x202: SKP V2
+        0xE0, 0x9E, // 0x204: SKP V0
+        0x61, 0x01, // 0x206: LD V1, 0x01
+        0x12, 0x08  // 0x208: JP 0x208
+    };
+    LockstepEngine engine{2};
+    ASSERT_FALSE(engine.loadRom(program.data(), program.size()).has_value());
+    engine.setKey(1, 0, true);
+    Interpreter interpreter{};
+    ASSERT_FALSE(interpreter.loadRom(program.data(), 
+        program.size()).has_value());
+
+    engine.run(5);
+    for (int i = 0; i < 5; i++) {
+        interpreter.tick();
+    }
+
+    // Lane 0 runs SKP V0 on its own once lane 1 skips, and key 0x10 is not a 
+    // key, so it should not be pressed, even though the next lane's key 0 is
+    expectLaneMatches(engine, 0, interpreter);
+    EXPECT_EQ(0x01, engine.getRegisterValue(0, 0x1));
+}
+
+TEST(LockstepEngineTest, UpdateTimers_DecrementsEveryLaneToZero) {
+    const std::vector<uint8_t> program = {
+        0x60, 0x02, // 0x200: LD V0, 0x02
+        0xF0, 0x15, // 0x202: LD DT, V0
+        0xF0, 0x18, // 0x204: LD ST, V0
+        0x12, 0x06  // 0x206: JP 0x206
+    };
+    LockstepEngine engine{33};
+    ASSERT_FALSE(engine.loadRom(program.data(), program.size()).has_value());
+    engine.run(3);
+
+    engine.updateTimers();
+    EXPECT_EQ(0x01, engine.getDelayTimerValue(32));
+    engine.updateTimers();
+    engine.updateTimers();
+    for (int lane = 0; lane < engine.getLaneCount(); lane++) {
+        EXPECT_EQ(0x00, engine.getDelayTimerValue(lane));
+        EXPECT_EQ(0x00, engine.getSoundTimerValue(lane));
+    }
+}
+
+TEST(LockstepEngineTest, SeedRandom_DivergingLanes_MatchInterpreter) {
+    // Branches on a random bit, so lanes seeded differently split up
+    const std::vector<uint8_t> program = {
+        0xC0, 0x01, // 0x200: RND V0, 0x01
+        0x30, 0x00, // 0x202: SE V0, 0x00
+        0x71, 0x05, // 0x204: ADD V1, 0x05
+        0xC2, 0xFF, // 0x206: RND V2, 0xFF
+        0x12, 0x00  // 0x208: JP 0x200
+    };
+    constexpr int LANE_COUNT = 40;
+    LockstepEngine engine{LANE_COUNT};
+    ASSERT_FALSE(engine.loadRom(program.data(), program.size()).has_value());
+
+    std::vector<Interpreter> interpreters(LANE_COUNT);
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        ASSERT_FALSE(interpreters[lane].loadRom(program.data(), 
+            program.size()).has_value());
+        engine.seedRandom(lane, lane);
+        interpreters[lane].seedRandom(lane);
+    }
+
+    for (int step = 0; step < 50; step++) {
+        engine.tick();
+        for (Interpreter& interpreter : interpreters) {
+            interpreter.tick();
+        }
+    }
+
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        SCOPED_TRACE(lane);
+        expectLaneMatches(engine, lane, interpreters[lane]);
+    }
+}
\ No newline at end of file
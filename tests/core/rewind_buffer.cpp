@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "fixtures/test_helpers.hpp"
+#include "core/interpreter.hpp"
+#include "core/rewind_buffer.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+// Counts V0 up and stores it, so every frame leaves a different state
+const std::vector<uint8_t> countingProgram = {
+    0xA3, 0x00, // 0x200: LD I, 0x300
+    0x70, 0x01, // 0x202: ADD V0, 0x01
+    0xF0, 0x55, // 0x204: LD [I], V0
+    0x12, 0x02  // 0x206: JP 0x202
+};
+
+// Runs one frame and records it, returning the recorded state
+std::vector<uint8_t> runFrame(Interpreter& interpreter, 
+    RewindBuffer& rewindBuffer) {
+    interpreter.run(7);
+    interpreter.updateTimers();
+    rewindBuffer.record(interpreter);
+    return saveState(interpreter);
+}
+
+}
+
+TEST(RewindBufferTest, Rewind_StepsBackThroughRecordedFrames) {
+    Interpreter interpreter{};
+    ASSERT_FALSE(interpreter.loadRom(countingProgram.data(), 
+        countingProgram.size()).has_value());
+    RewindBuffer rewindBuffer{1 << 16, 4};
+
+    std::vector<std::vector<uint8_t>> states;
+    for (int frame = 0; frame < 10; frame++) {
+        states.push_back(runFrame(interpreter, rewindBuffer));
+    }
+    EXPECT_EQ(10u, rewindBuffer.getFrameCount());
+
+    // Stepping back crosses keyframes, which are rebuilt from the previous 
+    // keyframe
+    for (int frame = 8; frame >= 0; frame--) {
+        SCOPED_TRACE(frame);
+        ASSERT_TRUE(rewindBuffer.rewind(interpreter));
+        EXPECT_EQ(states[frame], saveState(interpreter));
+    }
+    EXPECT_FALSE(rewindBuffer.rewind(interpreter));
+    EXPECT_EQ(states[0], saveState(interpreter));
+}
+
+TEST(RewindBufferTest, Record_AfterRewind_ContinuesFromRestoredFrame) {
+    Interpreter interpreter{};
+    ASSERT_FALSE(interpreter.loadRom(countingProgram.data(), 
+        countingProgram.size()).has_value());
+    RewindBuffer rewindBuffer{1 << 16, 4};
+
+    std::vector<std::vector<uint8_t>> states;
+    for (int frame = 0; frame < 6; frame++) {
+        states.push_back(runFrame(interpreter, rewindBuffer));
+    }
+    for (int step = 0; step < 3; step++) {
+        rewindBuffer.rewind(interpreter);
+    }
+    states.resize(3);
+    interpreter.setKey(0x1, true);
+    for (int frame = 0; frame < 3; frame++) {
+        states.push_back(runFrame(interpreter, rewindBuffer));
+    }
+
+    for (int frame = 4; frame >= 0; frame--) {
+        SCOPED_TRACE(frame);
+        ASSERT_TRUE(rewindBuffer.rewind(interpreter));
+        EXPECT_EQ(states[frame], saveState(interpreter));
+    }
+}
+
+TEST(RewindBufferTest, Record_BufferFull_DropsOldestFrames) {
+    Interpreter interpreter{};
+    ASSERT_FALSE(interpreter.loadRom(countingProgram.data(), 
+        countingProgram.size()).has_value());
+    constexpr size_t CAPACITY = 3 * Interpreter::STATE_SIZE;
+    RewindBuffer rewindBuffer{CAPACITY, 8};
+
+    std::vector<std::vector<uint8_t>> states;
+    for (int frame = 0; frame < 500; frame++) {
+        states.push_back(runFrame(interpreter, rewindBuffer));
+        EXPECT_LE(rewindBuffer.getUsedBytes(), CAPACITY);
+    }
+
+    const size_t frameCount = rewindBuffer.getFrameCount();
+    EXPECT_GT(frameCount, 8u);
+    EXPECT_LT(frameCount, 500u);
+    for (size_t step = 1; step < frameCount; step++) {
+        SCOPED_TRACE(step);
+        ASSERT_TRUE(rewindBuffer.rewind(interpreter));
+        EXPECT_EQ(states[states.size() - 1 - step], saveState(interpreter));
+    }
+    EXPECT_FALSE(rewindBuffer.rewind(interpreter));
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "core/input_movie.hpp"
+#include "core/rom_pack.hpp"
+
+using namespace OCTACHIP;
+
+namespace {
+
+const std::vector<std::vector<uint8_t>> images = {
+    {0x12, 0x00}, 
+    {0x60, 0x01, 0x12, 0x02}, 
+    {0x12, 0x00}
+};
+
+std::vector<PackedRom> makeRoms() {
+    std::vector<PackedRom> roms(3);
+    roms[0].title = "Idle";
+    roms[0].filename = "idle.ch8";
+    roms[0].speed = 600;
+    roms[0].wrapQuirk = true;
+    roms[1].title = "Load";
+    roms[1].filename = "load.ch8";
+    roms[1].speed = 60000;
+    roms[1].loadStoreQuirk = true;
+    roms[1].shiftQuirk = true;
+    roms[2].title = "Idle Again";
+    roms[2].filename = "idle_again.ch8";
+    roms[2].speed = 1200;
+    return roms;
+}
+
+}
+
+TEST(RomPackTest, DecodeRomPack_EncodedPack_RoundTrips) {
+    const std::vector<PackedRom> roms = makeRoms();
+    const std::vector<uint8_t> bytes = encodeRomPack(roms, images);
+
+    RomPack pack{};
+    ASSERT_FALSE(decodeRomPack(bytes.data(), bytes.size(), pack).has_value());
+    ASSERT_EQ(roms.size(), pack.roms.size());
+    for (size_t index = 0; index < roms.size(); index++) {
+        SCOPED_TRACE(index);
+        const PackedRom& rom = pack.roms[index];
+        EXPECT_EQ(roms[index].title, rom.title);
+        EXPECT_EQ(roms[index].filename, rom.filename);
+        EXPECT_EQ(roms[index].speed, rom.speed);
+        EXPECT_EQ(roms[index].loadStoreQuirk, rom.loadStoreQuirk);
+        EXPECT_EQ(roms[index].shiftQuirk, rom.shiftQuirk);
+        EXPECT_EQ(roms[index].wrapQuirk, rom.wrapQuirk);
+        EXPECT_EQ(hashBytes(images[index].data(), images[index].size()), 
+            rom.hash);
+        EXPECT_GE(rom.offset, pack.indexSize);
+        EXPECT_EQ(images[index], std::vector<uint8_t>(bytes.data() + 
+            rom.offset, bytes.data() + rom.offset + rom.size));
+    }
+}
+
+TEST(RomPackTest, EncodeRomPack_SameImage_IsStoredOnce) {
+    const std::vector<uint8_t> bytes = encodeRomPack(makeRoms(), images);
+
+    RomPack pack{};
+    ASSERT_FALSE(decodeRomPack(bytes.data(), bytes.size(), pack).has_value());
+    EXPECT_EQ(pack.roms[0].offset, pack.roms[2].offset);
+    EXPECT_EQ(pack.indexSize + images[0].size() + images[1].size(), 
+        bytes.size());
+    EXPECT_EQ(&pack.roms[1], findPackedRom(pack, pack.roms[1].hash));
+    EXPECT_EQ(nullptr, findPackedRom(pack, 0));
+}
+
+TEST(RomPackTest, DecodeRomPack_InvalidData_ReturnsError) {
+    std::vector<uint8_t> bytes = encodeRomPack(makeRoms(), images);
+
+    RomPack pack{};
+    EXPECT_TRUE(decodeRomPack(bytes.data(), bytes.size() - 1, 
+        pack).has_value());
+    EXPECT_TRUE(decodeRomPack(bytes.data(), RomPack::HEADER_SIZE, 
+        pack).has_value());
+    // Points the first image past the end of the pack
+    bytes[RomPack::HEADER_SIZE + 8] = 0xFF;
+    EXPECT_TRUE(decodeRomPack(bytes.data(), bytes.size(), pack).has_value());
+    bytes[0] = 'X';
+    EXPECT_TRUE(decodeRomPack(bytes.data(), bytes.size(), pack).has_value());
+    EXPECT_TRUE(pack.roms.empty());
+}
\ No newline at end of file
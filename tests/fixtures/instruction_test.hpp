@@ -14,6 +14,7 @@ protected:
     Registers registers{};
     Stack stack{};
     Frame frame{};
+    FrameChanges frameChanges{};
     Keypad keypad{};
     MockRandom random{};
 };
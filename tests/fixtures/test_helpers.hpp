@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/interpreter.hpp"
+
+namespace OCTACHIP {
+
+// Returns the interpreter's state as a buffer of Interpreter::STATE_SIZE bytes
+inline std::vector<uint8_t> saveState(const Interpreter& interpreter) {
+    std::vector<uint8_t> state(Interpreter::STATE_SIZE);
+    interpreter.saveState(state.data(), state.size());
+    return state;
+}
+
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include "fixtures/instruction_test.hpp"
+#include "core/fault.hpp"
 #include "core/instructions.hpp"
 #include "core/opcode.hpp"
 #include "core/types.hpp"
@@ -25,9 +26,9 @@ TEST_F(InstructionTest, RET_NonEmptyStack_ReturnsFromSubroutine) {
     EXPECT_EQ(initialSpValue, registers.sp);
 }
 
-TEST_F(InstructionTest, RET_EmptyStack_ThrowsException) {
-    // RET should throw an exception if the stack is empty
-    EXPECT_THROW(instructions::RET(registers, stack), std::underflow_error);
+TEST_F(InstructionTest, RET_EmptyStack_ReportsStackUnderflow) {
+    // RET should report a fault if the stack is empty
+    EXPECT_EQ(FaultKind::STACK_UNDERFLOW, instructions::RET(registers, stack));
 }
 
 TEST_F(InstructionTest, JP_ADDR_SetsProgramCounterToAddress) {
@@ -59,18 +60,17 @@ TEST_F(InstructionTest, CALL_ADDR_NonFullStack_CallsSubroutineAtAddress) {
     EXPECT_EQ(incrementedSpValue, registers.sp);
 }
 
-TEST_F(InstructionTest, CALL_ADDR_FullStack_ThrowsException) {
+TEST_F(InstructionTest, CALL_ADDR_FullStack_ReportsStackOverflow) {
     const uint16_t address = 0x251;
     const Opcode opcode = 0x2000 | address;
 
-    // CALL_ADDR should throw an exception when the stack limit is exceeded
-    EXPECT_NO_THROW({
-        for (int i = 0; i < STACK_SIZE; i++) {
-            instructions::CALL_ADDR(opcode, registers, stack);
-        }
-    });
-    EXPECT_THROW(instructions::CALL_ADDR(opcode, registers, stack), 
-        std::overflow_error);
+    // CALL_ADDR should report a fault when the stack limit is exceeded
+    for (int i = 0; i < STACK_SIZE; i++) {
+        EXPECT_EQ(FaultKind::NONE, 
+            instructions::CALL_ADDR(opcode, registers, stack));
+    }
+    EXPECT_EQ(FaultKind::STACK_OVERFLOW, 
+        instructions::CALL_ADDR(opcode, registers, stack));
 }
 
 TEST_F(InstructionTest, SE_VX_BYTE_VxEqualToByte_SkipsInstruction) {
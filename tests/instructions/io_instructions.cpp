@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include "fixtures/instruction_test.hpp"
+#include "core/fault.hpp"
 #include "core/instructions.hpp"
 #include "core/opcode.hpp"
 #include "core/types.hpp"
@@ -10,16 +11,28 @@ using namespace OCTACHIP;
 
 TEST_F(InstructionTest, CLS_ClearsFrame) {
     // Turn pixels on
-    frame[0] = true;
-    frame[1] = true;
-    frame[2] = true;
+    setPixel(frame, 0, 0, true);
+    setPixel(frame, 1, 0, true);
+    setPixel(frame, 2, 0, true);
 
-    instructions::CLS(frame);
+    instructions::CLS(frame, frameChanges);
 
     // CLS should turn off all pixels
-    for (int i = 0; i < FRAME_WIDTH * FRAME_HEIGHT; i++) {
-        EXPECT_EQ(false, frame[i]);
+    for (int row = 0; row < FRAME_HEIGHT; row++) {
+        EXPECT_EQ(0u, frame[row]);
     }
+
+    // Only the first row had pixels on, so it is the only row that changed
+    EXPECT_EQ(0b1u, frameChanges.dirtyRows);
+    EXPECT_EQ(1u, frameChanges.generation);
+}
+
+TEST_F(InstructionTest, CLS_BlankFrame_LeavesFrameClean) {
+    instructions::CLS(frame, frameChanges);
+
+    // Clearing a blank frame changes nothing, so no rows should be dirty
+    EXPECT_EQ(0u, frameChanges.dirtyRows);
+    EXPECT_EQ(0u, frameChanges.generation);
 }
 
 TEST_F(InstructionTest, 
@@ -44,19 +57,23 @@ TEST_F(InstructionTest,
     memory[registers.i + 2] = 0b00000000;
     memory[registers.i + 3] = 0b11111111;
 
-    instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame);
+    instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame, 
+        frameChanges);
 
     // DRW_VX_VY_NIBBLE should draw the sprite from memory onto the frame
     for (unsigned int row = 0; row < sprite.size(); row++) {
         for (unsigned int col = 0; col < sprite.front().size(); col++) {
-            int pixelLoc = FRAME_WIDTH * row + col;
-            EXPECT_EQ(sprite[row][col], frame[pixelLoc]);
+            EXPECT_EQ(sprite[row][col], getPixel(frame, col, row));
         }
     }
 
     // Started with a blank screen, so DRW_VX_VY_NIBBLE should clear the 
     // collision flag VF
     EXPECT_EQ(0x00, registers.v[0xF]);
+
+    // The blank third row of the sprite should not mark its frame row as dirty
+    EXPECT_EQ(0b1011u, frameChanges.dirtyRows);
+    EXPECT_EQ(1u, frameChanges.generation);
 }
 
 TEST_F(InstructionTest, 
@@ -82,20 +99,70 @@ TEST_F(InstructionTest,
     memory[registers.i + 3] = 0b11111111;
 
     // Repeating the draw instruction will toggle the sprite on and off
-    instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame);
-    instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame);
+    instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame, 
+        frameChanges);
+    instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame, 
+        frameChanges);
 
     // The second call to DRW_VX_VY_NIBBLE should clear the frame
-    for (int i = 0; i < FRAME_WIDTH * FRAME_HEIGHT; i++) {
-        EXPECT_EQ(false, frame[i]);
+    for (int row = 0; row < FRAME_HEIGHT; row++) {
+        EXPECT_EQ(0u, frame[row]);
     }
     
     // The second draw call overlapped the first sprite, so DRW_VX_VY_NIBBLE 
     // should set the collision flag VF
     EXPECT_EQ(0x01, registers.v[0xF]);
+    EXPECT_EQ(2u, frameChanges.generation);
+}
+
+TEST_F(InstructionTest, 
+    DRW_VX_VY_NIBBLE_WrapQuirkSpritePastCorner_WrapsAroundScreen) {
+    const uint16_t x = 0x0;
+    const uint16_t y = 0x1;
+    const Opcode opcode = 0xD000 | (x << 8) | (y << 4) | 0x2;
+
+    registers.v[x] = FRAME_WIDTH - 4;
+    registers.v[y] = FRAME_HEIGHT - 1;
+    registers.i = 0x200;
+    memory[registers.i] = 0b11111111;
+    memory[registers.i + 1] = 0b10000001;
+
+    instructions::DRW_VX_VY_NIBBLE<true>(opcode, memory, registers, frame, 
+        frameChanges);
+
+    // The half of each sprite row past the right edge should wrap around to 
+    // the left edge, and the row past the bottom edge should wrap to the top
+    EXPECT_EQ(0xF00000000000000Fu, frame[FRAME_HEIGHT - 1]);
+    EXPECT_EQ(0x1000000000000008u, frame[0]);
+    EXPECT_EQ(0x00, registers.v[0xF]);
+    EXPECT_EQ(0x80000001u, frameChanges.dirtyRows);
+}
+
+TEST_F(InstructionTest, 
+    DRW_VX_VY_NIBBLE_SpritePastCorner_ClipsSpriteAndSetsVF) {
+    const uint16_t x = 0x0;
+    const uint16_t y = 0x1;
+    const Opcode opcode = 0xD000 | (x << 8) | (y << 4) | 0x2;
+
+    registers.v[x] = FRAME_WIDTH - 4;
+    registers.v[y] = FRAME_HEIGHT - 1;
+    registers.i = 0x200;
+    memory[registers.i] = 0b11111111;
+    memory[registers.i + 1] = 0b10000001;
+    setPixel(frame, FRAME_WIDTH - 1, FRAME_HEIGHT - 1, true);
+
+    instructions::DRW_VX_VY_NIBBLE<false>(opcode, memory, registers, frame, 
+        frameChanges);
+
+    // Only the part of the sprite inside the screen should be drawn, and 
+    // erasing the pixel in the bottom-right corner should set VF
+    EXPECT_EQ(0x000000000000000Eu, frame[FRAME_HEIGHT - 1]);
+    EXPECT_EQ(0x0000000000000000u, frame[0]);
+    EXPECT_EQ(0x01, registers.v[0xF]);
+    EXPECT_EQ(0x80000000u, frameChanges.dirtyRows);
 }
 
-TEST_F(InstructionTest, DRW_VX_VY_NIBBLE_MemoryOutOfRange_ThrowsException) {
+TEST_F(InstructionTest, DRW_VX_VY_NIBBLE_MemoryOutOfRange_ReportsFault) {
     const uint16_t x = 0x0;
     const uint16_t y = 0xA;
     const uint8_t n = 0xF;
@@ -105,11 +172,10 @@ TEST_F(InstructionTest, DRW_VX_VY_NIBBLE_MemoryOutOfRange_ThrowsException) {
 
     // DRW_VX_VY_NIBBLE should attempt read from memory addresses I to I + n - 1
     // I already points to the last memory address, so DRW_VX_VY_NIBBLE should 
-    // throw an exception
-    EXPECT_THROW(
-        instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame), 
-        std::out_of_range
-    );
+    // report a fault
+    EXPECT_EQ(FaultKind::MEMORY_OUT_OF_BOUNDS, 
+        instructions::DRW_VX_VY_NIBBLE(opcode, memory, registers, frame, 
+            frameChanges));
 }
 
 TEST_F(InstructionTest, SKP_VX_VxPressed_SkipsInstruction) {
@@ -168,6 +234,34 @@ TEST_F(InstructionTest, SKNP_VX_VxNotPressed_SkipsInstruction) {
     EXPECT_EQ(incrementedPcValue, registers.pc);
 }
 
+TEST_F(InstructionTest, SKP_VX_VxAboveF_DoesNotSkipInstruction) {
+    const uint16_t x = 0x0;
+    const Opcode opcode = 0xE09E | (x << 8);
+
+    registers.v[x] = 0x10;
+    keypad.fill(true);
+    const uint16_t initialPcValue = registers.pc;
+
+    instructions::SKP_VX(opcode, registers, keypad);
+
+    // There is no key 0x10, so it should never count as pressed
+    EXPECT_EQ(initialPcValue, registers.pc);
+}
+
+TEST_F(InstructionTest, SKNP_VX_VxAboveF_SkipsInstruction) {
+    const uint16_t x = 0x0;
+    const Opcode opcode = 0xE0A1 | (x << 8);
+
+    registers.v[x] = 0xFF;
+    keypad.fill(true);
+    const uint16_t incrementedPcValue = registers.pc + 2;
+
+    instructions::SKNP_VX(opcode, registers, keypad);
+
+    // There is no key 0xFF, so it should never count as pressed
+    EXPECT_EQ(incrementedPcValue, registers.pc);
+}
+
 TEST_F(InstructionTest, LD_VX_K_NoKeyPressed_DecrementsProgramCounter) {
     const uint16_t x = 0x0;
     const Opcode opcode = 0xF00A | (x << 8);
@@ -177,9 +271,9 @@ TEST_F(InstructionTest, LD_VX_K_NoKeyPressed_DecrementsProgramCounter) {
 
     Keypad prevKeypad{};
 
-    instructions::LD_VX_K(opcode, registers, keypad, prevKeypad);
-
-    // No key press detected, so LD_VX_K should decrement the program counter
+    // No key press detected, so LD_VX_K should keep waiting and decrement the 
+    // program counter
+    EXPECT_TRUE(instructions::LD_VX_K(opcode, registers, keypad, prevKeypad));
     EXPECT_EQ(decrementedPcValue, registers.pc);
 }
 
@@ -194,9 +288,9 @@ TEST_F(InstructionTest, LD_VX_K_KeyPressed_SetVxToPressedKey) {
     prevKeypad[key] = true; // Set key E as pressed before
     keypad[key] = false; // Set key E as previously released
 
-    instructions::LD_VX_K(opcode, registers, keypad, prevKeypad);
-
-    // Key press detected, so LD_VX_K should NOT decrement the program counter
+    // Key press detected, so LD_VX_K should stop waiting and NOT decrement the 
+    // program counter
+    EXPECT_FALSE(instructions::LD_VX_K(opcode, registers, keypad, prevKeypad));
     EXPECT_EQ(initialPcValue, registers.pc);
 
     // LD_VX_K should set Vx to the value of the pressed key
@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include "fixtures/instruction_test.hpp"
+#include "core/fault.hpp"
 #include "core/instructions.hpp"
 #include "core/opcode.hpp"
 #include "core/types.hpp"
@@ -110,17 +111,17 @@ TEST_F(InstructionTest, LD_B_VX_MemoryInRange_WritesVxBcdToMemory) {
     EXPECT_EQ(onesDigit, memory[registers.i + 2]);
 }
 
-TEST_F(InstructionTest, LD_B_VX_MemoryOutOfRange_ThrowsException) {
+TEST_F(InstructionTest, LD_B_VX_MemoryOutOfRange_ReportsFault) {
     const uint16_t x = 0x0;
     const Opcode opcode = 0xF033 | (x << 8);
 
     registers.i = MEMORY_SIZE - 1;
 
     // LD_B_VX should attempt to write to memory addresses I to I + 2
-    // I already points to the last memory address, so LD_B_VX should throw an 
-    // exception
-    EXPECT_THROW(instructions::LD_B_VX(opcode, memory, registers), 
-        std::out_of_range);
+    // I already points to the last memory address, so LD_B_VX should report a 
+    // fault
+    EXPECT_EQ(FaultKind::MEMORY_OUT_OF_BOUNDS, 
+        instructions::LD_B_VX(opcode, memory, registers));
 }
 
 TEST_F(InstructionTest, LD_I_VX_MemoryInRange_WritesRegistersToMemory) {
@@ -144,17 +145,17 @@ TEST_F(InstructionTest, LD_I_VX_MemoryInRange_WritesRegistersToMemory) {
     }
 }
 
-TEST_F(InstructionTest, LD_I_VX_MemoryOutOfRange_ThrowsException) {
+TEST_F(InstructionTest, LD_I_VX_MemoryOutOfRange_ReportsFault) {
     const uint16_t x = 0xF;
     const Opcode opcode = 0xF055 | (x << 8);
 
     registers.i = MEMORY_SIZE - 1;
     
     // LD_I_VX should attempt to write to memory addresses I to I + x
-    // I already points to the last memory address, so LD_I_VX should throw an 
-    // exception
-    EXPECT_THROW(instructions::LD_I_VX(opcode, memory, registers), 
-        std::out_of_range);
+    // I already points to the last memory address, so LD_I_VX should report a 
+    // fault
+    EXPECT_EQ(FaultKind::MEMORY_OUT_OF_BOUNDS, 
+        instructions::LD_I_VX(opcode, memory, registers));
 }
 
 TEST_F(InstructionTest, LD_VX_I_MemoryInRange_ReadsMemoryIntoRegisters) {
@@ -177,15 +178,15 @@ TEST_F(InstructionTest, LD_VX_I_MemoryInRange_ReadsMemoryIntoRegisters) {
     }
 }
 
-TEST_F(InstructionTest, LD_VX_I_MemoryOutOfRange_ThrowsException) {
+TEST_F(InstructionTest, LD_VX_I_MemoryOutOfRange_ReportsFault) {
     const uint16_t x = 0xF;
     const Opcode opcode = 0xF065 | (x << 8);
 
     registers.i = MEMORY_SIZE - 1;
     
     // LD_VX_I should attempt to read from memory addresses I to I + x
-    // I already points to the last memory address, so LD_VX_I should throw an 
-    // exception
-    EXPECT_THROW(instructions::LD_VX_I(opcode, memory, registers), 
-        std::out_of_range);
+    // I already points to the last memory address, so LD_VX_I should report a 
+    // fault
+    EXPECT_EQ(FaultKind::MEMORY_OUT_OF_BOUNDS, 
+        instructions::LD_VX_I(opcode, memory, registers));
 }
\ No newline at end of file
@@ -1,13 +1,14 @@
 #pragma once
 
-#include "core/random.hpp"
+#include <cstdint>
 
 namespace OCTACHIP {
 
-class MockRandom : public Random {
+// Stands in for Random in the instruction handlers, which take the generator 
+// as a template parameter
+class MockRandom {
 public:
-    MockRandom() : Random() {}
-    uint8_t generateNumber() override {
+    uint8_t generateNumber() {
         return 0x37;
     }
 };
@@ -8,19 +8,24 @@ export const createApp = () => {
   const userInterface = createUI();
   const monitor = createMonitor();
 
+  // Optional seed for the random number generator, from the ?seed= parameter
+  const seedParameter = new URLSearchParams(window.location.search).get("seed");
+  const seed = seedParameter === null ? null : Number(seedParameter);
+
   let selectedRom;
   let running = false;
   let paused = false;
+  // Snapshot taken by the Save State button, dropped when the ROM changes
+  let savedState = null;
 
-  const handleRomChange = (roms, romIndex) => {
+  const handleRomChange = async (roms, romIndex) => {
     selectedRom = roms[romIndex];
+    savedState = null;
 
     userInterface.setRomDescription(selectedRom.description);
 
-    emulatorController.loadRom(selectedRom.filename);
-
-    const instructionsArr = emulatorController.getDisassembledInstructions();
-    userInterface.displayInstructions(instructionsArr);
+    await emulatorController.loadRom(selectedRom.filename);
+    monitor.updateAllInfo();
 
     emulatorController.setSpeed(selectedRom.speed);
 
@@ -32,19 +37,20 @@ export const createApp = () => {
     emulatorController.setQuirk("setWrapQuirk", selectedRom.wrapQuirk);
   };
 
-  const handleStartButtonClick = () => {
+  const handleStartButtonClick = async () => {
     if (running) {
       paused = false;
       emulatorController.stopEmulator();
       monitor.cancelMonitoring();
       monitor.updateAllInfo();
     } else {
-      emulatorController.startEmulator(selectedRom);
+      await emulatorController.startEmulator(selectedRom, seed);
       monitor.startMonitoring();
     }
     running = !running;
     userInterface.toggleStartButton(running);
     userInterface.togglePauseButton(paused, running);
+    userInterface.toggleStateButtons(running, savedState !== null);
   };
 
   const handlePauseButtonClick = () => {
@@ -60,6 +66,23 @@ export const createApp = () => {
     userInterface.togglePauseButton(paused, running);
   };
 
+  const handleSaveStateButtonClick = () => {
+    savedState = emulatorController.saveState();
+    userInterface.toggleStateButtons(running, true);
+  };
+
+  const handleLoadStateButtonClick = () => {
+    if (emulatorController.loadState(savedState) && paused) {
+      monitor.updateAllInfo();
+    }
+  };
+
+  const handleRewindButton = (isRewinding) => {
+    if (running) {
+      emulatorController.setRewinding(isRewinding);
+    }
+  };
+
   const init = async () => {
     const roms = await fetchRomsMetadata();
     userInterface.buildRomDropdown(roms);
@@ -75,6 +98,21 @@ export const createApp = () => {
     const pauseButton = document.querySelector("#pause-button");
     pauseButton.addEventListener("click", handlePauseButtonClick);
 
+    const saveStateButton = document.querySelector("#save-state-button");
+    saveStateButton.addEventListener("click", handleSaveStateButtonClick);
+
+    const loadStateButton = document.querySelector("#load-state-button");
+    loadStateButton.addEventListener("click", handleLoadStateButtonClick);
+
+    // Rewinds for as long as the button is held, like the Backspace key
+    const rewindButton = document.querySelector("#rewind-button");
+    ["mousedown", "touchstart"].forEach((event) => {
+      rewindButton.addEventListener(event, () => handleRewindButton(true));
+    });
+    ["mouseup", "mouseleave", "touchend"].forEach((event) => {
+      rewindButton.addEventListener(event, () => handleRewindButton(false));
+    });
+
     const settingsButton = document.querySelector("#settings-button");
     settingsButton.addEventListener("click", () => {
       userInterface.toggleSettingsMenu(true);
@@ -99,8 +137,12 @@ export const createApp = () => {
       userInterface.toggleKeypad(event.target.checked);
     });
 
-    handleRomChange(roms, romSelector.value);
-    monitor.updateAllInfo();
+    const turboToggle = document.querySelector("#turbo-toggle");
+    turboToggle.addEventListener("change", (event) => {
+      emulatorController.setTurbo(event.target.checked);
+    });
+
+    await handleRomChange(roms, romSelector.value);
   };
 
   return {
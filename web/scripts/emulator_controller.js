@@ -1,20 +1,22 @@
+import { createRomPack } from "./rom_pack.js";
+
 export const createEmulatorController = () => {
-  const loadRom = (filename) => {
+  const romPack = createRomPack();
+
+  const loadRom = async (filename) => {
     try {
-      const encoder = new TextEncoder();
-      const romPath = `roms/${filename}\0`;
-      const encodedPath = encoder.encode(romPath);
-      window.Module.ccall("loadRom", null, ["array"], [encodedPath]);
+      const romData = await romPack.fetchRom(filename);
+      window.Module.ccall(
+        "loadRom",
+        null,
+        ["array", "number"],
+        [romData, romData.length],
+      );
     } catch (error) {
       console.error(`Failed to load ROM: ${error.message}`);
     }
   };
 
-  const getDisassembledInstructions = () => {
-    const instructionsText = window.Module.getDisassembledInstructions();
-    return instructionsText.split("\n");
-  };
-
   const setSpeed = (emulationSpeed) => {
     window.Module.ccall("setSpeed", null, ["number"], [emulationSpeed]);
   };
@@ -23,8 +25,45 @@ export const createEmulatorController = () => {
     window.Module.ccall(method, null, ["number"], [isEnabled ? 1 : 0]);
   };
 
-  const startEmulator = (rom) => {
-    loadRom(rom.filename);
+  const setTurbo = (isEnabled) => {
+    window.Module.ccall("setTurbo", null, ["number"], [isEnabled ? 1 : 0]);
+  };
+
+  const seedRandom = (seed) => {
+    window.Module.ccall("seedRandom", null, ["number"], [seed >>> 0]);
+  };
+
+  // Returns a copy of the snapshot, which stays valid after later saves
+  const saveState = () => {
+    const size = window.Module.ccall("getStateSize", "number", [], []);
+    const pointer = window.Module.ccall("saveState", "number", [], []);
+    return window.Module.HEAPU8.slice(pointer, pointer + size);
+  };
+
+  const loadState = (state) => {
+    return window.Module.ccall(
+      "loadState",
+      "boolean",
+      ["array", "number"],
+      [state, state.length],
+    );
+  };
+
+  const setRewinding = (isRewinding) => {
+    window.Module.ccall(
+      "setRewinding",
+      null,
+      ["number"],
+      [isRewinding ? 1 : 0],
+    );
+  };
+
+  // A seed makes the random numbers drawn by the ROM the same on every run
+  const startEmulator = async (rom, seed) => {
+    await loadRom(rom.filename);
+    if (seed !== null) {
+      seedRandom(seed);
+    }
     setSpeed(rom.speed);
     setQuirk("setLoadStoreQuirk", rom.loadStoreQuirk);
     setQuirk("setShiftQuirk", rom.shiftQuirk);
@@ -47,9 +86,13 @@ export const createEmulatorController = () => {
 
   return {
     loadRom,
-    getDisassembledInstructions,
     setSpeed,
     setQuirk,
+    setTurbo,
+    seedRandom,
+    saveState,
+    loadState,
+    setRewinding,
     startEmulator,
     stopEmulator,
     pauseEmulator,
@@ -5,6 +5,10 @@ export const createMonitor = () => {
   const STACK_SIZE = 16;
   const PC_INDEX = 0;
   const SP_INDEX = 2;
+  const PROG_START_ADDRESS = 0x200;
+  const MEMORY_SIZE = 0x1000;
+  const INSTRUCTION_ROW_COUNT = 16;
+  const ROWS_BEFORE_PC = 3;
 
   const createDataEntry = (selector, formatLength, getter, arg = null) => {
     return {
@@ -72,25 +76,33 @@ export const createMonitor = () => {
     stackTop.classList.add("stack-top");
   };
 
+  // Only the rows around the program counter are disassembled, one per
+  // address, with the current instruction a few rows from the top
   const instructionsContainer = document.querySelector(
     "#instructions-container",
   );
+  let instructionRows = [];
+  for (let i = 0; i < INSTRUCTION_ROW_COUNT; i++) {
+    const row = document.createElement("div");
+    instructionsContainer.appendChild(row);
+    instructionRows.push(row);
+  }
 
-  const updateCurrentInstruction = () => {
-    const oldInstruction = document.querySelector(".current-instruction");
-    if (oldInstruction) {
-      oldInstruction.classList.remove("current-instruction");
-    }
-
+  const updateInstructions = () => {
     const pcValue = specialRegisters[PC_INDEX].value;
-    const newInstruction = document.querySelector(`#instruction-${pcValue}`);
-    if (newInstruction) {
-      newInstruction.classList.add("current-instruction");
-      instructionsContainer.scrollTo(
-        0,
-        newInstruction.offsetTop - newInstruction.parentElement.offsetTop - 60,
-      );
-    }
+    const start = Math.min(
+      Math.max(pcValue - ROWS_BEFORE_PC, PROG_START_ADDRESS),
+      MEMORY_SIZE - INSTRUCTION_ROW_COUNT,
+    );
+    const text = window.Module.disassemble(start, INSTRUCTION_ROW_COUNT);
+    const lines = text.split("\n");
+
+    instructionRows.forEach((row, index) => {
+      if (row.textContent !== lines[index]) {
+        row.textContent = lines[index];
+      }
+      row.classList.toggle("current-instruction", start + index === pcValue);
+    });
   };
 
   const updateAllInfo = () => {
@@ -98,7 +110,7 @@ export const createMonitor = () => {
     updateData(vRegisters);
     updateData(stack);
     updateStackPointer();
-    updateCurrentInstruction();
+    updateInstructions();
   };
 
   let requestID;
@@ -0,0 +1,101 @@
+// Reads ROM images out of roms.pack with HTTP range requests, so only the
+// index and the ROMs that are actually played are downloaded
+export const createRomPack = () => {
+  const MAGIC = "OC8P";
+  const HEADER_SIZE = 12;
+  // Enough for the index of a few hundred ROMs in a single request
+  const INITIAL_FETCH_SIZE = 16384;
+  // Hash, offset, size, speed and quirks of each entry
+  const ENTRY_FIELDS_SIZE = 21;
+
+  // The whole pack, if the server ignored a range request and sent all of it
+  let wholePack = null;
+  let indexPromise = null;
+  const images = new Map();
+
+  const readRange = async (start, end) => {
+    if (wholePack === null) {
+      const response = await fetch("roms.pack", {
+        headers: { Range: `bytes=${start}-${end - 1}` },
+      });
+
+      if (!response.ok) {
+        throw new Error(`HTTP status ${response.status}`);
+      }
+
+      const bytes = new Uint8Array(await response.arrayBuffer());
+      if (response.status === 206) {
+        return bytes;
+      }
+      wholePack = bytes;
+    }
+    return wholePack.subarray(start, end);
+  };
+
+  const parseIndex = (bytes) => {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.length);
+    const decoder = new TextDecoder();
+    let position = HEADER_SIZE;
+
+    const readString = () => {
+      const length = view.getUint16(position, true);
+      const start = position + 2;
+      position = start + length;
+      return decoder.decode(bytes.subarray(start, position));
+    };
+
+    // Titles and settings are also listed in roms.json, so only the position
+    // of each image is kept, by filename
+    const entries = new Map();
+    const romCount = view.getUint16(6, true);
+    for (let i = 0; i < romCount; i++) {
+      const hash = view.getBigUint64(position, true);
+      const offset = view.getUint32(position + 8, true);
+      const size = view.getUint32(position + 12, true);
+      position += ENTRY_FIELDS_SIZE;
+      readString();
+      entries.set(readString(), { hash, offset, size });
+    }
+    return entries;
+  };
+
+  const loadIndex = async () => {
+    let bytes = await readRange(0, INITIAL_FETCH_SIZE);
+    const magic = new TextDecoder().decode(bytes.subarray(0, MAGIC.length));
+    if (bytes.length < HEADER_SIZE || magic !== MAGIC) {
+      throw new Error("roms.pack is not a ROM pack");
+    }
+
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.length);
+    const indexSize = view.getUint32(8, true);
+    if (bytes.length < indexSize) {
+      bytes = await readRange(0, indexSize);
+    }
+    return parseIndex(bytes);
+  };
+
+  // Returns the image of a ROM, which is cached by the hash of its contents
+  const fetchRom = async (filename) => {
+    if (indexPromise === null) {
+      indexPromise = loadIndex().catch((error) => {
+        indexPromise = null;
+        throw error;
+      });
+    }
+
+    const entry = (await indexPromise).get(filename);
+    if (entry === undefined) {
+      throw new Error(`${filename} is not in roms.pack`);
+    }
+
+    if (!images.has(entry.hash)) {
+      const image = await readRange(entry.offset, entry.offset + entry.size);
+      images.set(entry.hash, image);
+    }
+    return images.get(entry.hash);
+  };
+
+  return {
+    fetchRom,
+  };
+};
@@ -30,22 +30,6 @@ export const createUI = () => {
     });
   };
 
-  const displayInstructions = (instructionsArr) => {
-    let fragment = new DocumentFragment();
-    instructionsArr.forEach((instructionText, index) => {
-      let div = document.createElement("div");
-      div.textContent = instructionText;
-      div.id = `instruction-${0x200 + index}`;
-      fragment.appendChild(div);
-    });
-
-    const instructionsContainer = document.querySelector(
-      "#instructions-container",
-    );
-    instructionsContainer.textContent = "";
-    instructionsContainer.appendChild(fragment);
-  };
-
   const toggleStartButton = (isRunning) => {
     const startButton = document.querySelector("#start-button");
     if (isRunning) {
@@ -65,6 +49,14 @@ export const createUI = () => {
     pauseButton.disabled = !isRunning;
   };
 
+  // Snapshots and rewinding need a running ROM, and loading needs a snapshot
+  const toggleStateButtons = (isRunning, hasSavedState) => {
+    document.querySelector("#save-state-button").disabled = !isRunning;
+    document.querySelector("#load-state-button").disabled =
+      !isRunning || !hasSavedState;
+    document.querySelector("#rewind-button").disabled = !isRunning;
+  };
+
   const toggleKeypad = (isEnabled) => {
     if (isEnabled) {
       keypad.addKeypad();
@@ -97,9 +89,9 @@ export const createUI = () => {
   return {
     buildRomDropdown,
     setRomDescription,
-    displayInstructions,
     toggleStartButton,
     togglePauseButton,
+    toggleStateButtons,
     toggleKeypad,
     toggleSettingsMenu,
   };